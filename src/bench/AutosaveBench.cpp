@@ -0,0 +1,189 @@
+#include "Bench.h"
+#include "../core/GameSession.h"
+#include "../database/AutosaveWriter.h"
+#include "../tools/common/ToolContent.h"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+int normalDoor(const GameState& state)
+{
+    const QVector<DoorData>& doors = state.getCurrentDoors();
+    for (int i = 0; i < doors.size(); ++i) {
+        if (doors[i].type == DoorType::NORMAL) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// The states after each of `moves` moves, over as many games as it takes
+QVector<GameState> playMoves(int moves)
+{
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    GameSession session;
+    session.setSeed(42);
+    session.start(content);
+
+    QVector<GameState> states;
+    states.reserve(moves);
+    GameState state = session.getCurrentState();
+    while (states.size() < moves) {
+        if (state.isGameOver()) {
+            session.setSeed(session.getSeed() + 1);
+            session.start(content);
+            state = session.getCurrentState();
+        }
+        state.setActiveRiddleId(NoContent);
+        state = session.processMove(state, normalDoor(state));
+        states.append(state);
+    }
+    return states;
+}
+
+struct LegacyCost {
+    quint64 payloadBytes = 0;
+    quint64 walFrames = 0;
+    quint64 pageSize = 0;
+};
+
+// What a JSON save per move costs: a new row with the whole inventory and log
+// as JSON, one transaction each. Auto-checkpoints are off so the WAL
+// keeps every frame for counting
+bool legacySaves(const QString& dbPath, const QVector<GameState>& states, LegacyCost& cost)
+{
+    bool ok = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "autosave_legacy");
+        db.setDatabaseName(dbPath);
+        QSqlQuery query(db);
+        ok = db.open()
+            && query.exec("PRAGMA journal_mode = WAL")
+            && query.exec("PRAGMA synchronous = NORMAL")
+            && query.exec("PRAGMA wal_autocheckpoint = 0")
+            && query.exec("CREATE TABLE game_saves (id INTEGER PRIMARY KEY AUTOINCREMENT, player_name TEXT, "
+                          "gold_bars INTEGER, current_location INTEGER, inventory TEXT, logs TEXT, "
+                          "saved_at TEXT DEFAULT CURRENT_TIMESTAMP)")
+            && query.prepare("INSERT INTO game_saves (player_name, gold_bars, current_location, inventory, logs) "
+                             "VALUES (?, ?, ?, ?, ?)");
+
+        for (int i = 0; ok && i < states.size(); ++i) {
+            const GameState& state = states[i];
+            QJsonArray inventory;
+            for (ItemType item : state.getInventory()) {
+                inventory.append(static_cast<int>(item));
+            }
+            const QByteArray inventoryJson = QJsonDocument(inventory).toJson(QJsonDocument::Compact);
+            const QByteArray logsJson = QJsonDocument(QJsonArray::fromStringList(state.getLog().lines()))
+                                            .toJson(QJsonDocument::Compact);
+            cost.payloadBytes += static_cast<quint64>(inventoryJson.size() + logsJson.size());
+
+            query.bindValue(0, QStringLiteral("bench"));
+            query.bindValue(1, state.getGoldBars());
+            query.bindValue(2, state.getCurrentLocationIndex());
+            query.bindValue(3, QString::fromUtf8(inventoryJson));
+            query.bindValue(4, QString::fromUtf8(logsJson));
+            ok = query.exec();
+        }
+
+        QSqlQuery stats(db);
+        if (ok && stats.exec("PRAGMA wal_checkpoint(PASSIVE)") && stats.next()) {
+            cost.walFrames = stats.value(1).toULongLong();
+        }
+        if (ok && stats.exec("PRAGMA page_size") && stats.next()) {
+            cost.pageSize = stats.value(0).toULongLong();
+        }
+    }
+    QSqlDatabase::removeDatabase("autosave_legacy");
+    return ok;
+}
+
+QString perThousand(double value, quint64 moves, int precision = 1)
+{
+    return QString::number(value * 1000.0 / qMax<quint64>(1, moves), 'f', precision);
+}
+
+// Autosave on every move through the group-committing writer, against a JSON
+// save per move; reports the cost per 1000 moves
+int runAutosave(const QStringList& args)
+{
+    const int moves = qMax(1, args.value(0, "10000").toInt());
+    const bool legacy = args.value(1) == "legacy";
+    QTextStream out(stdout);
+
+    const QVector<GameState> states = playMoves(moves);
+    QTemporaryDir dir;
+
+    QElapsedTimer timer;
+    AutosaveStats stats;
+    qint64 recordNs = 0;
+    bool ok = true;
+    const QString dbPath = dir.filePath("autosave.db");
+    {
+        AutosaveWriter writer(dbPath);
+        for (const GameState& state : states) {
+            timer.start();
+            writer.record("bench", 42, state);
+            recordNs += timer.nsecsElapsed();
+        }
+        ok = writer.flush();
+        stats = writer.stats();
+    }
+
+    // Read the slot back: the last snapshot and its deltas must rebuild the last state
+    bool restored = false;
+    {
+        DatabaseConnection connection;
+        AutosavePoint point;
+        PackedGameState last;
+        restored = connection.connectSQLite(dbPath)
+            && AutosaveWriter::load(connection, "bench", point)
+            && PackedGameState::pack(states.last(), last)
+            && point.seed == 42
+            && point.move == static_cast<quint32>(moves - 1)
+            && point.state == last
+            && point.log == states.last().getLog().lines();
+        connection.disconnect();
+    }
+
+    const double walBytes = static_cast<double>(stats.walFrames) * (stats.pageSize + 24);
+    out << "moves:        " << moves << ", " << stats.snapshots << " snapshots" << Qt::endl;
+    out << "record():     " << QString::number(recordNs / 1e3 / moves, 'f', 2) << " us per move" << Qt::endl;
+    out << "autosave:     per 1000 moves " << perThousand(stats.commits, stats.moves) << " commits, "
+        << perThousand(stats.checkpointSyncs, stats.moves) << " checkpoint fsyncs, "
+        << perThousand(stats.payloadBytes / 1024.0, stats.moves) << " KB payload, "
+        << perThousand(walBytes / 1024.0, stats.moves) << " KB WAL ("
+        << QString::number(walBytes / qMax<quint64>(1, stats.payloadBytes), 'f', 1) << "x), "
+        << stats.compactedRows << " rows compacted" << Qt::endl;
+
+    if (legacy) {
+        LegacyCost cost;
+        timer.restart();
+        const bool legacyOk = legacySaves(dir.filePath("legacy.db"), states, cost);
+        const qint64 legacyNs = timer.nsecsElapsed();
+        const double legacyWal = static_cast<double>(cost.walFrames) * (cost.pageSize + 24);
+        out << "legacy:       per 1000 moves 1000 commits, "
+            << perThousand(cost.payloadBytes / 1024.0, moves) << " KB payload, "
+            << perThousand(legacyWal / 1024.0, moves) << " KB WAL ("
+            << QString::number(legacyWal / qMax<quint64>(1, cost.payloadBytes), 'f', 1) << "x), "
+            << QString::number(legacyNs / 1e3 / moves, 'f', 1) << " us per move on the caller"
+            << (legacyOk ? "" : " (FAILED)") << Qt::endl;
+    }
+
+    if (!ok || stats.moves != static_cast<quint64>(moves) || !restored) {
+        out << "FAILED: " << stats.moves << " of " << moves << " moves committed"
+            << (restored ? "" : ", loaded slot differs from the last state") << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("autosave", "Autosave every move: commits, fsyncs and WAL bytes per 1000 moves (args: moves [legacy])", &runAutosave);
+
+}
@@ -0,0 +1,167 @@
+#include "Bench.h"
+#include "../core/BatchEngine.h"
+#include "../core/GameSession.h"
+#include "../tools/common/ToolContent.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <vector>
+
+namespace {
+
+// The loading flag is transient UI state; GameSession leaves it set after a win
+bool sameRules(const PackedGameState& a, const PackedGameState& b)
+{
+    const quint32 loading = 1u << 26;
+    PackedGameState x = a;
+    PackedGameState y = b;
+    x.bits &= ~loading;
+    y.bits &= ~loading;
+    return x == y;
+}
+
+// Plays the same games through GameSession and the batch kernels and
+// compares the packed states after every action
+int checkEquivalence(const ContentCatalogPtr& content, const BatchRules& rules, int games, QTextStream& out)
+{
+    GameSession session;
+    int mismatches = 0;
+    qint64 actions = 0;
+
+    for (int game = 0; game < games; ++game) {
+        const quint64 seed = RandomGenerator::deriveSeed(1, game);
+        session.setSeed(seed);
+        session.start(content);
+
+        BatchLane lane;
+        BatchEngine::startLane(lane, seed, rules);
+        RandomGenerator player(seed ^ 0x5EED);
+
+        for (int move = 0; move < 1000 && !session.getCurrentState().isGameOver(); ++move) {
+            if (session.hasActiveRiddle()) {
+                const bool correct = player.next32() & 1;
+                session.resolveRiddle(correct);
+                BatchEngine::resolveLane(lane, correct);
+            } else {
+                const int door = player.random(0, MAX_DOORS);  // Includes invalid indices
+                session.chooseDoor(door);
+                BatchEngine::stepLane(lane, door, rules);
+            }
+            actions++;
+
+            PackedGameState expected;
+            PackedGameState::pack(session.getCurrentState(), expected);
+            if (!sameRules(expected, BatchEngine::packLane(lane, content->riddles(), session.getRiddleDeck()))) {
+                if (mismatches < 5) {
+                    out << "mismatch: game " << game << " action " << move << Qt::endl;
+                }
+                mismatches++;
+                break;
+            }
+        }
+    }
+
+    out << "equivalence:  " << games << " games, " << actions << " actions, "
+        << mismatches << " mismatches" << Qt::endl;
+    return mismatches;
+}
+
+// The lane loops GCC reported as vectorized when it compiled BatchEngine.cpp
+QStringList vectorizedLoops()
+{
+    QStringList loops;
+#ifdef LABYRINTH_VECTORIZE_REPORT
+    QFile report(QStringLiteral(LABYRINTH_VECTORIZE_REPORT));
+    if (report.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!report.atEnd()) {
+            const QString line = QString::fromUtf8(report.readLine()).trimmed();
+            const int file = line.lastIndexOf(QLatin1String("BatchEngine.cpp:"));
+            if (file >= 0 && line.contains(QLatin1String("loop vectorized"))) {
+                loops << line.mid(file);
+            }
+        }
+    }
+#endif
+    loops.removeDuplicates();
+    return loops;
+}
+
+int runBatchStep(const QStringList& args)
+{
+    const int lanes = qMax(1, args.value(0, "65536").toInt());
+    const int steps = qMax(1, args.value(1, "200").toInt());
+    const int checkGames = args.value(2, "2000").toInt();
+
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    const BatchRules rules = BatchRules::compile(GameRules(), content->locations().size(),
+                                                 content->riddles().size(), content->notes().size());
+    QTextStream out(stdout);
+
+    const int mismatches = checkEquivalence(content, rules, checkGames, out);
+
+    BatchEngine engine(lanes, rules);
+    engine.resetAll(42);
+
+    // The same games as single lanes, stepped one at a time for the baseline
+    std::vector<BatchLane> single(lanes);
+    for (int i = 0; i < lanes; ++i) {
+        single[i] = engine.lane(i);
+    }
+
+    // Choices are generated up front so only the kernels are timed
+    RandomGenerator player(7);
+    std::vector<quint8> doors(static_cast<size_t>(lanes) * steps);
+    std::vector<quint8> answers(static_cast<size_t>(lanes) * steps);
+    for (size_t i = 0; i < doors.size(); ++i) {
+        doors[i] = static_cast<quint8>(player.bounded(MAX_DOORS));
+        answers[i] = static_cast<quint8>(player.next32() & 1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int s = 0; s < steps; ++s) {
+        engine.resolveRiddles(answers.data() + static_cast<size_t>(s) * lanes);
+        engine.step(doors.data() + static_cast<size_t>(s) * lanes);
+    }
+    const qint64 columnNs = timer.nsecsElapsed();
+
+    timer.restart();
+    for (int s = 0; s < steps; ++s) {
+        const size_t offset = static_cast<size_t>(s) * lanes;
+        for (int i = 0; i < lanes; ++i) {
+            BatchEngine::resolveLane(single[i], answers[offset + i] != 0);
+            BatchEngine::stepLane(single[i], doors[offset + i], rules);
+        }
+    }
+    const qint64 laneNs = timer.nsecsElapsed();
+
+    int finished = 0;
+    int diverged = 0;
+    for (int i = 0; i < lanes; ++i) {
+        const BatchLane lane = engine.lane(i);
+        finished += lane.isGameOver();
+        diverged += lane.rng.state() != single[i].rng.state() || lane.moves != single[i].moves
+                    || lane.inventory != single[i].inventory || lane.doors != single[i].doors
+                    || lane.flags != single[i].flags || lane.keysFound != single[i].keysFound;
+    }
+
+    const double laneSteps = static_cast<double>(lanes) * steps;
+    const auto rate = [laneSteps](qint64 ns) { return QString::number(laneSteps / (ns / 1e9) / 1e6, 'f', 1); };
+    out << "lanes:        " << lanes << " x " << steps << " steps" << Qt::endl;
+    out << "columns:      " << rate(columnNs) << " M lane-steps/s (step)" << Qt::endl;
+    out << "single lane:  " << rate(laneNs) << " M lane-steps/s (stepLane)" << Qt::endl;
+    out << "finished:     " << finished << " games, " << diverged << " lanes differ from stepLane" << Qt::endl;
+
+    const QStringList loops = vectorizedLoops();
+    if (loops.isEmpty()) {
+        out << "vectorized:   no lane loop (GCC optimized builds report them)" << Qt::endl;
+    }
+    for (const QString& loop : loops) {
+        out << "vectorized:   " << loop << Qt::endl;
+    }
+    return mismatches == 0 && diverged == 0 ? 0 : 1;
+}
+
+BenchRegistrar registrar("batch_step", "BatchEngine throughput and GameSession equivalence (args: lanes steps games)", &runBatchStep);
+
+}
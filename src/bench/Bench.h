@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * @brief BenchCase - One named benchmark of labyrinth_bench
+ */
+struct BenchCase {
+    QString name;
+    QString description;
+    int (*run)(const QStringList& args);
+};
+
+/**
+ * @brief BenchRegistry - Benchmarks register themselves at static init time
+ */
+class BenchRegistry {
+public:
+    BenchRegistry() = delete;
+
+    static void add(const BenchCase& bench);
+    static const QVector<BenchCase>& all();
+};
+
+/**
+ * @brief BenchRegistrar - Helper object whose constructor registers a case
+ */
+struct BenchRegistrar {
+    BenchRegistrar(const char* name, const char* description, int (*run)(const QStringList&))
+    {
+        BenchRegistry::add({name, description, run});
+    }
+};
@@ -0,0 +1,54 @@
+#include <QCoreApplication>
+#include <QTextStream>
+#include "Bench.h"
+
+namespace {
+
+QVector<BenchCase>& registry()
+{
+    static QVector<BenchCase> benches;
+    return benches;
+}
+
+}
+
+void BenchRegistry::add(const BenchCase& bench)
+{
+    registry().append(bench);
+}
+
+const QVector<BenchCase>& BenchRegistry::all()
+{
+    return registry();
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    QStringList args = app.arguments().mid(1);
+    if (args.isEmpty() || args.first() == "--help") {
+        out << "Usage: labyrinth_bench <name|all> [options]" << Qt::endl << Qt::endl;
+        for (const BenchCase& bench : BenchRegistry::all()) {
+            out << "  " << bench.name.leftJustified(20) << bench.description << Qt::endl;
+        }
+        return args.isEmpty() ? 1 : 0;
+    }
+
+    const QString name = args.takeFirst();
+    int result = 0;
+    bool found = false;
+    for (const BenchCase& bench : BenchRegistry::all()) {
+        if (name == "all" || bench.name == name) {
+            found = true;
+            out << "=== " << bench.name << " ===" << Qt::endl;
+            result |= bench.run(args);
+        }
+    }
+
+    if (!found) {
+        QTextStream(stderr) << "Unknown benchmark: " << name << Qt::endl;
+        return 1;
+    }
+    return result;
+}
@@ -0,0 +1,83 @@
+#include "Bench.h"
+#include "../core/GameState.h"
+#include "../database/DatabaseManager.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char Schema[] =
+    "CREATE TABLE locations (id INTEGER PRIMARY KEY, name TEXT, theme TEXT, description TEXT);\n"
+    "INSERT INTO locations (id, name, theme, description) VALUES (1, 'Зал', 'тьма', 'Сырые стены');\n"
+    "CREATE TABLE game_saves (id INTEGER PRIMARY KEY AUTOINCREMENT, player_name TEXT NOT NULL, "
+    "gold_bars INTEGER, current_location INTEGER, inventory TEXT, logs TEXT, "
+    "saved_at TEXT DEFAULT CURRENT_TIMESTAMP);\n"
+    "CREATE INDEX game_saves_player ON game_saves (player_name, saved_at);\n";
+
+// Worker threads saving and reloading their own players through one DatabaseManager
+int runDatabasePool(const QStringList& args)
+{
+    const int threads = qMax(1, args.value(0, "4").toInt());
+    const int saves = qMax(1, args.value(1, "2000").toInt());
+    QTextStream out(stdout);
+    // DatabaseManager logs every save and load
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    QTemporaryDir dir;
+    QFile sql(dir.filePath("saves.sql"));
+    if (!dir.isValid() || !sql.open(QIODevice::WriteOnly) || sql.write(Schema) < 0) {
+        out << "Cannot write " << sql.fileName() << Qt::endl;
+        return 1;
+    }
+    sql.close();
+
+    DatabaseManager database;
+    if (!database.connect(dir.filePath("saves.db"), sql.fileName())) {
+        out << "Connect failed: " << database.getLastError() << Qt::endl;
+        return 1;
+    }
+
+    std::atomic<int> failures{0};
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            const QString player = QString("player_%1").arg(t);
+            GameState state;
+            GameState loaded;
+            for (int i = 0; i < saves; ++i) {
+                state.setGoldBars(i).setCurrentLocationIndex(i % 5);
+                if (!database.saveGameState(player, state)
+                    || !database.loadGameState(player, loaded)
+                    || loaded.getGoldBars() != i) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    const qint64 operations = static_cast<qint64>(threads) * saves;
+    out << "threads:      " << threads << ", " << saves << " save+load each" << Qt::endl;
+    out << "elapsed:      " << QString::number(elapsedNs / 1e6, 'f', 1) << " ms, "
+        << QString::number(operations / qMax(1e-9, elapsedNs / 1e9), 'f', 0) << " save+load/s" << Qt::endl;
+    if (failures > 0) {
+        out << "FAILED: " << failures << " operations" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("db_pool", "Parallel saves and loads over the per-thread connection pool (args: threads saves)", &runDatabasePool);
+
+}
@@ -0,0 +1,83 @@
+#include "Bench.h"
+#include "../core/DoorSolver.h"
+#include "../core/GameSession.h"
+#include "../tools/common/ToolContent.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <cmath>
+
+namespace {
+
+// Solves the synthetic content, then plays GameSession games with the advised
+// doors: the mean gold must match the solver's expected value
+int runDoorSolver(const QStringList& args)
+{
+    const int games = qMax(1, args.value(0, "20000").toInt());
+    const int threads = args.value(1, "0").toInt();
+
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    const BatchRules rules = BatchRules::compile(GameRules(), content->locations().size(),
+                                                 content->riddles().size(), content->notes().size());
+    QTextStream out(stdout);
+
+    SolverOptions options;
+    options.threads = threads;
+    DoorSolver solver(rules, options);
+
+    QElapsedTimer timer;
+    timer.start();
+    if (!solver.solve()) {
+        out << "content too large to solve" << Qt::endl;
+        return 1;
+    }
+    const qint64 solveNs = timer.nsecsElapsed();
+
+    GameSession session;
+    double total = 0.0;
+    double totalSquared = 0.0;
+    qint64 queries = 0;
+    qint64 queryNs = 0;
+    int unknown = 0;
+
+    for (int game = 0; game < games; ++game) {
+        session.setSeed(RandomGenerator::deriveSeed(3, game));
+        session.start(content);
+
+        while (!session.getCurrentState().isGameOver()) {
+            if (session.hasActiveRiddle()) {
+                session.resolveRiddle(true);
+                continue;
+            }
+
+            timer.restart();
+            const DoorAdvice advice = solver.advise(session);
+            queryNs += timer.nsecsElapsed();
+            queries++;
+
+            if (advice.door < 0) {
+                unknown++;
+                break;
+            }
+            session.chooseDoor(advice.door);
+        }
+
+        const double gold = session.getCurrentState().getGoldBars();
+        total += gold;
+        totalSquared += gold * gold;
+    }
+
+    const double mean = total / games;
+    const double error = std::sqrt(qMax(0.0, totalSquared / games - mean * mean) / games);
+
+    out << "states:       " << solver.stateCount() << " over " << solver.positionCount() << " positions" << Qt::endl;
+    out << "solve:        " << QString::number(solveNs / 1e6, 'f', 1) << " ms" << Qt::endl;
+    out << "query:        " << QString::number(static_cast<double>(queryNs) / qMax<qint64>(1, queries), 'f', 0) << " ns" << Qt::endl;
+    out << "expected:     " << QString::number(solver.start().expectedGold, 'f', 4) << " gold" << Qt::endl;
+    out << "played:       " << QString::number(mean, 'f', 4) << " +- " << QString::number(error, 'f', 4)
+        << " gold over " << games << " games" << Qt::endl;
+    return unknown == 0 ? 0 : 1;
+}
+
+BenchRegistrar registrar("door_solver", "Expectimax solve time, query latency and played gold (args: games threads)", &runDoorSolver);
+
+}
@@ -0,0 +1,127 @@
+#include "Bench.h"
+#include "../core/GameSession.h"
+#include "../tools/common/ToolContent.h"
+#include "../utils/JsonUtils.h"
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <functional>
+
+namespace {
+
+constexpr int Rounds = 3;
+
+// Every log line of consecutive games until the lines take `bytes` of UTF-8,
+// like the lines a LogArchive holds after a long session
+QVector<QString> sessionLog(qint64 bytes)
+{
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    GameSession session;
+    session.setSeed(23);
+    session.start(content);
+
+    QVector<QString> lines;
+    qint64 size = 0;
+    quint64 seen = 0;
+    for (int move = 0; size < bytes; ++move) {
+        if (session.getCurrentState().isGameOver()) {
+            session.setSeed(23 + move);
+            session.start(content);
+            seen = 0;
+        }
+        if (session.hasActiveRiddle()) {
+            session.resolveRiddle(move % 2 == 0);
+        } else {
+            session.chooseDoor(move % session.getCurrentState().getCurrentDoors().size());
+        }
+
+        const GameLog& log = session.getCurrentState().getLog();
+        const int added = static_cast<int>(qMin<quint64>(log.totalCount() - seen, log.size()));
+        for (int i = log.size() - added; i < log.size(); ++i) {
+            for (const QString& line : GameLog::format(log.at(i))) {
+                lines.append(line);
+                size += line.toUtf8().size();
+            }
+        }
+        seen = log.totalCount();
+    }
+    return lines;
+}
+
+// Best of Rounds, in ns
+qint64 best(const std::function<void()>& run)
+{
+    qint64 fastest = 0;
+    QElapsedTimer timer;
+    for (int round = 0; round < Rounds; ++round) {
+        timer.start();
+        run();
+        const qint64 elapsed = timer.nsecsElapsed();
+        fastest = round == 0 ? elapsed : qMin(fastest, elapsed);
+    }
+    return fastest;
+}
+
+QString throughput(qint64 bytes, qint64 ns)
+{
+    return QString::number(bytes / 1048576.0 / qMax(1e-9, ns / 1e9), 'f', 1) + " MB/s";
+}
+
+// A session log archive as a JSON array: QJsonDocument against JsonWriter and
+// JsonReader, both on UTF-8
+int runJsonStream(const QStringList& args)
+{
+    const qint64 megabytes = qMax(1, args.value(0, "16").toInt());
+    QTextStream out(stdout);
+
+    const QVector<QString> lines = sessionLog(megabytes * 1048576);
+
+    QByteArray domJson;
+    const qint64 domEncodeNs = best([&]() {
+        QJsonArray array;
+        for (const QString& line : lines) {
+            array.append(line);
+        }
+        domJson = QJsonDocument(array).toJson(QJsonDocument::Compact);
+    });
+
+    QByteArray streamJson;
+    const qint64 streamEncodeNs = best([&]() {
+        streamJson = JsonUtils::logsToJsonUtf8(lines);
+    });
+
+    QVector<QString> domLines;
+    const qint64 domDecodeNs = best([&]() {
+        domLines.clear();
+        const QJsonArray array = QJsonDocument::fromJson(streamJson).array();
+        domLines.reserve(array.size());
+        for (const QJsonValue& value : array) {
+            domLines.append(value.toString());
+        }
+    });
+
+    QVector<QString> streamLines;
+    bool parsed = false;
+    const qint64 streamDecodeNs = best([&]() {
+        parsed = JsonUtils::logsFromJsonUtf8(streamJson, streamLines);
+    });
+
+    const qint64 bytes = streamJson.size();
+    out << "archive:      " << lines.size() << " lines, " << QString::number(bytes / 1048576.0, 'f', 1)
+        << " MB of JSON" << (streamJson == domJson ? "" : " (differs from QJsonDocument output)") << Qt::endl;
+    out << "encode:       QJsonDocument " << throughput(bytes, domEncodeNs)
+        << ", JsonWriter " << throughput(bytes, streamEncodeNs) << Qt::endl;
+    out << "decode:       QJsonDocument " << throughput(bytes, domDecodeNs)
+        << ", JsonReader " << throughput(bytes, streamDecodeNs) << Qt::endl;
+
+    if (!parsed || streamLines != lines || domLines != lines) {
+        out << "FAILED: decoded lines differ from the archive" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("json_stream", "Log archive JSON throughput, QJsonDocument vs streaming (args: megabytes)", &runJsonStream);
+
+}
@@ -0,0 +1,83 @@
+#include "Bench.h"
+#include "../core/MctsPlayer.h"
+#include "../tools/common/ToolContent.h"
+#include "../utils/WorkStealingPool.h"
+#include <QTextStream>
+#include <thread>
+
+namespace {
+
+// Plays whole games with the bot and with the greedy rollout policy on the
+// same seeds; reports rollout throughput and the gold both reach
+int runMcts(const QStringList& args)
+{
+    const int games = qMax(1, args.value(0, "4").toInt());
+    const int rollouts = qMax(1, args.value(1, "5000").toInt());
+    int threads = args.value(2, "0").toInt();
+    if (threads <= 0) {
+        threads = qMax(1u, std::thread::hardware_concurrency());
+    }
+
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    const BatchRules rules = BatchRules::compile(GameRules(), content->locations().size(),
+                                                 content->riddles().size(), content->notes().size());
+    QTextStream out(stdout);
+
+    // The searching thread rolls out too, so the pool gets one thread less
+    WorkStealingPool pool(qMax(1, threads - 1));
+    MctsOptions options;
+    options.iterations = rollouts;
+    options.seed = 11;
+    MctsPlayer bot(rules, pool, options);
+
+    qint64 totalRollouts = 0;
+    qint64 totalNs = 0;
+    int botGold = 0;
+    int greedyGold = 0;
+    int searches = 0;
+
+    for (int game = 0; game < games; ++game) {
+        const quint64 seed = RandomGenerator::deriveSeed(5, game);
+        BatchLane lane;
+        BatchEngine::startLane(lane, seed, rules);
+        BatchLane greedy = lane;
+
+        while (!lane.isGameOver()) {
+            if (lane.hasRiddle()) {
+                BatchEngine::resolveLane(lane, true);
+                continue;
+            }
+            const MctsResult result = bot.search(lane);
+            totalRollouts += result.rollouts;
+            totalNs += result.nanoseconds;
+            searches++;
+            BatchEngine::stepLane(lane, static_cast<quint32>(result.door), rules);
+        }
+
+        while (!greedy.isGameOver()) {
+            if (greedy.hasRiddle()) {
+                BatchEngine::resolveLane(greedy, true);
+                continue;
+            }
+            BatchEngine::stepLane(greedy, static_cast<quint32>(MctsPlayer::greedyDoor(greedy)), rules);
+        }
+
+        botGold += lane.goldBars;
+        greedyGold += greedy.goldBars;
+    }
+
+    const double perSecond = totalRollouts / qMax(1e-9, totalNs / 1e9);
+    out << "threads:      " << threads << Qt::endl;
+    out << "searches:     " << searches << " x " << rollouts << " rollouts, "
+        << QString::number(totalNs / 1e6 / qMax(1, searches), 'f', 1) << " ms each" << Qt::endl;
+    out << "throughput:   " << QString::number(perSecond / 1e3, 'f', 1) << " k rollouts/s, "
+        << QString::number(perSecond / threads / 1e3, 'f', 1) << " k per core" << Qt::endl;
+    out << "gold:         bot " << QString::number(double(botGold) / games, 'f', 2)
+        << ", greedy " << QString::number(double(greedyGold) / games, 'f', 2)
+        << " per game over " << games << " games" << Qt::endl;
+    return 0;
+}
+
+BenchRegistrar registrar("mcts", "MCTS bot rollouts per second per core and gold vs greedy (args: games rollouts threads)", &runMcts);
+
+}
@@ -0,0 +1,88 @@
+#include "Bench.h"
+#include "../core/GameSession.h"
+#include "../core/PackedGameState.h"
+#include "../tools/common/ToolContent.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Snapshot cost of N live states: GameState copies vs one memcpy of packed
+// states, plus a pack/unpack round-trip check.
+int runPackedState(const QStringList& args)
+{
+    const int count = qMax(1, args.value(0, "100000").toInt());
+
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    GameSession session;
+    session.setSeed(7);
+    session.start(content);
+
+    // Notes are packed as a count; any deck of the catalog restores the same count
+    const ShuffledDeck noteDeck = session.getNoteDeck();
+    std::vector<GameState> states;
+    states.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        if (session.getCurrentState().isGameOver()) {
+            session.setSeed(7 + i);
+            session.start(content);
+        }
+        if (session.hasActiveRiddle()) {
+            session.resolveRiddle(i % 2 == 0);
+        } else {
+            session.chooseDoor(i % session.getCurrentState().getCurrentDoors().size());
+        }
+        states.push_back(session.getCurrentState());
+    }
+
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+
+    std::vector<PackedGameState> packed(count);
+    timer.start();
+    int unpackable = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!PackedGameState::pack(states[i], packed[i])) {
+            unpackable++;
+        }
+    }
+    const qint64 packNs = timer.nsecsElapsed();
+
+    timer.start();
+    std::vector<GameState> stateCopy = states;
+    const qint64 copyNs = timer.nsecsElapsed();
+
+    std::vector<PackedGameState> packedCopy(count);
+    timer.start();
+    std::memcpy(packedCopy.data(), packed.data(), count * sizeof(PackedGameState));
+    const qint64 memcpyNs = timer.nsecsElapsed();
+
+    int mismatches = 0;
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        PackedGameState again;
+        GameState restored = packed[i].unpack(*content, noteDeck);
+        if (!PackedGameState::pack(restored, again) || again != packed[i]) {
+            mismatches++;
+        }
+    }
+    const qint64 roundTripNs = timer.nsecsElapsed();
+
+    out << "states:              " << count << Qt::endl;
+    out << "sizeof(GameState):   " << sizeof(GameState) << " bytes + heap" << Qt::endl;
+    out << "sizeof(Packed):      " << sizeof(PackedGameState) << " bytes" << Qt::endl;
+    out << "pack:                " << QString::number(double(packNs) / count, 'f', 1) << " ns/state" << Qt::endl;
+    out << "copy GameState:      " << QString::number(double(copyNs) / count, 'f', 1) << " ns/state" << Qt::endl;
+    out << "memcpy packed:       " << QString::number(double(memcpyNs) / count, 'f', 2) << " ns/state" << Qt::endl;
+    out << "unpack+repack:       " << QString::number(double(roundTripNs) / count, 'f', 1) << " ns/state" << Qt::endl;
+    out << "not packable:        " << unpackable << Qt::endl;
+    out << "round-trip errors:   " << mismatches << Qt::endl;
+    Q_UNUSED(stateCopy);
+    return unpackable + mismatches == 0 ? 0 : 1;
+}
+
+BenchRegistrar registrar("packed_state", "Snapshot cost of GameState vs PackedGameState (args: states)", &runPackedState);
+
+}
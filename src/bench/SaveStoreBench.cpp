@@ -0,0 +1,138 @@
+#include "Bench.h"
+#include "../core/GameSnapshot.h"
+#include "../core/GameState.h"
+#include "../database/SaveStore.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+namespace {
+
+constexpr int Lookups = 10000;
+constexpr int PageSize = 20;
+
+QString microseconds(qint64 ns, int count)
+{
+    return QString::number(ns / 1e3 / qMax(1, count), 'f', 1) + " us";
+}
+
+// Latest-save lookups and history pages on a table of `rows` saves, the old
+// unindexed lookup for comparison, then the retention pass
+int runSaveStore(const QStringList& args)
+{
+    const int rows = qMax(1, args.value(0, "1000000").toInt());
+    const int players = qBound(1, args.value(1, "10000").toInt(), rows);
+    const bool legacy = args.value(2) == "legacy";
+    QTextStream out(stdout);
+    // SaveStore logs every save and load
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    QTemporaryDir dir;
+    const QString dbPath = dir.filePath("saves.db");
+    DatabaseConnection connection;
+    SaveStore store(connection);
+    if (!dir.isValid() || !connection.connectSQLite(dbPath) || !store.ensureSchema()) {
+        out << "Cannot open " << dbPath << ": " << connection.getLastError() << store.getLastError() << Qt::endl;
+        return 1;
+    }
+
+    // One save per second of game time, players taking turns; the trigger
+    // keeps latest_saves current as the rows go in
+    QElapsedTimer timer;
+    timer.start();
+    QSqlDatabase db = connection.getDatabase();
+    QSqlQuery fill(db);
+    db.transaction();
+    fill.prepare("WITH RECURSIVE n(i) AS (SELECT 0 UNION ALL SELECT i + 1 FROM n WHERE i + 1 < :rows) "
+                 "INSERT INTO game_saves (player_name, gold_bars, current_location, snapshot, saved_at) "
+                 "SELECT 'player_' || (i % :players), i % 1000, i % 5, :snapshot, "
+                 "datetime(1700000000 + i, 'unixepoch') FROM n");
+    fill.bindValue(":rows", rows);
+    fill.bindValue(":players", players);
+    fill.bindValue(":snapshot", GameSnapshot::encode(GameState()));
+    if (!fill.exec() || !db.commit()) {
+        out << "Fill failed: " << fill.lastError().text() << Qt::endl;
+        db.rollback();
+        return 1;
+    }
+    fill.finish();
+    const qint64 fillNs = timer.nsecsElapsed();
+
+    int failures = 0;
+    GameState state;
+    timer.restart();
+    for (int i = 0; i < Lookups; ++i) {
+        if (!store.load(QString("player_%1").arg((i * 7919) % players), state)) {
+            failures++;
+        }
+    }
+    const qint64 loadNs = timer.nsecsElapsed();
+
+    qint64 firstPageNs = 0;
+    qint64 nextPageNs = 0;
+    for (int i = 0; i < Lookups; ++i) {
+        const QString player = QString("player_%1").arg((i * 104729) % players);
+        timer.restart();
+        const QVector<SaveInfo> first = store.history(player, PageSize);
+        firstPageNs += timer.nsecsElapsed();
+        if (first.isEmpty()) {
+            failures++;
+            continue;
+        }
+        timer.restart();
+        const QVector<SaveInfo> next = store.history(player, PageSize, &first.last());
+        nextPageNs += timer.nsecsElapsed();
+        if (!next.isEmpty() && next.first().id >= first.last().id) {
+            failures++;
+        }
+    }
+
+    out << "saves:        " << rows << " rows, " << players << " players, filled in "
+        << QString::number(fillNs / 1e9, 'f', 1) << " s" << Qt::endl;
+    out << "latest save:  " << microseconds(loadNs, Lookups) << " per load (lookup and restore)" << Qt::endl;
+    out << "history:      " << microseconds(firstPageNs, Lookups) << " first page, "
+        << microseconds(nextPageNs, Lookups) << " next page (" << PageSize << " saves)" << Qt::endl;
+
+    if (legacy) {
+        // The lookup before the index: the planner has nothing but a scan and sort
+        constexpr int LegacyLookups = 5;
+        QSqlQuery query(db);
+        query.prepare("SELECT gold_bars, current_location, inventory, logs FROM game_saves NOT INDEXED "
+                      "WHERE player_name = :player ORDER BY saved_at DESC LIMIT 1");
+        timer.restart();
+        for (int i = 0; i < LegacyLookups; ++i) {
+            query.bindValue(":player", QString("player_%1").arg(i % players));
+            if (!query.exec() || !query.next()) {
+                failures++;
+            }
+            query.finish();
+        }
+        out << "legacy:       " << microseconds(timer.nsecsElapsed(), LegacyLookups) << " per unindexed lookup" << Qt::endl;
+    }
+
+    const qint64 sizeBefore = QFileInfo(dbPath).size();
+    timer.restart();
+    const qint64 pruned = store.prune();
+    const qint64 pruneNs = timer.nsecsElapsed();
+    QSqlQuery checkpoint(db);
+    checkpoint.exec("PRAGMA wal_checkpoint(TRUNCATE)");
+    checkpoint.finish();
+    out << "retention:    " << pruned << " rows pruned in " << QString::number(pruneNs / 1e6, 'f', 0)
+        << " ms, file " << sizeBefore / (1024 * 1024) << " -> " << QFileInfo(dbPath).size() / (1024 * 1024)
+        << " MB" << Qt::endl;
+
+    const qint64 expected = qMax<qint64>(0, rows - static_cast<qint64>(players) * SAVE_KEEP_PER_PLAYER);
+    if (failures > 0 || pruned < expected) {
+        out << "FAILED: " << failures << " lookups, " << pruned << " pruned" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("save_store", "Latest-save lookups, history paging and retention (args: rows players [legacy])", &runSaveStore);
+
+}
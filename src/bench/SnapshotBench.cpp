@@ -0,0 +1,151 @@
+#include "Bench.h"
+#include "../core/GameSession.h"
+#include "../core/GameSnapshot.h"
+#include "../tools/common/ToolContent.h"
+#include "../utils/JsonUtils.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+// States whose logs together format to at least `lines` lines; each state is
+// taken once its ring has turned over, so no entry is counted twice
+QVector<GameState> playLines(int lines)
+{
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    GameSession session;
+    session.setSeed(11);
+    session.start(content);
+
+    QVector<GameState> states;
+    quint64 taken = 0;
+    int formatted = 0;
+    for (int move = 0; formatted < lines; ++move) {
+        if (session.getCurrentState().isGameOver()) {
+            session.setSeed(11 + move);
+            session.start(content);
+            taken = 0;
+        }
+        if (session.hasActiveRiddle()) {
+            session.resolveRiddle(move % 2 == 0);
+        } else {
+            session.chooseDoor(move % session.getCurrentState().getCurrentDoors().size());
+        }
+        const GameState& state = session.getCurrentState();
+        if (state.getLog().totalCount() >= taken + GameLog::Capacity) {
+            taken = state.getLog().totalCount();
+            formatted += state.getLog().lines().size();
+            states.append(state);
+        }
+    }
+    return states;
+}
+
+QString perLine(qint64 ns, int lines)
+{
+    return QString::number(double(ns) / qMax(1, lines), 'f', 1) + " ns/line";
+}
+
+// Saving and restoring the same states as JSON (inventory and formatted log
+// lines, what saves used to hold) and as GameSnapshot
+int runSnapshot(const QStringList& args)
+{
+    const int lines = qMax(1, args.value(0, "10000").toInt());
+    const QVector<GameState> states = playLines(lines);
+    int lineCount = 0;
+    int itemCount = 0;
+    for (const GameState& state : states) {
+        lineCount += state.getLog().lines().size();
+        itemCount += state.getInventory().size();
+    }
+
+    QTextStream out(stdout);
+    QElapsedTimer timer;
+
+    QVector<QString> inventoryJson;
+    QVector<QString> logsJson;
+    qint64 jsonBytes = 0;
+    timer.start();
+    for (const GameState& state : states) {
+        QVector<int> inventory;
+        for (ItemType item : state.getInventory()) {
+            inventory.append(static_cast<int>(item));
+        }
+        inventoryJson.append(JsonUtils::inventoryToJson(inventory));
+        logsJson.append(JsonUtils::logsToJson(state.getLog().lines()));
+    }
+    const qint64 jsonEncodeNs = timer.nsecsElapsed();
+    for (int i = 0; i < states.size(); ++i) {
+        jsonBytes += inventoryJson[i].toUtf8().size() + logsJson[i].toUtf8().size();
+    }
+
+    int jsonItems = 0;
+    int jsonLines = 0;
+    timer.start();
+    for (int i = 0; i < states.size(); ++i) {
+        jsonItems += JsonUtils::inventoryFromJson(inventoryJson[i]).size();
+        jsonLines += JsonUtils::logsFromJson(logsJson[i]).size();
+    }
+    const qint64 jsonDecodeNs = timer.nsecsElapsed();
+
+    QVector<QByteArray> snapshots;
+    qint64 snapshotBytes = 0;
+    timer.start();
+    for (const GameState& state : states) {
+        snapshots.append(GameSnapshot::encode(state));
+    }
+    const qint64 encodeNs = timer.nsecsElapsed();
+    for (const QByteArray& snapshot : snapshots) {
+        snapshotBytes += snapshot.size();
+    }
+
+    int unreadable = 0;
+    timer.start();
+    for (const QByteArray& data : snapshots) {
+        GameSnapshot snapshot;
+        if (!GameSnapshot::read(data, snapshot)) {
+            unreadable++;
+        }
+    }
+    const qint64 readNs = timer.nsecsElapsed();
+
+    QVector<GameState> restored(states.size());
+    timer.start();
+    for (int i = 0; i < snapshots.size(); ++i) {
+        GameSnapshot snapshot;
+        if (!GameSnapshot::read(snapshots[i], snapshot) || !snapshot.restore(restored[i])) {
+            unreadable++;
+        }
+    }
+    const qint64 restoreNs = timer.nsecsElapsed();
+
+    int mismatches = 0;
+    for (int i = 0; i < states.size(); ++i) {
+        const GameState& a = states[i];
+        const GameState& b = restored[i];
+        if (a.getGoldBars() != b.getGoldBars() || a.getInventory() != b.getInventory()
+            || a.getNoteIds().size() != b.getNoteIds().size() || a.getActiveRiddleId() != b.getActiveRiddleId()
+            || a.getCurrentDoors().size() != b.getCurrentDoors().size()
+            || a.getLog().totalCount() != b.getLog().totalCount() || a.getLog().lines() != b.getLog().lines()) {
+            mismatches++;
+        }
+    }
+
+    out << "saves:        " << states.size() << ", " << lineCount << " log lines" << Qt::endl;
+    out << "json:         " << jsonBytes / 1024 << " KB, encode " << perLine(jsonEncodeNs, lineCount)
+        << ", decode " << perLine(jsonDecodeNs, lineCount) << Qt::endl;
+    out << "snapshot:     " << snapshotBytes / 1024 << " KB ("
+        << QString::number(double(jsonBytes) / qMax<qint64>(1, snapshotBytes), 'f', 1) << "x smaller), encode "
+        << perLine(encodeNs, lineCount) << ", read without log " << perLine(readNs, lineCount)
+        << ", full restore " << perLine(restoreNs, lineCount) << Qt::endl;
+
+    if (jsonLines != lineCount || jsonItems != itemCount || unreadable > 0 || mismatches > 0) {
+        out << "FAILED: " << unreadable << " unreadable, " << mismatches << " mismatched" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("snapshot", "Save size and encode/decode time, JSON vs GameSnapshot (args: log lines)", &runSnapshot);
+
+}
@@ -0,0 +1,117 @@
+#include "Bench.h"
+#include "../database/DatabaseManager.h"
+#include "../database/SqlScript.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+namespace {
+
+// Procedural content as the offline generators write it: the schema, then
+// one single-row INSERT per riddle and note
+QByteArray generateContent(int rows)
+{
+    QByteArray sql;
+    sql.reserve(static_cast<qsizetype>(rows) * 96 + 4096);
+    sql += "CREATE TABLE locations (id INTEGER PRIMARY KEY, name TEXT, theme TEXT, description TEXT);\n"
+           "CREATE TABLE riddles (id INTEGER PRIMARY KEY AUTO_INCREMENT, question TEXT, answer TEXT, difficulty INTEGER);\n"
+           "CREATE TABLE notes (id INTEGER PRIMARY KEY AUTO_INCREMENT, content TEXT, location_id INTEGER);\n"
+           "CREATE TABLE items (id INTEGER PRIMARY KEY, type INTEGER, name TEXT, description TEXT, rarity INTEGER);\n";
+    for (int id = 1; id <= 5; ++id) {
+        sql += "INSERT INTO locations (id, name, theme, description) VALUES (" + QByteArray::number(id)
+             + ", 'Зал " + QByteArray::number(id) + "', 'тьма', 'Сырые стены, капает вода');\n";
+    }
+
+    const int riddles = rows / 4;
+    for (int id = 1; id <= riddles; ++id) {
+        sql += "INSERT INTO riddles (id, question, answer, difficulty) VALUES (" + QByteArray::number(id)
+             + ", 'Загадка " + QByteArray::number(id) + ": что ''не ходит'', но идёт?', 'время', "
+             + QByteArray::number(1 + id % 3) + ");\n";
+    }
+    for (int id = 1; id <= rows - riddles; ++id) {
+        sql += "INSERT INTO notes (id, content, location_id) VALUES (" + QByteArray::number(id)
+             + ", 'Записка " + QByteArray::number(id) + ": не ходи налево; там -- тупик', "
+             + QByteArray::number(1 + id % 5) + ");\n";
+    }
+    return sql;
+}
+
+// Statement-by-statement import, as DatabaseManager did before batching
+bool importByStatement(const QString& dbPath, const QByteArray& sql)
+{
+    bool ok = true;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "sql_import_legacy");
+        db.setDatabaseName(dbPath);
+        ok = db.open() && db.transaction();
+        QSqlQuery query(db);
+        SqlScriptReader reader(sql);
+        SqlStatement statement;
+        while (ok && reader.next(statement)) {
+            QString text = QString::fromUtf8(statement.text);
+            if (statement.autoIncrement) {
+                text.replace("AUTO_INCREMENT", "AUTOINCREMENT", Qt::CaseInsensitive);
+            }
+            ok = query.exec(text);
+        }
+        ok = ok && db.commit();
+    }
+    QSqlDatabase::removeDatabase("sql_import_legacy");
+    return ok;
+}
+
+int runSqlImport(const QStringList& args)
+{
+    const int rows = qMax(1, args.value(0, "1000000").toInt());
+    const bool legacy = args.value(1) == "legacy";
+    QTextStream out(stdout);
+
+    QTemporaryDir dir;
+    const QString sqlPath = dir.filePath("content.sql");
+    const QByteArray sql = generateContent(rows);
+    QFile file(sqlPath);
+    if (!dir.isValid() || !file.open(QIODevice::WriteOnly) || file.write(sql) != sql.size()) {
+        out << "Cannot write " << sqlPath << Qt::endl;
+        return 1;
+    }
+    file.close();
+    out << "script:       " << QString::number(sql.size() / 1048576.0, 'f', 1) << " MB, "
+        << rows << " content rows" << Qt::endl;
+
+    QElapsedTimer timer;
+    int imported = 0;
+    {
+        DatabaseManager database;
+        timer.start();
+        if (!database.connect(dir.filePath("batched.db"), sqlPath)) {
+            out << "Import failed: " << database.getLastError() << Qt::endl;
+            return 1;
+        }
+        const qint64 importNs = timer.nsecsElapsed();
+        imported = database.loadRiddles().size() + database.loadNotes().size();
+        out << "batched:      " << QString::number(importNs / 1e9, 'f', 2) << " s, "
+            << QString::number(rows / qMax(1e-9, importNs / 1e9), 'f', 0) << " rows/s" << Qt::endl;
+    }
+
+    if (legacy) {
+        timer.restart();
+        const bool ok = importByStatement(dir.filePath("legacy.db"), sql);
+        const qint64 legacyNs = timer.nsecsElapsed();
+        out << "legacy:       " << QString::number(legacyNs / 1e9, 'f', 2) << " s, "
+            << QString::number(rows / qMax(1e-9, legacyNs / 1e9), 'f', 0) << " rows/s"
+            << (ok ? "" : " (FAILED)") << Qt::endl;
+    }
+
+    if (imported != rows) {
+        out << "MISMATCH: imported " << imported << " of " << rows << " rows" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("sql_import", "Content import into a fresh SQLite file (args: rows [legacy])", &runSqlImport);
+
+}
@@ -0,0 +1,119 @@
+#include "Bench.h"
+#include "../database/SqlScript.h"
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+namespace {
+
+// Dump shaped like game_database.sql grown by the content team: a schema with
+// MySQL AUTO_INCREMENT, a trigger, and then note inserts whose text holds
+// quotes, semicolons and comment markers
+QByteArray generateDump(qint64 bytes, int& statements)
+{
+    QByteArray dump;
+    dump.reserve(bytes + 4096);
+    dump += "-- generated dump\n"
+            "/* schema; block comment */\n"
+            "CREATE TABLE notes (id INTEGER PRIMARY KEY AUTO_INCREMENT, content TEXT, location_id INTEGER);\n"
+            "CREATE TRIGGER notes_touch AFTER INSERT ON notes BEGIN\n"
+            "    UPDATE notes SET content = CASE WHEN new.content = '' THEN '-' ELSE new.content END\n"
+            "    WHERE id = new.id;\n"
+            "END;\n";
+    statements = 2;
+
+    for (int id = 1; dump.size() < bytes; ++id) {
+        dump += "INSERT INTO notes (id, content, location_id) VALUES (";
+        dump += QByteArray::number(id);
+        dump += ", 'Записка номер ";
+        dump += QByteArray::number(id);
+        dump += ": ''не ходи налево''; -- это не комментарий /* и это */', ";
+        dump += QByteArray::number(1 + id % 5);
+        dump += "); -- id ";
+        dump += QByteArray::number(id);
+        dump += '\n';
+        statements++;
+    }
+    return dump;
+}
+
+// The splitter DatabaseManager used before SqlScriptReader: one QChar at a
+// time into a growing QString, -- comments and backslash escapes only
+int legacySplit(const QByteArray& dump)
+{
+    const QString sqlContent = QString::fromUtf8(dump);
+    QStringList statements;
+    QString currentStatement;
+    bool inString = false;
+
+    for (int i = 0; i < sqlContent.length(); i++) {
+        QChar c = sqlContent[i];
+        if (c == '\'' && (i == 0 || sqlContent[i - 1] != '\\')) {
+            inString = !inString;
+        }
+        if (!inString && c == '-' && i + 1 < sqlContent.length() && sqlContent[i + 1] == '-') {
+            while (i < sqlContent.length() && sqlContent[i] != '\n') {
+                i++;
+            }
+            continue;
+        }
+        currentStatement += c;
+        if (!inString && c == ';') {
+            QString stmt = currentStatement.trimmed();
+            if (!stmt.isEmpty()) {
+                statements.append(stmt);
+            }
+            currentStatement.clear();
+        }
+    }
+    return statements.size();
+}
+
+int runSqlScript(const QStringList& args)
+{
+    const qint64 megabytes = qMax(1, args.value(0, "100").toInt());
+    const bool legacy = args.value(1) == "legacy";
+
+    int expected = 0;
+    const QByteArray dump = generateDump(megabytes << 20, expected);
+    QTextStream out(stdout);
+
+    QElapsedTimer timer;
+    timer.start();
+    SqlScriptReader reader(dump);
+    SqlStatement statement;
+    int statements = 0;
+    qint64 bytes = 0;
+    while (reader.next(statement)) {
+        statements++;
+        bytes += statement.text.size();
+    }
+    const qint64 readerNs = timer.nsecsElapsed();
+
+    out << "dump:         " << QString::number(dump.size() / 1048576.0, 'f', 1) << " MB, "
+        << expected << " statements" << Qt::endl;
+    out << "reader:       " << QString::number(readerNs / 1e6, 'f', 1) << " ms, "
+        << QString::number(dump.size() / 1048576.0 / qMax(1e-9, readerNs / 1e9), 'f', 0) << " MB/s, "
+        << statements << " statements, " << bytes << " bytes viewed" << Qt::endl;
+
+    if (legacy) {
+        timer.restart();
+        const int legacyStatements = legacySplit(dump);
+        const qint64 legacyNs = timer.nsecsElapsed();
+        // The old splitter ends statements at the ';' inside the trigger body
+        out << "legacy:       " << QString::number(legacyNs / 1e6, 'f', 1) << " ms, "
+            << QString::number(dump.size() / 1048576.0 / qMax(1e-9, legacyNs / 1e9), 'f', 0) << " MB/s, "
+            << legacyStatements << " statements" << Qt::endl;
+    }
+
+    const bool ok = statements == expected && !reader.isTruncated();
+    if (!ok) {
+        out << "MISMATCH: expected " << expected << " statements" << Qt::endl;
+    }
+    return ok ? 0 : 1;
+}
+
+BenchRegistrar registrar("sql_script", "SQL script tokenizer throughput on a generated dump (args: megabytes [legacy])", &runSqlScript);
+
+}
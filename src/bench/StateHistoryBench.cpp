@@ -0,0 +1,65 @@
+#include "Bench.h"
+#include "../core/GameSession.h"
+#include "../tools/common/ToolContent.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+int normalDoor(const GameState& state)
+{
+    const QVector<DoorData>& doors = state.getCurrentDoors();
+    for (int i = 0; i < doors.size(); ++i) {
+        if (doors[i].type == DoorType::NORMAL) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+// Per-move latency over one long session: processMove plus the copy a queued
+// gameStateChanged emission makes. Should stay flat as the history grows.
+int runStateHistory(const QStringList& args)
+{
+    const int moves = args.value(0, "100000").toInt();
+    const int bucket = qMax(1, args.value(1, "10000").toInt());
+
+    const ContentCatalogPtr content = ToolContent::synthetic();
+    GameSession session;
+    session.setSeed(42);
+    session.start(content);
+
+    GameState state = session.getCurrentState();
+    QTextStream out(stdout);
+    out << "moves        ns/move     entries" << Qt::endl;
+
+    QElapsedTimer timer;
+    qint64 bucketNs = 0;
+    for (int move = 1; move <= moves; ++move) {
+        if (state.isGameOver()) {
+            // Keep the session (and its history) going past the last location
+            state.setGameOver(false).setGameWon(false).setCurrentLocationIndex(0).setCurrentRoomIndex(0);
+        }
+        state.setActiveRiddleId(NoContent);
+
+        timer.start();
+        state = session.processMove(state, normalDoor(state));
+        GameState emitted = state;
+        bucketNs += timer.nsecsElapsed();
+        Q_UNUSED(emitted);
+
+        if (move % bucket == 0) {
+            out << QString("%1 %2 %3")
+                       .arg(move, 8)
+                       .arg(static_cast<double>(bucketNs) / bucket, 12, 'f', 1)
+                       .arg(state.getLog().totalCount(), 11)
+                << Qt::endl;
+            bucketNs = 0;
+        }
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("state_history", "Per-move latency from move 1 to N (args: moves bucket)", &runStateHistory);
+
+}
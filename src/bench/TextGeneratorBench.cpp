@@ -0,0 +1,78 @@
+#include "Bench.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/TextGenerator.h"
+#include <QElapsedTimer>
+#include <QTextStream>
+
+namespace {
+
+constexpr int Rounds = 3;
+
+// Themes as the locations table has them, plus one the banks don't know
+const QString Themes[] = {"Готика", "Mystic", "Упадок", "nature", "Фантазия", "theme_6"};
+constexpr int ThemeCount = sizeof(Themes) / sizeof(Themes[0]);
+
+QString nanoseconds(qint64 ns, int count)
+{
+    return QString::number(static_cast<double>(ns) / qMax(1, count), 'f', 1) + " ns";
+}
+
+// Room descriptions returned as new strings against descriptions written into
+// one reused buffer; the buffer must never be reallocated
+int runRoomText(const QStringList& args)
+{
+    const int calls = qMax(1, args.value(0, "1000000").toInt());
+    QTextStream out(stdout);
+
+    qint64 returnedNs = 0;
+    qint64 bufferNs = 0;
+    int reallocations = 0;
+    int mismatches = 0;
+    QElapsedTimer timer;
+    for (int round = 0; round < Rounds; ++round) {
+        RandomGenerator rng(round);
+        qsizetype length = 0;
+        timer.start();
+        for (int i = 0; i < calls; ++i) {
+            length += TextGenerator::generateRoomDescription(rng, i % ThemeCount + 1, 1, QString(), Themes[i % ThemeCount]).size();
+        }
+        const qint64 returned = timer.nsecsElapsed();
+
+        QString buffer;
+        buffer.reserve(TextGenerator::maxRoomDescriptionLength());
+        const QChar* const data = buffer.constData();
+        const qsizetype capacity = buffer.capacity();
+        rng.seed(round);
+        timer.restart();
+        for (int i = 0; i < calls; ++i) {
+            TextGenerator::generateRoomDescription(rng, i % ThemeCount + 1, Themes[i % ThemeCount], buffer);
+            length -= buffer.size();
+            if (buffer.constData() != data) {
+                reallocations++;
+            }
+        }
+        const qint64 written = timer.nsecsElapsed();
+        if (length != 0 || buffer.capacity() != capacity) {
+            mismatches++;
+        }
+
+        returnedNs = round == 0 ? returned : qMin(returnedNs, returned);
+        bufferNs = round == 0 ? written : qMin(bufferNs, written);
+    }
+
+    out << "descriptions: " << calls << " per round, " << ThemeCount << " themes, longest "
+        << TextGenerator::maxRoomDescriptionLength() << " chars" << Qt::endl;
+    out << "returned:     " << nanoseconds(returnedNs, calls) << " per description (one QString each)" << Qt::endl;
+    out << "buffer:       " << nanoseconds(bufferNs, calls) << " per description, "
+        << reallocations << " buffer reallocations" << Qt::endl;
+
+    if (reallocations > 0 || mismatches > 0) {
+        out << "FAILED: " << reallocations << " reallocations, " << mismatches << " rounds differ" << Qt::endl;
+        return 1;
+    }
+    return 0;
+}
+
+BenchRegistrar registrar("room_text", "Room description generation, returned strings vs a reused buffer (args: calls)", &runRoomText);
+
+}
@@ -0,0 +1,516 @@
+#include "BatchEngine.h"
+
+// The lane loops only touch element i of columns that never overlap, so the
+// vectorizer can skip its runtime alias checks
+#if defined(__clang__)
+#define LANE_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define LANE_LOOP _Pragma("GCC ivdep")
+#else
+#define LANE_LOOP
+#endif
+
+namespace {
+
+// Lane conditions are masks, all-ones when true and zero otherwise. GCC does
+// not vectorize bools that come from bit tests, so the kernels never keep
+// one: comparisons go straight to a mask.
+using Mask = quint32;
+
+inline Mask mask32(bool condition) { return 0u - static_cast<quint32>(condition); }
+
+inline quint32 select(Mask m, quint32 a, quint32 b) { return (a & m) | (b & ~m); }
+
+inline quint64 select64(Mask m, quint64 a, quint64 b)
+{
+    const quint64 wide = static_cast<quint64>(static_cast<qint64>(static_cast<qint32>(m)));
+    return (a & wide) | (b & ~wide);
+}
+
+inline quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+/**
+ * @brief LaneRegs - One lane as plain scalars, the form the kernels work on
+ *
+ * step() loads it straight from the columns and stepLane() from a BatchLane.
+ * With no arrays or objects inside, every field stays in a register and the
+ * column loop can be vectorized.
+ */
+struct LaneRegs {
+    quint64 s0, s1, s2, s3;         // RandomGenerator state
+    quint32 moves;
+    quint32 lockedAttempts;
+    quint32 goldBars;
+    quint32 notes;
+    quint32 riddles;
+    quint32 riddlesSolved;
+    quint32 keysFound;
+    quint32 keysWasted;
+    quint32 location;
+    quint32 room;
+    quint32 inventory;
+    quint32 doorCount;
+    quint32 doors;
+    quint32 flags;
+};
+
+LaneRegs load(const BatchLane& lane)
+{
+    const RandomGenerator::State& state = lane.rng.state();
+    return {state[0], state[1], state[2], state[3],
+            lane.moves, lane.lockedAttempts, lane.goldBars, lane.notes,
+            lane.riddles, lane.riddlesSolved, lane.keysFound, lane.keysWasted,
+            lane.location, lane.room, lane.inventory, lane.doorCount, lane.doors, lane.flags};
+}
+
+void store(const LaneRegs& l, BatchLane& lane)
+{
+    lane.rng.setState({l.s0, l.s1, l.s2, l.s3});
+    lane.moves = l.moves;
+    lane.lockedAttempts = l.lockedAttempts;
+    lane.goldBars = static_cast<quint16>(l.goldBars);
+    lane.notes = static_cast<quint16>(l.notes);
+    lane.riddles = static_cast<quint16>(l.riddles);
+    lane.riddlesSolved = static_cast<quint16>(l.riddlesSolved);
+    lane.keysFound = static_cast<quint16>(l.keysFound);
+    lane.keysWasted = static_cast<quint16>(l.keysWasted);
+    lane.location = static_cast<quint8>(l.location);
+    lane.room = static_cast<quint8>(l.room);
+    lane.inventory = static_cast<quint8>(l.inventory);
+    lane.doorCount = static_cast<quint8>(l.doorCount);
+    lane.doors = static_cast<quint8>(l.doors);
+    lane.flags = static_cast<quint8>(l.flags);
+}
+
+// RandomGenerator::next32() on the lane stream, which only advances when
+// `active`; otherwise the returned value must be ignored
+inline quint32 maskedNext32(LaneRegs& l, Mask active)
+{
+    const quint64 result = rotl(l.s1 * 5, 7) * 9;
+    const quint64 t = l.s1 << 17;
+    const quint64 s2 = l.s2 ^ l.s0;
+    const quint64 s3 = l.s3 ^ l.s1;
+    const quint64 s1 = l.s1 ^ s2;
+    const quint64 s0 = l.s0 ^ s3;
+
+    l.s0 = select64(active, s0, l.s0);
+    l.s1 = select64(active, s1, l.s1);
+    l.s2 = select64(active, s2 ^ t, l.s2);
+    l.s3 = select64(active, rotl(s3, 45), l.s3);
+    return static_cast<quint32>(result >> 32);
+}
+
+inline quint32 bounded(quint32 draw, quint32 n)
+{
+    return static_cast<quint32>((static_cast<quint64>(draw) * n) >> 32);
+}
+
+// Shifts by a per-lane amount only vectorize with AVX2, so the helpers below
+// pick between constant shifts instead; `index` is 0-3 throughout
+
+// 1 << index
+inline quint32 bitAt(quint32 index)
+{
+    return select(mask32(index == 0), 1, select(mask32(index == 1), 2, select(mask32(index == 2), 4, 8)));
+}
+
+// (1 << count) - 1
+inline quint32 lowBits(quint32 count)
+{
+    return (mask32(count > 0) & 1) | (mask32(count > 1) & 2) | (mask32(count > 2) & 4);
+}
+
+// Door code placed at door `index`
+inline quint32 toDoor(quint32 code, quint32 index)
+{
+    return select(mask32(index == 0), code,
+           select(mask32(index == 1), code << 2,
+           select(mask32(index == 2), code << 4, code << 6)));
+}
+
+inline quint32 doorCode(quint32 doors, quint32 index)
+{
+    return select(mask32(index == 0), doors,
+           select(mask32(index == 1), doors >> 2,
+           select(mask32(index == 2), doors >> 4, doors >> 6))) & 0x3;
+}
+
+// Rule threshold by first-door band: 0 normal, 1 silver
+inline quint32 byBand(Mask silver, const Probability (&p)[2])
+{
+    return select(silver, p[1].threshold, p[0].threshold);
+}
+
+inline quint32 doorRoll(quint32 roll, const BatchRules& rules)
+{
+    return select(mask32(roll < rules.thresholds.doorSilver.threshold), PackedGameState::SilverDoor,
+           select(mask32(roll < rules.thresholds.doorSilverOrGold.threshold), PackedGameState::GoldDoor,
+                  PackedGameState::NormalDoor));
+}
+
+// Sattolo step: swap door i with door j < i when `swap`
+inline quint32 swapDoors(quint32 doors, quint32 i, Mask swap, quint32 j)
+{
+    const quint32 a = (doors >> (2 * i)) & 0x3;
+    const quint32 b = doorCode(doors, j);
+    const quint32 swapped = (doors & ~((0x3u << (2 * i)) | toDoor(0x3, j))) | toDoor(a, j) | (b << (2 * i));
+    return select(swap, swapped, doors);
+}
+
+// GameSession::generateDoors(): count, one roll per extra door, then a
+// Sattolo shuffle with random(0, i - 1). Draws only when `active`. The door
+// loops are unrolled so every shift by i is a constant.
+Q_ALWAYS_INLINE void generateDoors(LaneRegs& l, Mask active, const BatchRules& rules)
+{
+    const quint32 count = qBound<quint32>(1, rules.minDoors + bounded(maskedNext32(l, active), rules.doorSpan), 4);
+
+    const Mask door1 = active & mask32(count > 1);
+    const Mask door2 = active & mask32(count > 2);
+    const Mask door3 = active & mask32(count > 3);
+
+    quint32 doors = PackedGameState::WoodenDoor;
+    doors |= (doorRoll(maskedNext32(l, door1), rules) & door1) << 2;
+    doors |= (doorRoll(maskedNext32(l, door2), rules) & door2) << 4;
+    doors |= (doorRoll(maskedNext32(l, door3), rules) & door3) << 6;
+
+    doors = swapDoors(doors, 3, door3, bounded(maskedNext32(l, door3), 3));
+    doors = swapDoors(doors, 2, door2, bounded(maskedNext32(l, door2), 2));
+    doors = swapDoors(doors, 1, door1, bounded(maskedNext32(l, door1), 1));
+
+    l.doorCount = select(active, count, l.doorCount);
+    l.doors = select(active, doors, l.doors);
+}
+
+// Append a key to the inventory when `add` (caller checked the space)
+inline quint32 addKey(quint32 inventory, Mask gold, Mask add)
+{
+    const quint32 size = inventory & 0x3;
+    const quint32 added = (size + 1) | ((inventory >> 2) | (bitAt(size) & gold)) << 2;
+    return select(add, added, inventory);
+}
+
+Q_ALWAYS_INLINE void stepKernel(LaneRegs& l, quint32 door, const BatchRules& rules)
+{
+    const Mask live = mask32((l.flags & BatchLane::GameOver) == 0);
+    const Mask valid = live & mask32(door < l.doorCount);
+
+    // processKeyRequirement()
+    const quint32 code = doorCode(l.doors, door & 0x3);
+    const Mask silverDoor = mask32(code == PackedGameState::SilverDoor);
+    const Mask goldDoor = mask32(code == PackedGameState::GoldDoor);
+
+    const quint32 size = l.inventory & 0x3;
+    const quint32 slots = l.inventory >> 2;
+    const quint32 present = lowBits(size);
+    const quint32 keys = select(goldDoor, slots & present, ~slots & present);
+    const Mask keyDoor = silverDoor | goldDoor;
+    const Mask locked = valid & keyDoor & mask32(keys == 0);
+    const Mask moved = valid & ~locked;
+
+    // removeItem(): drop the first matching slot and close the gap
+    const quint32 first = keys & (0u - keys);
+    const quint32 remaining = (slots & (first - 1)) | ((slots & ~((first << 1) - 1)) >> 1);
+    quint32 inventory = select(moved & keyDoor, (size - 1) | (remaining << 2), l.inventory);
+
+    l.lockedAttempts += locked & 1;
+    l.moves += moved & 1;
+    l.goldBars += moved & goldDoor & 1;
+
+    // Room / location progress and the win check
+    const quint32 room = l.room + (moved & 1);
+    const Mask transition = moved & mask32(room >= MOVES_PER_LOCATION);
+    l.location += transition & 1;
+    l.room = select(transition, 0, room);
+    const Mask won = moved & ~transition & mask32(l.location >= rules.locations);
+    l.flags |= won & (BatchLane::GameOver | BatchLane::GameWon);
+
+    // New room: doors, then the event behind its first door
+    const Mask enter = moved & ~won;
+    generateDoors(l, enter, rules);
+
+    const Mask silver = mask32((l.doors & 0x3) == PackedGameState::SilverDoor);
+    const quint32 roll = maskedNext32(l, enter);
+
+    const Mask isNote = enter & mask32(roll < byBand(silver, rules.thresholds.note)) & mask32(l.notes < rules.notes);
+    const Mask isItem = enter & ~isNote & mask32(roll < byBand(silver, rules.thresholds.noteOrItem));
+    const Mask isRiddle = enter & ~isNote & ~isItem
+                        & mask32(roll < byBand(silver, rules.thresholds.noteItemOrRiddle))
+                        & mask32(l.riddles < rules.riddles);
+
+    const Mask space = mask32((inventory & 0x3) < MAX_INVENTORY_SIZE);
+    const Mask keep = isItem & space;
+    const Mask goldKey = mask32(maskedNext32(l, keep) < byBand(silver, rules.thresholds.goldKey));
+
+    l.inventory = addKey(inventory, goldKey, keep);
+    l.notes += isNote & 1;
+    l.riddles += isRiddle & 1;
+    l.keysFound += isItem & 1;
+    l.keysWasted += isItem & ~space & 1;
+    l.flags |= isRiddle & BatchLane::RiddleActive;
+}
+
+Q_ALWAYS_INLINE void resolveKernel(LaneRegs& l, Mask correct)
+{
+    const Mask active = mask32((l.flags & BatchLane::RiddleActive) != 0);
+    const Mask reward = active & correct;
+    const Mask space = mask32((l.inventory & 0x3) < MAX_INVENTORY_SIZE);
+
+    l.inventory = addKey(l.inventory, ~0u, reward & space);
+    l.riddlesSolved += reward & 1;
+    l.keysFound += reward & 1;
+    l.keysWasted += reward & ~space & 1;
+    l.flags &= ~static_cast<quint32>(BatchLane::RiddleActive);
+}
+
+}
+
+BatchRules BatchRules::compile(const GameRules& rules, int locations, int riddles, int notes)
+{
+    BatchRules compiled;
+    compiled.thresholds = rules.thresholds();
+
+    const int lo = qMin(rules.minDoors, rules.maxDoors);
+    const int hi = qMax(rules.minDoors, rules.maxDoors);
+    compiled.minDoors = static_cast<quint32>(qMax(0, lo));
+    compiled.doorSpan = static_cast<quint32>(hi - lo + 1);
+
+    compiled.locations = static_cast<quint32>(qMax(0, locations));
+    compiled.riddles = static_cast<quint32>(qMax(0, riddles));
+    compiled.notes = static_cast<quint32>(qMax(0, notes));
+    return compiled;
+}
+
+BatchEngine::BatchEngine(int lanes, const BatchRules& rules)
+    : m_rules(rules)
+    , m_size(qMax(0, lanes))
+    , m_rng0(m_size), m_rng1(m_size), m_rng2(m_size), m_rng3(m_size)
+    , m_moves(m_size), m_lockedAttempts(m_size)
+    , m_goldBars(m_size), m_notes(m_size), m_riddles(m_size)
+    , m_riddlesSolved(m_size), m_keysFound(m_size), m_keysWasted(m_size)
+    , m_location(m_size), m_room(m_size), m_inventory(m_size)
+    , m_doorCount(m_size), m_doors(m_size), m_flags(m_size)
+{
+}
+
+void BatchEngine::startLane(BatchLane& lane, quint64 seed, const BatchRules& rules)
+{
+    lane = BatchLane();
+    lane.rng.seed(seed);
+
+    // start() shuffles the locations; only the draws matter for the rules
+    for (quint32 i = 1; i < rules.locations; ++i) {
+        lane.rng.next32();
+    }
+
+    LaneRegs l = load(lane);
+    generateDoors(l, ~0u, rules);
+    store(l, lane);
+}
+
+void BatchEngine::stepLane(BatchLane& lane, quint32 door, const BatchRules& rules)
+{
+    LaneRegs l = load(lane);
+    stepKernel(l, door, rules);
+    store(l, lane);
+}
+
+void BatchEngine::resolveLane(BatchLane& lane, bool correct)
+{
+    LaneRegs l = load(lane);
+    resolveKernel(l, mask32(correct));
+    store(l, lane);
+}
+
+PackedGameState BatchEngine::packLane(const BatchLane& lane, const QVector<RiddleData>& riddles,
+                                      const ShuffledDeck& riddleDeck)
+{
+    PackedGameState packed;
+    packed.bits = static_cast<quint32>(lane.location)
+                | (static_cast<quint32>(lane.room) << 4)
+                | (static_cast<quint32>(lane.inventory) << 8)
+                | (static_cast<quint32>(lane.doorCount) << 13)
+                | (static_cast<quint32>(lane.doors & ((1u << (2 * lane.doorCount)) - 1)) << 16)
+                | (static_cast<quint32>(lane.flags & (BatchLane::GameOver | BatchLane::GameWon)) << 24);
+    packed.goldBars = lane.goldBars;
+    packed.notes = lane.notes;
+    if (lane.hasRiddle() && lane.riddles > 0 && lane.riddles <= riddleDeck.size()) {
+        packed.riddleId = riddles[riddleDeck.at(lane.riddles - 1)].id;
+    }
+    return packed;
+}
+
+BatchLane BatchEngine::unpackLane(const PackedGameState& packed, int riddlesDrawn)
+{
+    BatchLane lane;
+    lane.location = static_cast<quint8>(packed.location());
+    lane.room = static_cast<quint8>(packed.room());
+    lane.inventory = static_cast<quint8>((packed.bits >> 8) & 0x1F);
+    lane.doorCount = static_cast<quint8>(packed.doorCount());
+    lane.doors = static_cast<quint8>((packed.bits >> 16) & 0xFF);
+    lane.flags = static_cast<quint8>((packed.bits >> 24) & (BatchLane::GameOver | BatchLane::GameWon));
+    if (packed.hasRiddle()) {
+        lane.flags |= BatchLane::RiddleActive;
+    }
+    lane.goldBars = packed.goldBars;
+    lane.notes = packed.notes;
+    lane.riddles = static_cast<quint16>(qBound(0, riddlesDrawn, 0xFFFF));
+    return lane;
+}
+
+void BatchEngine::reset(int index, quint64 seed)
+{
+    BatchLane fresh;
+    startLane(fresh, seed, m_rules);
+    setLane(index, fresh);
+}
+
+void BatchEngine::resetAll(quint64 seed, quint64 firstStream)
+{
+    for (int i = 0; i < m_size; ++i) {
+        reset(i, RandomGenerator::deriveSeed(seed, firstStream + i));
+    }
+}
+
+void BatchEngine::step(const quint8* doorChoices)
+{
+    // Locals so the compiler need not assume the stores below change them
+    const BatchRules rules = m_rules;
+    const int n = m_size;
+    quint64* rng0 = m_rng0.data();
+    quint64* rng1 = m_rng1.data();
+    quint64* rng2 = m_rng2.data();
+    quint64* rng3 = m_rng3.data();
+    quint32* moves = m_moves.data();
+    quint32* lockedAttempts = m_lockedAttempts.data();
+    quint16* goldBars = m_goldBars.data();
+    quint16* notes = m_notes.data();
+    quint16* riddles = m_riddles.data();
+    quint16* keysFound = m_keysFound.data();
+    quint16* keysWasted = m_keysWasted.data();
+    quint8* location = m_location.data();
+    quint8* room = m_room.data();
+    quint8* inventory = m_inventory.data();
+    quint8* doorCount = m_doorCount.data();
+    quint8* doors = m_doors.data();
+    quint8* flags = m_flags.data();
+
+    LANE_LOOP
+    for (int i = 0; i < n; ++i) {
+        LaneRegs l;
+        l.s0 = rng0[i];
+        l.s1 = rng1[i];
+        l.s2 = rng2[i];
+        l.s3 = rng3[i];
+        l.moves = moves[i];
+        l.lockedAttempts = lockedAttempts[i];
+        l.goldBars = goldBars[i];
+        l.notes = notes[i];
+        l.riddles = riddles[i];
+        l.riddlesSolved = 0;        // Not touched by a step
+        l.keysFound = keysFound[i];
+        l.keysWasted = keysWasted[i];
+        l.location = location[i];
+        l.room = room[i];
+        l.inventory = inventory[i];
+        l.doorCount = doorCount[i];
+        l.doors = doors[i];
+        l.flags = flags[i];
+
+        stepKernel(l, doorChoices[i], rules);
+
+        rng0[i] = l.s0;
+        rng1[i] = l.s1;
+        rng2[i] = l.s2;
+        rng3[i] = l.s3;
+        moves[i] = l.moves;
+        lockedAttempts[i] = l.lockedAttempts;
+        goldBars[i] = static_cast<quint16>(l.goldBars);
+        notes[i] = static_cast<quint16>(l.notes);
+        riddles[i] = static_cast<quint16>(l.riddles);
+        keysFound[i] = static_cast<quint16>(l.keysFound);
+        keysWasted[i] = static_cast<quint16>(l.keysWasted);
+        location[i] = static_cast<quint8>(l.location);
+        room[i] = static_cast<quint8>(l.room);
+        inventory[i] = static_cast<quint8>(l.inventory);
+        doorCount[i] = static_cast<quint8>(l.doorCount);
+        doors[i] = static_cast<quint8>(l.doors);
+        flags[i] = static_cast<quint8>(l.flags);
+    }
+}
+
+void BatchEngine::resolveRiddles(const quint8* correct)
+{
+    const int n = m_size;
+    quint16* riddlesSolved = m_riddlesSolved.data();
+    quint16* keysFound = m_keysFound.data();
+    quint16* keysWasted = m_keysWasted.data();
+    quint8* inventory = m_inventory.data();
+    quint8* flags = m_flags.data();
+
+    LANE_LOOP
+    for (int i = 0; i < n; ++i) {
+        LaneRegs l = {};
+        l.riddlesSolved = riddlesSolved[i];
+        l.keysFound = keysFound[i];
+        l.keysWasted = keysWasted[i];
+        l.inventory = inventory[i];
+        l.flags = flags[i];
+
+        resolveKernel(l, mask32(correct[i] != 0));
+
+        riddlesSolved[i] = static_cast<quint16>(l.riddlesSolved);
+        keysFound[i] = static_cast<quint16>(l.keysFound);
+        keysWasted[i] = static_cast<quint16>(l.keysWasted);
+        inventory[i] = static_cast<quint8>(l.inventory);
+        flags[i] = static_cast<quint8>(l.flags);
+    }
+}
+
+BatchLane BatchEngine::lane(int i) const
+{
+    BatchLane lane;
+    lane.rng.setState({m_rng0[i], m_rng1[i], m_rng2[i], m_rng3[i]});
+    lane.moves = m_moves[i];
+    lane.lockedAttempts = m_lockedAttempts[i];
+    lane.goldBars = m_goldBars[i];
+    lane.notes = m_notes[i];
+    lane.riddles = m_riddles[i];
+    lane.riddlesSolved = m_riddlesSolved[i];
+    lane.keysFound = m_keysFound[i];
+    lane.keysWasted = m_keysWasted[i];
+    lane.location = m_location[i];
+    lane.room = m_room[i];
+    lane.inventory = m_inventory[i];
+    lane.doorCount = m_doorCount[i];
+    lane.doors = m_doors[i];
+    lane.flags = m_flags[i];
+    return lane;
+}
+
+void BatchEngine::setLane(int i, const BatchLane& lane)
+{
+    const RandomGenerator::State& state = lane.rng.state();
+    m_rng0[i] = state[0];
+    m_rng1[i] = state[1];
+    m_rng2[i] = state[2];
+    m_rng3[i] = state[3];
+    m_moves[i] = lane.moves;
+    m_lockedAttempts[i] = lane.lockedAttempts;
+    m_goldBars[i] = lane.goldBars;
+    m_notes[i] = lane.notes;
+    m_riddles[i] = lane.riddles;
+    m_riddlesSolved[i] = lane.riddlesSolved;
+    m_keysFound[i] = lane.keysFound;
+    m_keysWasted[i] = lane.keysWasted;
+    m_location[i] = lane.location;
+    m_room[i] = lane.room;
+    m_inventory[i] = lane.inventory;
+    m_doorCount[i] = lane.doorCount;
+    m_doors[i] = lane.doors;
+    m_flags[i] = lane.flags;
+}
+
+PackedGameState BatchEngine::packed(int index, const QVector<RiddleData>& riddles, const ShuffledDeck& riddleDeck) const
+{
+    return packLane(lane(index), riddles, riddleDeck);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <QVector>
+#include <vector>
+#include "GameRules.h"
+#include "PackedGameState.h"
+#include "Types.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/ShuffledDeck.h"
+
+/**
+ * @brief BatchRules - GameRules and content sizes compiled for the batch kernels
+ */
+struct BatchRules {
+    RuleThresholds thresholds;
+    quint32 minDoors = MIN_DOORS;
+    quint32 doorSpan = MAX_DOORS - MIN_DOORS + 1;   // Door count is minDoors + bounded(doorSpan)
+    quint32 locations = 0;
+    quint32 riddles = 0;
+    quint32 notes = 0;
+
+    // Door counts are capped at 4, the PackedGameState limit
+    static BatchRules compile(const GameRules& rules, int locations, int riddles, int notes);
+};
+
+/**
+ * @brief BatchLane - Rule state of one game, as the batch kernels see it
+ *
+ * Inventory and doors use the PackedGameState encoding. Content is tracked as
+ * the number of notes and riddles drawn so far.
+ */
+struct BatchLane {
+    enum Flag : quint8 {
+        GameOver = 1,
+        GameWon = 2,
+        RiddleActive = 4
+    };
+
+    RandomGenerator rng;
+    quint32 moves = 0;
+    quint32 lockedAttempts = 0;
+    quint16 goldBars = 0;
+    quint16 notes = 0;              // Notes drawn, i.e. found
+    quint16 riddles = 0;            // Riddles drawn; the active one is deck card riddles - 1
+    quint16 riddlesSolved = 0;
+    quint16 keysFound = 0;
+    quint16 keysWasted = 0;
+    quint8 location = 0;
+    quint8 room = 0;
+    quint8 inventory = 0;           // Size in bits 0-1, slots from bit 2 (1 = gold key)
+    quint8 doorCount = 0;
+    quint8 doors = 0;               // 2-bit PackedGameState::DoorCode per door
+    quint8 flags = 0;
+
+    bool isGameOver() const { return flags & GameOver; }
+    bool isGameWon() const { return flags & GameWon; }
+    bool hasRiddle() const { return flags & RiddleActive; }
+};
+
+/**
+ * @brief BatchEngine - N games in structure-of-arrays columns, advanced together
+ *
+ * step() applies one door choice per lane with the same random draws, in the
+ * same order, as GameSession::chooseDoor(), so a lane seeded like a session
+ * stays bit-identical to it (see the batch_step bench). Presentation work
+ * (log, room descriptions, observers) is skipped entirely.
+ *
+ * The kernels are branch-free: every lane runs the same instruction stream,
+ * random streams advance under a mask, and selects replace ifs. step() and
+ * resolveRiddles() load each lane from the columns into registers and store
+ * it back, so GCC vectorizes their loops (the batch_step bench prints its
+ * report). The single-lane kernels run the same code on a BatchLane, for
+ * searches that need an exact, cheap copy of one game.
+ */
+class BatchEngine {
+public:
+    BatchEngine(int lanes, const BatchRules& rules);
+
+    int size() const { return m_size; }
+    const BatchRules& rules() const { return m_rules; }
+
+    // Same as GameSession::setSeed(seed) followed by start()
+    void reset(int lane, quint64 seed);
+
+    // Lane i gets RandomGenerator::deriveSeed(seed, firstStream + i)
+    void resetAll(quint64 seed, quint64 firstStream = 0);
+
+    /**
+     * @brief Apply one door choice per lane (GameSession::chooseDoor)
+     *
+     * Finished lanes are left unchanged.
+     */
+    void step(const quint8* doorChoices);
+
+    /**
+     * @brief Resolve the active riddle per lane (GameSession::resolveRiddle)
+     *
+     * Lanes without a riddle are left unchanged.
+     */
+    void resolveRiddles(const quint8* correct);
+
+    BatchLane lane(int index) const;
+    void setLane(int index, const BatchLane& lane);
+
+    // Packed form of a lane; riddles is the content the lane draws from, in deck order
+    PackedGameState packed(int index, const QVector<RiddleData>& riddles, const ShuffledDeck& riddleDeck) const;
+
+    const quint8* gameFlags() const { return m_flags.data(); }
+    const quint16* goldBars() const { return m_goldBars.data(); }
+
+    static void startLane(BatchLane& lane, quint64 seed, const BatchRules& rules);
+    static void stepLane(BatchLane& lane, quint32 door, const BatchRules& rules);
+    static void resolveLane(BatchLane& lane, bool correct);
+    static PackedGameState packLane(const BatchLane& lane, const QVector<RiddleData>& riddles,
+                                    const ShuffledDeck& riddleDeck);
+
+    // Inverse of packLane(); the random stream is left unseeded
+    static BatchLane unpackLane(const PackedGameState& packed, int riddlesDrawn);
+
+private:
+    BatchRules m_rules;
+    int m_size = 0;
+
+    std::vector<quint64> m_rng0, m_rng1, m_rng2, m_rng3;
+    std::vector<quint32> m_moves;
+    std::vector<quint32> m_lockedAttempts;
+    std::vector<quint16> m_goldBars;
+    std::vector<quint16> m_notes;
+    std::vector<quint16> m_riddles;
+    std::vector<quint16> m_riddlesSolved;
+    std::vector<quint16> m_keysFound;
+    std::vector<quint16> m_keysWasted;
+    std::vector<quint8> m_location;
+    std::vector<quint8> m_room;
+    std::vector<quint8> m_inventory;
+    std::vector<quint8> m_doorCount;
+    std::vector<quint8> m_doors;
+    std::vector<quint8> m_flags;
+};
@@ -12,13 +12,39 @@ constexpr int MAX_LOCATIONS = 10;
 //constexpr const char* DB_USER = "root";
 //constexpr const char* DB_PASSWORD = "";
 //constexpr int DB_PORT = 3306;
+constexpr int DB_SCHEMA_VERSION = 1;            // Bump when the import itself changes, not the SQL file
+constexpr int SAVE_KEEP_PER_PLAYER = 20;        // Retention: newest saves kept for each player
+constexpr int SAVE_PRUNE_BATCH = 1000;          // Rows deleted per pruning transaction
+
+// Door generation
+constexpr int MIN_DOORS = 2;
+constexpr int MAX_DOORS = 4;
+constexpr int DOOR_LIMIT = 4;                   // Rules may not go past this: a packed state holds four doors
+constexpr double DOOR_SILVER_CHANCE = 0.40;     // 40% of extra doors are silver
+constexpr double DOOR_GOLD_CHANCE = 0.30;       // 30% of extra doors are gold
 
 // Event probabilities (0.0 - 1.0)
-constexpr double EVENT_NOTE_CHANCE = 0.10;      // 10% chance for note
-constexpr double EVENT_ITEM_CHANCE = 0.20;      // 20% chance for item
-constexpr double EVENT_RIDDLE_CHANCE = 0.15;    // 15% chance for riddle
+constexpr double EVENT_NOTE_CHANCE = 0.40;      // 40% chance for note
+constexpr double EVENT_ITEM_CHANCE = 0.25;      // 25% chance for item
+constexpr double EVENT_RIDDLE_CHANCE = 0.10;    // 10% chance for riddle
+constexpr double SILVER_DOOR_ITEM_BONUS = 0.15;
+constexpr double SILVER_DOOR_RIDDLE_BONUS = 0.05;
+constexpr double GOLD_KEY_CHANCE = 0.20;        // Found key is gold instead of silver
+constexpr double SILVER_DOOR_GOLD_KEY_CHANCE = 0.40;
+
+// Bot player
+constexpr int HINT_ROLLOUTS = 20000;            // MCTS rollouts per hint or autoplay move
+
+// Autosave
+constexpr int AUTOSAVE_FLUSH_MS = 250;          // Group commit at least this often...
+constexpr int AUTOSAVE_FLUSH_MOVES = 32;        // ... or once this many moves are queued
+constexpr int AUTOSAVE_SNAPSHOT_MOVES = 64;     // Full snapshot every N moves, deltas in between
+
+// Game server
+constexpr int SERVER_MAX_LINE = 8192;           // Longest request line before the client is dropped
 
 // UI constants
 constexpr int WINDOW_WIDTH = 1200;
 constexpr int WINDOW_HEIGHT = 800;
 constexpr int LOG_MAX_LINES = 100;
+constexpr int AUTOPLAY_DELAY_MS = 400;
@@ -0,0 +1,85 @@
+#include "ContentCatalog.h"
+#include <QMutex>
+#include <QMutexLocker>
+
+namespace {
+
+void fnv1a(quint32& hash, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 16777619u;
+    }
+}
+
+template <typename T>
+QHash<ContentId, int> indexById(const QVector<T>& items, quint32& hash)
+{
+    QHash<ContentId, int> index;
+    index.reserve(items.size());
+    fnv1a(hash, static_cast<quint32>(items.size()));
+    for (int i = 0; i < items.size(); ++i) {
+        index.insert(items[i].id, i);
+        fnv1a(hash, static_cast<quint32>(items[i].id));
+    }
+    return index;
+}
+
+template <typename T>
+const T* find(const QVector<T>& items, const QHash<ContentId, int>& index, ContentId id)
+{
+    const auto it = index.constFind(id);
+    return it == index.constEnd() ? nullptr : &items[it.value()];
+}
+
+QMutex sharedMutex;
+ContentCatalogPtr sharedCatalog;
+
+}
+
+ContentCatalog::ContentCatalog(QVector<LocationData> locations, QVector<RiddleData> riddles, QVector<NoteData> notes,
+                               std::shared_ptr<const void> storage)
+    : m_storage(std::move(storage))
+    , m_locations(std::move(locations))
+    , m_riddles(std::move(riddles))
+    , m_notes(std::move(notes))
+    , m_fingerprint(2166136261u)
+{
+    m_locationIndex = indexById(m_locations, m_fingerprint);
+    m_riddleIndex = indexById(m_riddles, m_fingerprint);
+    m_noteIndex = indexById(m_notes, m_fingerprint);
+}
+
+ContentCatalogPtr ContentCatalog::create(QVector<LocationData> locations, QVector<RiddleData> riddles, QVector<NoteData> notes,
+                                         std::shared_ptr<const void> storage)
+{
+    return std::make_shared<const ContentCatalog>(std::move(locations), std::move(riddles), std::move(notes),
+                                                  std::move(storage));
+}
+
+const LocationData* ContentCatalog::location(ContentId id) const
+{
+    return find(m_locations, m_locationIndex, id);
+}
+
+const RiddleData* ContentCatalog::riddle(ContentId id) const
+{
+    return find(m_riddles, m_riddleIndex, id);
+}
+
+const NoteData* ContentCatalog::note(ContentId id) const
+{
+    return find(m_notes, m_noteIndex, id);
+}
+
+ContentCatalogPtr ContentCatalog::shared()
+{
+    QMutexLocker locker(&sharedMutex);
+    return sharedCatalog;
+}
+
+void ContentCatalog::setShared(ContentCatalogPtr catalog)
+{
+    QMutexLocker locker(&sharedMutex);
+    sharedCatalog = std::move(catalog);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QHash>
+#include <QVector>
+#include <memory>
+#include "Types.h"
+
+class ContentCatalog;
+using ContentCatalogPtr = std::shared_ptr<const ContentCatalog>;
+
+/**
+ * @brief ContentCatalog - Immutable locations, riddles and notes shared by reference
+ *
+ * Loaded once and never modified, so any number of sessions and threads can
+ * hold the same catalog. Game state refers to content by id; sessions keep
+ * only a cursor into the riddle and note lists. Strings may point into
+ * storage the catalog keeps alive, such as a mapped ContentPack.
+ */
+class ContentCatalog {
+public:
+    ContentCatalog(QVector<LocationData> locations, QVector<RiddleData> riddles, QVector<NoteData> notes,
+                   std::shared_ptr<const void> storage = nullptr);
+
+    static ContentCatalogPtr create(QVector<LocationData> locations, QVector<RiddleData> riddles, QVector<NoteData> notes,
+                                    std::shared_ptr<const void> storage = nullptr);
+
+    const QVector<LocationData>& locations() const { return m_locations; }
+    const QVector<RiddleData>& riddles() const { return m_riddles; }
+    const QVector<NoteData>& notes() const { return m_notes; }
+
+    // nullptr for unknown ids
+    const LocationData* location(ContentId id) const;
+    const RiddleData* riddle(ContentId id) const;
+    const NoteData* note(ContentId id) const;
+
+    // Order-sensitive hash of the content ids, the only part of the content rules depend on
+    quint32 fingerprint() const { return m_fingerprint; }
+
+    /**
+     * @brief Catalog of this process, set by whoever loads content first
+     *
+     * Thread-safe; returns nullptr until setShared() was called.
+     */
+    static ContentCatalogPtr shared();
+    static void setShared(ContentCatalogPtr catalog);
+
+private:
+    std::shared_ptr<const void> m_storage;     // Backs raw string data; released last
+    QVector<LocationData> m_locations;
+    QVector<RiddleData> m_riddles;
+    QVector<NoteData> m_notes;
+    QHash<ContentId, int> m_locationIndex;
+    QHash<ContentId, int> m_riddleIndex;
+    QHash<ContentId, int> m_noteIndex;
+    quint32 m_fingerprint = 0;
+};
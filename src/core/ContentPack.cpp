@@ -0,0 +1,350 @@
+#include "ContentPack.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QResource>
+#include <QSaveFile>
+#include <cstring>
+#include <type_traits>
+
+static_assert(Q_BYTE_ORDER == Q_LITTLE_ENDIAN, "Content packs are mapped as little-endian records");
+static_assert(std::is_trivially_copyable<PackHeader>::value && sizeof(PackHeader) == 88, "PackHeader layout changed");
+static_assert(sizeof(PackLocation) == 36 && sizeof(PackRiddle) == 24
+              && sizeof(PackNote) == 16 && sizeof(PackItem) == 24, "Pack record layout changed");
+
+namespace {
+
+const char Magic[4] = {'L', 'B', 'C', 'P'};
+constexpr int SectionAlignment = 8;
+
+void setError(QString* error, const QString& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+quint32 alignTo(QByteArray& out, int alignment)
+{
+    while (out.size() % alignment != 0) {
+        out.append('\0');
+    }
+    return static_cast<quint32>(out.size());
+}
+
+template <typename T>
+quint32 appendSection(QByteArray& out, const QVector<T>& records)
+{
+    const quint32 offset = alignTo(out, SectionAlignment);
+    out.append(reinterpret_cast<const char*>(records.constData()), static_cast<int>(records.size() * sizeof(T)));
+    return offset;
+}
+
+/**
+ * @brief StringArena - Collects the strings of a pack being written
+ */
+class StringArena {
+public:
+    PackString add(const QString& text)
+    {
+        PackString ref;
+        ref.offset = static_cast<quint32>(m_text.size());
+        ref.length = static_cast<quint32>(text.size());
+        m_text += text;
+        return ref;
+    }
+
+    const QString& text() const { return m_text; }
+
+private:
+    QString m_text;
+};
+
+}
+
+PackSource PackSource::stat(const QString& sqlPath)
+{
+    PackSource source;
+    const QFileInfo info(sqlPath);
+    if (info.isFile()) {
+        source.size = info.size();
+        source.modified = info.lastModified().toMSecsSinceEpoch();
+    }
+    return source;
+}
+
+ContentPack::~ContentPack() = default;
+
+ContentPackPtr ContentPack::open(const QString& path, QString* error)
+{
+    std::shared_ptr<ContentPack> pack(new ContentPack());
+
+    if (path.startsWith(QLatin1Char(':'))) {
+        // Resource data lives in the executable image for the whole run
+        QResource resource(path);
+        if (!resource.isValid() || resource.compressionAlgorithm() != QResource::NoCompression) {
+            setError(error, "Content pack resource is missing or compressed: " + path);
+            return nullptr;
+        }
+        pack->m_data = resource.data();
+        pack->m_size = resource.size();
+    } else {
+        pack->m_file = std::make_unique<QFile>(path);
+        if (!pack->m_file->open(QIODevice::ReadOnly)) {
+            setError(error, pack->m_file->errorString());
+            return nullptr;
+        }
+        pack->m_size = pack->m_file->size();
+        pack->m_data = pack->m_file->map(0, pack->m_size);
+        if (!pack->m_data) {
+            setError(error, "Cannot map content pack: " + pack->m_file->errorString());
+            return nullptr;
+        }
+    }
+
+    if (!pack->validate(error)) {
+        return nullptr;
+    }
+    return pack;
+}
+
+ContentPackPtr ContentPack::openCurrent(const QString& path, const QString& sqlPath, QString* error)
+{
+    ContentPackPtr pack = open(path, error);
+    if (!pack) {
+        return nullptr;
+    }
+    const PackSource source = PackSource::stat(sqlPath);
+    if (source.size >= 0 && (static_cast<quint64>(source.size) != pack->m_header->sourceSize
+                             || source.modified != pack->m_header->sourceModified)) {
+        setError(error, "Content pack was compiled from another version of " + sqlPath);
+        return nullptr;
+    }
+    return pack;
+}
+
+bool ContentPack::validate(QString* error)
+{
+    if (m_size < static_cast<qint64>(sizeof(PackHeader)) || std::memcmp(m_data, Magic, sizeof(Magic)) != 0) {
+        setError(error, "Not a content pack");
+        return false;
+    }
+    if (reinterpret_cast<quintptr>(m_data) % SectionAlignment != 0) {
+        setError(error, "Content pack data is not aligned");
+        return false;
+    }
+
+    const PackHeader* header = reinterpret_cast<const PackHeader*>(m_data);
+    if (header->formatVersion != FormatVersion) {
+        setError(error, QString("Unsupported content pack version %1").arg(header->formatVersion));
+        return false;
+    }
+    if (header->fileSize != m_size) {
+        setError(error, "Truncated content pack");
+        return false;
+    }
+
+    const auto fits = [this](quint32 offset, quint64 count, quint64 recordSize) {
+        return offset % 4 == 0 && offset + count * recordSize <= static_cast<quint64>(m_size);
+    };
+    if (!fits(header->locationsOffset, header->locationCount, sizeof(PackLocation))
+        || !fits(header->riddlesOffset, header->riddleCount, sizeof(PackRiddle))
+        || !fits(header->notesOffset, header->noteCount, sizeof(PackNote))
+        || !fits(header->itemsOffset, header->itemCount, sizeof(PackItem))
+        || !fits(header->noteIndexOffset, header->noteIndexCount, sizeof(quint32))
+        || !fits(header->stringsOffset, header->stringsLength, sizeof(QChar))) {
+        setError(error, "Content pack section out of range");
+        return false;
+    }
+
+    // One pass over the records; the strings themselves are never touched
+    const auto inArena = [header](const PackString& ref) {
+        return static_cast<quint64>(ref.offset) + ref.length <= header->stringsLength;
+    };
+    bool valid = inArena(header->contentVersion);
+    const PackLocation* locations = section<PackLocation>(header->locationsOffset);
+    for (quint32 i = 0; valid && i < header->locationCount; ++i) {
+        valid = inArena(locations[i].name) && inArena(locations[i].theme) && inArena(locations[i].description)
+             && static_cast<quint64>(locations[i].firstNote) + locations[i].noteCount <= header->noteIndexCount;
+    }
+    const PackRiddle* riddles = section<PackRiddle>(header->riddlesOffset);
+    for (quint32 i = 0; valid && i < header->riddleCount; ++i) {
+        valid = inArena(riddles[i].question) && inArena(riddles[i].answer);
+    }
+    const PackNote* notes = section<PackNote>(header->notesOffset);
+    for (quint32 i = 0; valid && i < header->noteCount; ++i) {
+        valid = inArena(notes[i].content);
+    }
+    const PackItem* items = section<PackItem>(header->itemsOffset);
+    for (quint32 i = 0; valid && i < header->itemCount; ++i) {
+        valid = inArena(items[i].name) && inArena(items[i].description);
+    }
+    const quint32* noteIndex = section<quint32>(header->noteIndexOffset);
+    for (quint32 i = 0; valid && i < header->noteIndexCount; ++i) {
+        valid = noteIndex[i] < header->noteCount;
+    }
+    if (!valid) {
+        setError(error, "Content pack record out of range");
+        return false;
+    }
+
+    m_header = header;
+    m_strings = section<QChar>(header->stringsOffset);
+    return true;
+}
+
+bool ContentPack::write(const QString& path,
+                        const PackSource& source,
+                        const QVector<LocationData>& locations,
+                        const QVector<RiddleData>& riddles,
+                        const QVector<NoteData>& notes,
+                        const QVector<ItemData>& items,
+                        QString* error)
+{
+    StringArena strings;
+    PackHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.formatVersion = FormatVersion;
+    header.contentVersion = strings.add(source.contentVersion);
+    header.sourceSize = static_cast<quint64>(qMax<qint64>(0, source.size));
+    header.sourceModified = source.modified;
+
+    QVector<quint32> noteIndex;
+    noteIndex.reserve(notes.size());
+    QVector<PackLocation> locationRecords;
+    locationRecords.reserve(locations.size());
+    for (const LocationData& location : locations) {
+        PackLocation record = {};
+        record.id = location.id;
+        record.name = strings.add(location.name);
+        record.theme = strings.add(location.theme);
+        record.description = strings.add(location.description);
+        record.firstNote = static_cast<quint32>(noteIndex.size());
+        for (int i = 0; i < notes.size(); ++i) {
+            if (notes[i].locationId == location.id) {
+                noteIndex.append(static_cast<quint32>(i));
+            }
+        }
+        record.noteCount = static_cast<quint32>(noteIndex.size()) - record.firstNote;
+        locationRecords.append(record);
+    }
+
+    QVector<PackRiddle> riddleRecords;
+    riddleRecords.reserve(riddles.size());
+    for (const RiddleData& riddle : riddles) {
+        PackRiddle record = {};
+        record.id = riddle.id;
+        record.difficulty = riddle.difficulty;
+        record.question = strings.add(riddle.question);
+        record.answer = strings.add(riddle.answer);
+        riddleRecords.append(record);
+    }
+
+    QVector<PackNote> noteRecords;
+    noteRecords.reserve(notes.size());
+    for (const NoteData& note : notes) {
+        PackNote record = {};
+        record.id = note.id;
+        record.locationId = note.locationId;
+        record.content = strings.add(note.content);
+        noteRecords.append(record);
+    }
+
+    QVector<PackItem> itemRecords;
+    itemRecords.reserve(items.size());
+    for (const ItemData& item : items) {
+        PackItem record = {};
+        record.id = item.id;
+        record.type = static_cast<quint8>(item.type);
+        record.rarity = static_cast<quint8>(item.rarity);
+        record.name = strings.add(item.name);
+        record.description = strings.add(item.description);
+        itemRecords.append(record);
+    }
+
+    QByteArray data(sizeof(PackHeader), '\0');
+    header.locationCount = static_cast<quint32>(locationRecords.size());
+    header.riddleCount = static_cast<quint32>(riddleRecords.size());
+    header.noteCount = static_cast<quint32>(noteRecords.size());
+    header.itemCount = static_cast<quint32>(itemRecords.size());
+    header.noteIndexCount = static_cast<quint32>(noteIndex.size());
+    header.locationsOffset = appendSection(data, locationRecords);
+    header.riddlesOffset = appendSection(data, riddleRecords);
+    header.notesOffset = appendSection(data, noteRecords);
+    header.itemsOffset = appendSection(data, itemRecords);
+    header.noteIndexOffset = appendSection(data, noteIndex);
+    header.stringsOffset = alignTo(data, SectionAlignment);
+    header.stringsLength = static_cast<quint32>(strings.text().size());
+    data.append(reinterpret_cast<const char*>(strings.text().constData()), strings.text().size() * static_cast<int>(sizeof(QChar)));
+    header.fileSize = static_cast<quint32>(data.size());
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        setError(error, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QString ContentPack::defaultPath()
+{
+    return QCoreApplication::applicationDirPath() + "/content.lbpack";
+}
+
+QString ContentPack::string(const PackString& ref) const
+{
+    return QString::fromRawData(m_strings + ref.offset, static_cast<qsizetype>(ref.length));
+}
+
+LocationData ContentPack::location(int index) const
+{
+    const PackLocation& record = section<PackLocation>(m_header->locationsOffset)[index];
+    return {record.id, string(record.name), string(record.theme), string(record.description)};
+}
+
+RiddleData ContentPack::riddle(int index) const
+{
+    const PackRiddle& record = section<PackRiddle>(m_header->riddlesOffset)[index];
+    return {record.id, string(record.question), string(record.answer), record.difficulty};
+}
+
+NoteData ContentPack::note(int index) const
+{
+    const PackNote& record = section<PackNote>(m_header->notesOffset)[index];
+    return {record.id, string(record.content), record.locationId};
+}
+
+ItemData ContentPack::item(int index) const
+{
+    const PackItem& record = section<PackItem>(m_header->itemsOffset)[index];
+    return {record.id, static_cast<ItemType>(record.type), string(record.name), string(record.description),
+            static_cast<ItemRarity>(record.rarity)};
+}
+
+const quint32* ContentPack::notesOfLocation(int locationIndex, int& count) const
+{
+    const PackLocation& record = section<PackLocation>(m_header->locationsOffset)[locationIndex];
+    count = static_cast<int>(record.noteCount);
+    return section<quint32>(m_header->noteIndexOffset) + record.firstNote;
+}
+
+ContentCatalogPtr ContentPack::catalog(const ContentPackPtr& pack)
+{
+    QVector<LocationData> locations;
+    locations.reserve(pack->locationCount());
+    for (int i = 0; i < pack->locationCount(); ++i) {
+        locations.append(pack->location(i));
+    }
+    QVector<RiddleData> riddles;
+    riddles.reserve(pack->riddleCount());
+    for (int i = 0; i < pack->riddleCount(); ++i) {
+        riddles.append(pack->riddle(i));
+    }
+    QVector<NoteData> notes;
+    notes.reserve(pack->noteCount());
+    for (int i = 0; i < pack->noteCount(); ++i) {
+        notes.append(pack->note(i));
+    }
+    return ContentCatalog::create(std::move(locations), std::move(riddles), std::move(notes), pack);
+}
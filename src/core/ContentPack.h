@@ -0,0 +1,169 @@
+#pragma once
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "ContentCatalog.h"
+#include "Types.h"
+
+class ContentPack;
+using ContentPackPtr = std::shared_ptr<const ContentPack>;
+
+/**
+ * @brief PackString - String in the arena of a content pack, in UTF-16 code units
+ */
+struct PackString {
+    quint32 offset = 0;
+    quint32 length = 0;
+};
+
+struct PackLocation {
+    qint32 id;
+    PackString name;
+    PackString theme;
+    PackString description;
+    quint32 firstNote;          // Range of the note index placed in this location
+    quint32 noteCount;
+};
+
+struct PackRiddle {
+    qint32 id;
+    qint32 difficulty;
+    PackString question;
+    PackString answer;
+};
+
+struct PackNote {
+    qint32 id;
+    qint32 locationId;
+    PackString content;
+};
+
+struct PackItem {
+    qint32 id;
+    quint8 type;                // ItemType
+    quint8 rarity;              // ItemRarity
+    quint16 reserved;
+    PackString name;
+    PackString description;
+};
+
+struct PackHeader {
+    char magic[4];              // "LBCP"
+    quint32 formatVersion;
+    quint32 fileSize;
+    PackString contentVersion;  // DatabaseManager::contentVersion() of the SQL source
+    quint32 locationCount;
+    quint32 riddleCount;
+    quint32 noteCount;
+    quint32 itemCount;
+    quint32 locationsOffset;
+    quint32 riddlesOffset;
+    quint32 notesOffset;
+    quint32 itemsOffset;
+    quint32 noteIndexOffset;    // quint32 note numbers, grouped by location
+    quint32 noteIndexCount;
+    quint32 stringsOffset;
+    quint32 stringsLength;      // In UTF-16 code units
+    quint32 reserved;
+    quint64 sourceSize;         // PackSource of the SQL file the pack was compiled from
+    qint64 sourceModified;
+};
+
+/**
+ * @brief PackSource - The SQL source of a pack, as its header records it
+ */
+struct PackSource {
+    QString contentVersion;     // DatabaseManager::contentVersion() of the file
+    qint64 size = -1;
+    qint64 modified = 0;        // Last modification, ms since the epoch
+
+    // Size and modification time of the file at sqlPath; size -1 if it is missing
+    static PackSource stat(const QString& sqlPath);
+};
+
+/**
+ * @brief ContentPack - Read-only content compiled from game_database.sql
+ *
+ * A pack is one little-endian file of flat record arrays, a note index grouped
+ * by location and a UTF-16 string arena. open() maps it (QFile::map, or the
+ * resource data for ":/" paths) and checks the bounds once; after that every
+ * read is a pointer offset. The arena is UTF-16 so catalog() can hand out
+ * QString::fromRawData() views instead of decoding: content costs no heap and
+ * no SQLite. Built by labyrinth_packc.
+ */
+class ContentPack {
+public:
+    static constexpr quint32 FormatVersion = 2;
+
+    ~ContentPack();
+
+    ContentPack(const ContentPack&) = delete;
+    ContentPack& operator=(const ContentPack&) = delete;
+
+    /**
+     * @brief Map a pack file
+     * @return nullptr if the file is missing, from another version or malformed
+     */
+    static ContentPackPtr open(const QString& path, QString* error = nullptr);
+
+    /**
+     * @brief open() a pack only if its SQL source is unchanged since packc ran
+     *
+     * Compares the size and modification time in the header with the file
+     * at sqlPath, so the source itself is not read. Without the source there
+     * is nothing to compare and the pack is used.
+     */
+    static ContentPackPtr openCurrent(const QString& path, const QString& sqlPath, QString* error = nullptr);
+
+    static bool write(const QString& path,
+                      const PackSource& source,
+                      const QVector<LocationData>& locations,
+                      const QVector<RiddleData>& riddles,
+                      const QVector<NoteData>& notes,
+                      const QVector<ItemData>& items,
+                      QString* error = nullptr);
+
+    // content.lbpack next to the executable
+    static QString defaultPath();
+
+    QString contentVersion() const { return string(m_header->contentVersion); }
+    qint64 byteSize() const { return m_size; }
+
+    int locationCount() const { return static_cast<int>(m_header->locationCount); }
+    int riddleCount() const { return static_cast<int>(m_header->riddleCount); }
+    int noteCount() const { return static_cast<int>(m_header->noteCount); }
+    int itemCount() const { return static_cast<int>(m_header->itemCount); }
+
+    // Strings of the returned records point into the pack
+    LocationData location(int index) const;
+    RiddleData riddle(int index) const;
+    NoteData note(int index) const;
+    ItemData item(int index) const;
+
+    // Notes placed in a location, as indices for note(); count is set to their number
+    const quint32* notesOfLocation(int locationIndex, int& count) const;
+
+    /**
+     * @brief Catalog whose strings point into the pack
+     *
+     * The catalog keeps the pack mapped for as long as it lives.
+     */
+    static ContentCatalogPtr catalog(const ContentPackPtr& pack);
+
+private:
+    ContentPack() = default;
+
+    bool validate(QString* error);
+    QString string(const PackString& ref) const;
+
+    template <typename T>
+    const T* section(quint32 offset) const { return reinterpret_cast<const T*>(m_data + offset); }
+
+    std::unique_ptr<QFile> m_file;      // Owns the mapping; null for resources
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+    const PackHeader* m_header = nullptr;
+    const QChar* m_strings = nullptr;
+};
@@ -0,0 +1,509 @@
+#include "DoorSolver.h"
+#include "GameSession.h"
+#include "Constants.h"
+#include <QtAlgorithms>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr double TwoTo32 = 4294967296.0;
+
+// Key layout: position 0-15, silver keys 16-17, gold keys 18-19, usable
+// silver door 20, usable gold door 21, chance state 22, notes 24-39,
+// riddles 40-55. Bit 63 keeps every key non-zero, zero marks an empty slot.
+constexpr quint64 Occupied = 1ull << 63;
+constexpr quint64 SilverDoorBit = 1ull << 20;
+constexpr quint64 GoldDoorBit = 1ull << 21;
+constexpr quint64 ChanceBit = 1ull << 22;
+
+quint64 makeKey(int position, int silver, int gold, int notes, int riddles)
+{
+    return Occupied
+         | static_cast<quint64>(position)
+         | (static_cast<quint64>(silver) << 16)
+         | (static_cast<quint64>(gold) << 18)
+         | (static_cast<quint64>(notes) << 24)
+         | (static_cast<quint64>(riddles) << 40);
+}
+
+int keyPosition(quint64 key) { return static_cast<int>(key & 0xFFFF); }
+int keySilver(quint64 key) { return static_cast<int>((key >> 16) & 0x3); }
+int keyGold(quint64 key) { return static_cast<int>((key >> 18) & 0x3); }
+int keyNotes(quint64 key) { return static_cast<int>((key >> 24) & 0xFFFF); }
+int keyRiddles(quint64 key) { return static_cast<int>((key >> 40) & 0xFFFF); }
+
+// Door flags only matter when the matching key is in the inventory
+quint64 decisionKey(int position, int silver, int gold, int notes, int riddles, bool silverDoor, bool goldDoor)
+{
+    return makeKey(position, silver, gold, notes, riddles)
+         | (silverDoor && silver > 0 ? SilverDoorBit : 0)
+         | (goldDoor && gold > 0 ? GoldDoorBit : 0);
+}
+
+quint64 chanceKey(int position, int silver, int gold, int notes, int riddles)
+{
+    return makeKey(position, silver, gold, notes, riddles) | ChanceBit;
+}
+
+quint64 mixKey(quint64 key)
+{
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBull;
+    key ^= key >> 31;
+    return key;
+}
+
+// Exact chance that bounded(n) returns v: the draws x with (x * n) >> 32 == v
+double boundedOdds(quint32 n, quint32 v)
+{
+    auto firstDraw = [n](quint64 value) { return ((value << 32) + n - 1) / n; };
+    return (firstDraw(v + 1) - firstDraw(v)) / TwoTo32;
+}
+
+// Where the wooden door (origin 0) and the extras end up after the Sattolo
+// shuffle in generateDoors(); accumulates the chance of each origin at index 0
+void shuffleOrigins(int* order, int i, double odds, double* firstOrigin)
+{
+    if (i == 0) {
+        firstOrigin[order[0]] += odds;
+        return;
+    }
+    for (int j = 0; j < i; ++j) {
+        std::swap(order[i], order[j]);
+        shuffleOrigins(order, i - 1, odds * boundedOdds(static_cast<quint32>(i), static_cast<quint32>(j)), firstOrigin);
+        std::swap(order[i], order[j]);
+    }
+}
+
+struct ActionValue {
+    double gold;
+    double win;
+};
+
+}
+
+DoorSolver::DoorSolver(const BatchRules& rules, const SolverOptions& options)
+    : m_rules(rules)
+    , m_options(options)
+    , m_positions(static_cast<int>(rules.locations) * MOVES_PER_LOCATION + 1)
+{
+    const RuleThresholds& t = m_rules.thresholds;
+    const double silverOdds = t.doorSilver.threshold / TwoTo32;
+    const double goldOdds = qMax<qint64>(0, qint64(t.doorSilverOrGold.threshold) - t.doorSilver.threshold) / TwoTo32;
+    const double typeOdds[3] = {1.0 - silverOdds - goldOdds, silverOdds, goldOdds};   // Normal, silver, gold
+
+    for (quint32 v = 0; v < m_rules.doorSpan; ++v) {
+        const double countOdds = boundedOdds(m_rules.doorSpan, v);
+        const int count = qBound<int>(1, static_cast<int>(m_rules.minDoors + v), 4);
+
+        double firstOrigin[4] = {};
+        int order[4] = {0, 1, 2, 3};
+        shuffleOrigins(order, count - 1, 1.0, firstOrigin);
+
+        int combinations = 1;
+        for (int i = 1; i < count; ++i) {
+            combinations *= 3;
+        }
+
+        for (int combination = 0; combination < combinations; ++combination) {
+            int types[3] = {};
+            double odds = countOdds;
+            bool hasSilver = false;
+            bool hasGold = false;
+            for (int i = 0, rest = combination; i < count - 1; ++i, rest /= 3) {
+                types[i] = rest % 3;
+                odds *= typeOdds[types[i]];
+                hasSilver |= types[i] == 1;
+                hasGold |= types[i] == 2;
+            }
+
+            for (int origin = 0; origin < count; ++origin) {
+                const bool band = origin > 0 && types[origin - 1] == 1;
+                m_doorOdds[hasSilver][hasGold][band] += odds * firstOrigin[origin];
+            }
+        }
+    }
+}
+
+template <typename Emit>
+void DoorSolver::forEachOutcome(quint64 key, Emit&& emit) const
+{
+    const RuleThresholds& t = m_rules.thresholds;
+    const int position = keyPosition(key);
+    const int silver = keySilver(key);
+    const int gold = keyGold(key);
+    const int notes = keyNotes(key);
+    const int riddles = keyRiddles(key);
+    const bool space = silver + gold < MAX_INVENTORY_SIZE;
+
+    for (int hasSilver = 0; hasSilver < 2; ++hasSilver) {
+        for (int hasGold = 0; hasGold < 2; ++hasGold) {
+            for (int band = 0; band < 2; ++band) {
+                const double doorOdds = m_doorOdds[hasSilver][hasGold][band];
+                if (doorOdds == 0.0) {
+                    continue;
+                }
+                auto land = [&](int s, int g, int n, int r, double odds) {
+                    if (odds > 0.0) {
+                        emit(decisionKey(position, s, g, n, r, hasSilver, hasGold), doorOdds * odds);
+                    }
+                };
+
+                // The game start rolls doors but no event
+                if (position == 0) {
+                    land(silver, gold, notes, riddles, 1.0);
+                    continue;
+                }
+
+                // Same roll boundaries as BatchEngine::stepLane()
+                const quint64 noteEnd = static_cast<quint32>(notes) < m_rules.notes ? t.note[band].threshold : 0;
+                const quint64 itemEnd = qMax<quint64>(noteEnd, t.noteOrItem[band].threshold);
+                const quint64 riddleEnd = static_cast<quint32>(riddles) < m_rules.riddles
+                                        ? qMax<quint64>(itemEnd, t.noteItemOrRiddle[band].threshold) : itemEnd;
+
+                land(silver, gold, notes + 1, riddles, noteEnd / TwoTo32);
+
+                const double itemOdds = (itemEnd - noteEnd) / TwoTo32;
+                if (space) {
+                    const double goldKeyOdds = t.goldKey[band].threshold / TwoTo32;
+                    land(silver, gold + 1, notes, riddles, itemOdds * goldKeyOdds);
+                    land(silver + 1, gold, notes, riddles, itemOdds * (1.0 - goldKeyOdds));
+                } else {
+                    land(silver, gold, notes, riddles, itemOdds);
+                }
+
+                const double riddleOdds = (riddleEnd - itemEnd) / TwoTo32;
+                const double solved = space ? m_options.riddleSolveRate : 0.0;
+                land(silver, gold + 1, notes, riddles + 1, riddleOdds * solved);
+                land(silver, gold, notes, riddles + 1, riddleOdds * (1.0 - solved));
+
+                land(silver, gold, notes, riddles, 1.0 - riddleEnd / TwoTo32);
+            }
+        }
+    }
+}
+
+bool DoorSolver::solve()
+{
+    if (m_rules.locations == 0 || m_positions > 0xFFFF
+        || m_rules.notes > 0xFFFF || m_rules.riddles > 0xFFFF) {
+        return false;
+    }
+
+    // Forward: every state reachable under any policy, grouped by position
+    std::vector<std::vector<quint64>> chance(m_positions);
+    std::vector<std::vector<quint64>> decisions(m_positions);
+    m_keys.clear();
+    m_count = 0;
+    rehash(1 << 16);
+
+    bool inserted = false;
+    const quint64 origin = chanceKey(0, 0, 0, 0, 0);
+    insert(origin, inserted);
+    chance[0].push_back(origin);
+
+    for (int position = 0; position < m_positions; ++position) {
+        for (quint64 key : chance[position]) {
+            forEachOutcome(key, [&](quint64 next, double) {
+                insert(next, inserted);
+                if (inserted) {
+                    decisions[position].push_back(next);
+                }
+            });
+        }
+        if (position + 1 == m_positions) {
+            break;
+        }
+
+        for (quint64 key : decisions[position]) {
+            const int silver = keySilver(key);
+            const int gold = keyGold(key);
+            auto reach = [&](int s, int g) {
+                const quint64 next = chanceKey(position + 1, s, g, keyNotes(key), keyRiddles(key));
+                insert(next, inserted);
+                if (inserted) {
+                    chance[position + 1].push_back(next);
+                }
+            };
+            reach(silver, gold);
+            if (key & SilverDoorBit) {
+                reach(silver - 1, gold);
+            }
+            if (key & GoldDoorBit) {
+                reach(silver, gold - 1);
+            }
+        }
+    }
+
+    m_gold.assign(m_keys.size(), 0.0);
+    m_win.assign(m_keys.size(), 0.0);
+    m_action.assign(m_keys.size(), WalkNormal);
+
+    // Backward: a position only depends on the chance states of the next one
+    std::vector<int> slots;
+    for (int position = m_positions - 1; position >= 0; --position) {
+        for (std::vector<quint64>* stage : {&decisions[position], &chance[position]}) {
+            slots.resize(stage->size());
+            for (size_t i = 0; i < stage->size(); ++i) {
+                slots[i] = findSlot((*stage)[i]);
+            }
+            const bool isDecision = stage == &decisions[position];
+            parallelFor(static_cast<int>(slots.size()), [&](int i) {
+                if (isDecision) {
+                    evaluateDecision(slots[i]);
+                } else {
+                    evaluateChance(slots[i]);
+                }
+            });
+            std::vector<quint64>().swap(*stage);
+        }
+    }
+
+    m_solved = true;
+    return true;
+}
+
+void DoorSolver::evaluateDecision(int slot)
+{
+    const quint64 key = m_keys[slot];
+    const int position = keyPosition(key);
+    const int silver = keySilver(key);
+    const int gold = keyGold(key);
+
+    // Moving from the last position wins the game
+    auto after = [&](int s, int g) -> ActionValue {
+        if (position + 1 == m_positions) {
+            return {0.0, 1.0};
+        }
+        const int next = findSlot(chanceKey(position + 1, s, g, keyNotes(key), keyRiddles(key)));
+        return {m_gold[next], m_win[next]};
+    };
+
+    // Ties keep the keys
+    ActionValue best = after(silver, gold);
+    Action action = WalkNormal;
+    if (key & SilverDoorBit) {
+        const ActionValue value = after(silver - 1, gold);
+        if (value.gold > best.gold) {
+            best = value;
+            action = OpenSilver;
+        }
+    }
+    if (key & GoldDoorBit) {
+        ActionValue value = after(silver, gold - 1);
+        value.gold += 1.0;
+        if (value.gold > best.gold) {
+            best = value;
+            action = OpenGold;
+        }
+    }
+
+    m_gold[slot] = best.gold;
+    m_win[slot] = best.win;
+    m_action[slot] = action;
+}
+
+void DoorSolver::evaluateChance(int slot)
+{
+    double gold = 0.0;
+    double win = 0.0;
+    forEachOutcome(m_keys[slot], [&](quint64 next, double odds) {
+        const int index = findSlot(next);
+        gold += odds * m_gold[index];
+        win += odds * m_win[index];
+    });
+    m_gold[slot] = gold;
+    m_win[slot] = win;
+}
+
+template <typename Work>
+void DoorSolver::parallelFor(int count, Work&& work) const
+{
+    const int chunk = 512;
+    int threads = m_options.threads > 0 ? m_options.threads : static_cast<int>(std::thread::hardware_concurrency());
+    threads = qBound(1, threads, (count + chunk - 1) / chunk);
+
+    std::atomic<int> next{0};
+    auto run = [&]() {
+        for (int begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk)) {
+            const int end = qMin(count, begin + chunk);
+            for (int i = begin; i < end; ++i) {
+                work(i);
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (int t = 1; t < threads; ++t) {
+        workers.emplace_back(run);
+    }
+    run();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int DoorSolver::findSlot(quint64 key) const
+{
+    if (m_keys.empty()) {
+        return -1;
+    }
+    const size_t mask = m_keys.size() - 1;
+    for (size_t i = mixKey(key) & mask;; i = (i + 1) & mask) {
+        if (m_keys[i] == key) {
+            return static_cast<int>(i);
+        }
+        if (m_keys[i] == 0) {
+            return -1;
+        }
+    }
+}
+
+int DoorSolver::insert(quint64 key, bool& inserted)
+{
+    if ((m_count + 1) * 2 > static_cast<qint64>(m_keys.size())) {
+        rehash(static_cast<int>(m_keys.size() * 2));
+    }
+
+    const size_t mask = m_keys.size() - 1;
+    size_t i = mixKey(key) & mask;
+    while (m_keys[i] != 0) {
+        if (m_keys[i] == key) {
+            inserted = false;
+            return static_cast<int>(i);
+        }
+        i = (i + 1) & mask;
+    }
+    m_keys[i] = key;
+    m_count++;
+    inserted = true;
+    return static_cast<int>(i);
+}
+
+void DoorSolver::rehash(int capacity)
+{
+    std::vector<quint64> old;
+    old.swap(m_keys);
+    m_keys.assign(capacity, 0);
+
+    const size_t mask = m_keys.size() - 1;
+    for (quint64 key : old) {
+        if (key == 0) {
+            continue;
+        }
+        size_t i = mixKey(key) & mask;
+        while (m_keys[i] != 0) {
+            i = (i + 1) & mask;
+        }
+        m_keys[i] = key;
+    }
+}
+
+DoorAdvice DoorSolver::start() const
+{
+    DoorAdvice advice;
+    const int slot = m_solved ? findSlot(chanceKey(0, 0, 0, 0, 0)) : -1;
+    if (slot >= 0) {
+        advice.expectedGold = m_gold[slot];
+        advice.winProbability = m_win[slot];
+    }
+    return advice;
+}
+
+DoorAdvice DoorSolver::advise(const GameState& state, int riddlesDrawn) const
+{
+    DoorAdvice advice;
+    if (state.isGameOver()) {
+        advice.winProbability = state.isGameWon() ? 1.0 : 0.0;
+        return advice;
+    }
+
+    const QVector<DoorData>& doors = state.getCurrentDoors();
+    const int position = state.getCurrentLocationIndex() * MOVES_PER_LOCATION + state.getCurrentRoomIndex();
+    if (!m_solved || position < 0 || position >= m_positions || riddlesDrawn < 0) {
+        return advice;
+    }
+
+    int silver = 0;
+    int gold = 0;
+    for (ItemType item : state.getInventory()) {
+        (item == ItemType::GOLD_KEY ? gold : silver)++;
+    }
+    bool silverDoor = false;
+    bool goldDoor = false;
+    for (const DoorData& door : doors) {
+        silverDoor |= door.type == DoorType::SILVER;
+        goldDoor |= door.type == DoorType::GOLD;
+    }
+
+    const int notes = qMin<int>(state.getNoteIds().size(), m_rules.notes);
+    const int slot = findSlot(decisionKey(position, silver, gold, notes, riddlesDrawn, silverDoor, goldDoor));
+    if (slot < 0) {
+        return advice;
+    }
+
+    const DoorType wanted = m_action[slot] == OpenGold ? DoorType::GOLD
+                          : m_action[slot] == OpenSilver ? DoorType::SILVER : DoorType::NORMAL;
+    for (int i = 0; i < doors.size(); ++i) {
+        if (doors[i].type == wanted) {
+            advice.door = i;
+            break;
+        }
+    }
+    advice.expectedGold = m_gold[slot];
+    advice.winProbability = m_win[slot];
+    return advice;
+}
+
+DoorAdvice DoorSolver::advise(const GameSession& session) const
+{
+    return advise(session.getCurrentState(), session.getStats().riddlesEncountered);
+}
+
+DoorAdvice DoorSolver::advise(const BatchLane& lane) const
+{
+    DoorAdvice advice;
+    if (lane.isGameOver()) {
+        advice.winProbability = lane.isGameWon() ? 1.0 : 0.0;
+        return advice;
+    }
+
+    const int position = lane.location * MOVES_PER_LOCATION + lane.room;
+    if (!m_solved || position >= m_positions) {
+        return advice;
+    }
+
+    const int size = lane.inventory & 0x3;
+    const int gold = qPopulationCount(static_cast<quint32>((lane.inventory >> 2) & ((1u << size) - 1)));
+    bool silverDoor = false;
+    bool goldDoor = false;
+    for (int i = 0; i < lane.doorCount; ++i) {
+        const quint32 code = (lane.doors >> (2 * i)) & 0x3;
+        silverDoor |= code == PackedGameState::SilverDoor;
+        goldDoor |= code == PackedGameState::GoldDoor;
+    }
+
+    const int slot = findSlot(decisionKey(position, size - gold, gold, lane.notes, lane.riddles, silverDoor, goldDoor));
+    if (slot < 0) {
+        return advice;
+    }
+
+    for (int i = 0; i < lane.doorCount; ++i) {
+        const quint32 code = (lane.doors >> (2 * i)) & 0x3;
+        const bool match = m_action[slot] == OpenGold ? code == PackedGameState::GoldDoor
+                         : m_action[slot] == OpenSilver ? code == PackedGameState::SilverDoor
+                         : (code == PackedGameState::NormalDoor || code == PackedGameState::WoodenDoor);
+        if (match) {
+            advice.door = i;
+            break;
+        }
+    }
+    advice.expectedGold = m_gold[slot];
+    advice.winProbability = m_win[slot];
+    return advice;
+}
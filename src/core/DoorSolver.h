@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QtGlobal>
+#include <vector>
+#include "BatchEngine.h"
+#include "GameState.h"
+
+class GameSession;
+
+/**
+ * @brief SolverOptions - Player model and resources for DoorSolver::solve()
+ */
+struct SolverOptions {
+    double riddleSolveRate = 1.0;   // Chance the player answers a riddle correctly
+    int threads = 0;                // 0 = one per core
+};
+
+/**
+ * @brief DoorAdvice - Best door for a state and what it is worth
+ */
+struct DoorAdvice {
+    int door = -1;                  // Index into the current doors, -1 if the state is unknown or over
+    double expectedGold = 0.0;      // Gold bars still to come when playing optimally from here
+    double winProbability = 0.0;
+};
+
+/**
+ * @brief DoorSolver - Exact expectimax over the rule state space
+ *
+ * A decision state is (location, room, silver keys, gold keys, notes drawn,
+ * riddles drawn, has a usable silver door, has a usable gold door); key
+ * order and the other doors never change the outcome. Between decisions sit
+ * chance states: the position just entered with the inventory after the
+ * move, whose outcomes are the new doors and the room event.
+ *
+ * Transition probabilities are computed from the RuleThresholds exactly as
+ * the draws in BatchEngine::stepLane() are made, including the multiply-shift
+ * bias of bounded(). Riddles are answered before the next door, correctly
+ * with SolverOptions::riddleSolveRate.
+ *
+ * solve() enumerates every reachable state forward, then computes values
+ * position by position backwards, each position split across threads. All
+ * states live in one open-addressing table, so advise() is one hash probe.
+ */
+class DoorSolver {
+public:
+    explicit DoorSolver(const BatchRules& rules, const SolverOptions& options = SolverOptions());
+
+    /**
+     * @brief Enumerate and evaluate the state space; call once
+     * @return false if positions, notes or riddles do not fit 16 bits
+     */
+    bool solve();
+
+    bool isSolved() const { return m_solved; }
+    qint64 stateCount() const { return m_count; }
+    int positionCount() const { return m_positions; }
+
+    // Value of a game that has not started yet
+    DoorAdvice start() const;
+
+    // riddlesDrawn is SessionStats::riddlesEncountered of the session that produced the state
+    DoorAdvice advise(const GameState& state, int riddlesDrawn) const;
+    DoorAdvice advise(const GameSession& session) const;
+    DoorAdvice advise(const BatchLane& lane) const;
+
+private:
+    enum Action : qint8 {
+        WalkNormal = 0,
+        OpenSilver = 1,
+        OpenGold = 2
+    };
+
+    template <typename Emit>
+    void forEachOutcome(quint64 chanceKey, Emit&& emit) const;
+
+    int findSlot(quint64 key) const;
+    int insert(quint64 key, bool& inserted);
+    void rehash(int capacity);
+
+    void evaluateDecision(int slot);
+    void evaluateChance(int slot);
+
+    template <typename Work>
+    void parallelFor(int count, Work&& work) const;
+
+    BatchRules m_rules;
+    SolverOptions m_options;
+    int m_positions = 0;
+    bool m_solved = false;
+
+    // Door odds of a new room by [has silver][has gold][first door is silver]
+    double m_doorOdds[2][2][2] = {};
+
+    // Flat hash table: key 0 is empty, values are indexed like the keys
+    std::vector<quint64> m_keys;
+    std::vector<double> m_gold;
+    std::vector<double> m_win;
+    std::vector<qint8> m_action;
+    qint64 m_count = 0;
+};
@@ -0,0 +1,232 @@
+#include "EngineWorker.h"
+#include "GameEngine.h"
+#include <QDebug>
+#include <chrono>
+
+EngineWorker::EngineWorker(QObject* parent)
+    : QObject(parent)
+    , m_inline(qEnvironmentVariableIntValue("LABYRINTH_ENGINE_INLINE") != 0)
+{
+    if (m_inline) {
+        createEngine();
+        return;
+    }
+
+    m_engineContext = new QObject();
+    m_engineContext->moveToThread(&m_thread);
+    m_thread.setObjectName("GameEngine");
+    m_thread.start();
+
+    // Queued first, so it runs before any command doorbell
+    QMetaObject::invokeMethod(m_engineContext, [this]() { createEngine(); }, Qt::QueuedConnection);
+}
+
+EngineWorker::~EngineWorker()
+{
+    m_stopping.store(true);
+    if (m_inline) {
+        return;
+    }
+
+    // The engine saves its journal and flushes the log archive on its own thread
+    QMetaObject::invokeMethod(m_engineContext, [this]() { m_engine.reset(); }, Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_engineContext;
+}
+
+qint64 EngineWorker::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void EngineWorker::createEngine()
+{
+    m_engine = std::make_unique<GameEngine>();
+    QObject* context = m_inline ? static_cast<QObject*>(this) : m_engineContext;
+    GameEngine* engine = m_engine.get();
+
+    connect(engine, &GameEngine::gameInitialized, context, [this](const GameState& state) {
+        EngineEvent event;
+        event.type = EngineEvent::Initialized;
+        event.state = state;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::gameStateChanged, context, [this](const GameState& state) {
+        EngineEvent event;
+        event.type = EngineEvent::StateChanged;
+        event.state = state;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::errorOccurred, context, [this](const QString& error) {
+        EngineEvent event;
+        event.type = EngineEvent::Error;
+        event.text = error;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::roomDescriptionGenerated, context, [this](const QString& description) {
+        EngineEvent event;
+        event.type = EngineEvent::RoomDescription;
+        event.text = description;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::noteFound, context, [this](const NoteData& note) {
+        EngineEvent event;
+        event.type = EngineEvent::NoteFound;
+        event.note = note;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::riddleEncountered, context, [this](const RiddleData& riddle) {
+        EngineEvent event;
+        event.type = EngineEvent::RiddleEncountered;
+        event.riddle = riddle;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::gameWon, context, [this](int notesFound, int goldBars) {
+        EngineEvent event;
+        event.type = EngineEvent::GameWon;
+        event.notesFound = notesFound;
+        event.goldBars = goldBars;
+        pushEvent(std::move(event));
+    });
+    connect(engine, &GameEngine::hintReady, context, [this](int doorIndex, double expectedGold) {
+        EngineEvent event;
+        event.type = EngineEvent::HintReady;
+        event.door = doorIndex;
+        event.expectedGold = expectedGold;
+        pushEvent(std::move(event));
+    });
+}
+
+void EngineWorker::initializeGame()
+{
+    EngineCommand command;
+    command.type = EngineCommand::Initialize;
+    post(std::move(command));
+}
+
+void EngineWorker::chooseDoor(int doorIndex)
+{
+    EngineCommand command;
+    command.type = EngineCommand::Door;
+    command.door = doorIndex;
+    post(std::move(command));
+}
+
+void EngineWorker::answerRiddle(const QString& answer)
+{
+    EngineCommand command;
+    command.type = EngineCommand::Answer;
+    command.answer = answer;
+    post(std::move(command));
+}
+
+void EngineWorker::requestHint()
+{
+    EngineCommand command;
+    command.type = EngineCommand::Hint;
+    post(std::move(command));
+}
+
+void EngineWorker::post(EngineCommand command)
+{
+    command.issuedAt = now();
+    if (!m_commands.tryPush(std::move(command))) {
+        // Never block the UI; 63 unprocessed inputs means the engine is stuck anyway
+        qWarning() << "Engine command queue is full, input dropped";
+        return;
+    }
+
+    if (m_inline) {
+        drainCommands();
+        return;
+    }
+    if (!m_commandsSignalled.exchange(true)) {
+        QMetaObject::invokeMethod(m_engineContext, [this]() { drainCommands(); }, Qt::QueuedConnection);
+    }
+}
+
+void EngineWorker::drainCommands()
+{
+    // Cleared before popping: a push after the last pop rings again
+    m_commandsSignalled.store(false);
+
+    EngineCommand command;
+    while (m_commands.tryPop(command)) {
+        m_currentIssuedAt = command.issuedAt;
+        switch (command.type) {
+            case EngineCommand::Initialize:
+                m_engine->initializeGame();
+                break;
+            case EngineCommand::Door:
+                m_engine->onDoorSelected(command.door);
+                break;
+            case EngineCommand::Answer:
+                m_engine->handleRiddleAnswer(command.answer);
+                break;
+            case EngineCommand::Hint:
+                m_engine->requestHint();
+                break;
+        }
+    }
+    m_currentIssuedAt = 0;
+}
+
+void EngineWorker::pushEvent(EngineEvent event)
+{
+    event.issuedAt = m_currentIssuedAt;
+
+    // The engine may wait for the UI, never the other way round
+    while (!m_events.tryPush(std::move(event))) {
+        if (m_stopping.load()) {
+            return;
+        }
+        QThread::yieldCurrentThread();
+    }
+
+    if (m_inline) {
+        drainEvents();
+        return;
+    }
+    if (!m_eventsSignalled.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this]() { drainEvents(); }, Qt::QueuedConnection);
+    }
+}
+
+void EngineWorker::drainEvents()
+{
+    m_eventsSignalled.store(false);
+
+    EngineEvent event;
+    while (m_events.tryPop(event)) {
+        switch (event.type) {
+            case EngineEvent::Initialized:
+                emit eventDelivered(event.issuedAt);
+                emit gameInitialized(event.state);
+                break;
+            case EngineEvent::StateChanged:
+                emit eventDelivered(event.issuedAt);
+                emit gameStateChanged(event.state);
+                break;
+            case EngineEvent::Error:
+                emit errorOccurred(event.text);
+                break;
+            case EngineEvent::RoomDescription:
+                emit roomDescriptionGenerated(event.text);
+                break;
+            case EngineEvent::NoteFound:
+                emit noteFound(event.note);
+                break;
+            case EngineEvent::RiddleEncountered:
+                emit riddleEncountered(event.riddle);
+                break;
+            case EngineEvent::GameWon:
+                emit gameWon(event.notesFound, event.goldBars);
+                break;
+            case EngineEvent::HintReady:
+                emit hintReady(event.door, event.expectedGold);
+                break;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include "GameState.h"
+#include "Types.h"
+#include "../utils/SpscQueue.h"
+
+class GameEngine;
+
+/**
+ * @brief EngineCommand - Player input sent from the UI to the engine thread
+ */
+struct EngineCommand {
+    enum Type {
+        Initialize,
+        Door,
+        Answer,
+        Hint
+    };
+
+    Type type = Initialize;
+    int door = 0;
+    QString answer;
+    qint64 issuedAt = 0;        // EngineWorker::now() when the input happened
+};
+
+/**
+ * @brief EngineEvent - GameEngine signal carried back to the UI thread
+ */
+struct EngineEvent {
+    enum Type {
+        Initialized,
+        StateChanged,
+        Error,
+        RoomDescription,
+        NoteFound,
+        RiddleEncountered,
+        GameWon,
+        HintReady
+    };
+
+    Type type = StateChanged;
+    GameState state;
+    QString text;
+    NoteData note{};
+    RiddleData riddle{};
+    int notesFound = 0;
+    int goldBars = 0;
+    int door = -1;
+    double expectedGold = 0.0;
+    qint64 issuedAt = 0;        // Copied from the command that caused the event
+};
+
+/**
+ * @brief EngineWorker - Runs a GameEngine on its own thread
+ *
+ * The UI calls the slots below and listens to the same signals GameEngine
+ * has. Commands and events travel through single-producer/single-consumer
+ * rings. A queued call only rings the doorbell, and only if the other side
+ * is not already draining. Database access, content loading and moves
+ * therefore never block painting or input.
+ *
+ * With inline mode (LABYRINTH_ENGINE_INLINE=1) the engine runs synchronously
+ * on the caller's thread, as before, for latency comparisons.
+ */
+class EngineWorker : public QObject {
+    Q_OBJECT
+
+public:
+    explicit EngineWorker(QObject* parent = nullptr);
+    ~EngineWorker();
+
+    bool isInline() const { return m_inline; }
+
+    // Monotonic nanoseconds shared by both threads
+    static qint64 now();
+
+public slots:
+    void initializeGame();
+    void chooseDoor(int doorIndex);
+    void answerRiddle(const QString& answer);
+    void requestHint();
+
+signals:
+    void gameInitialized(const GameState& initialState);
+    void gameStateChanged(const GameState& newState);
+    void errorOccurred(const QString& error);
+    void roomDescriptionGenerated(const QString& description);
+    void noteFound(const NoteData& note);
+    void riddleEncountered(const RiddleData& riddle);
+    void gameWon(int notesFound, int goldBars);
+    void hintReady(int doorIndex, double expectedGold);
+
+    // Emitted before gameInitialized/gameStateChanged; issuedAt is 0 for engine-initiated events
+    void eventDelivered(qint64 issuedAt);
+
+private:
+    void post(EngineCommand command);
+    void drainCommands();           // Engine thread
+    void pushEvent(EngineEvent event);  // Engine thread
+    void drainEvents();             // UI thread
+    void createEngine();            // Engine thread
+
+    static constexpr std::size_t CommandCapacity = 64;
+    static constexpr std::size_t EventCapacity = 256;
+
+    bool m_inline = false;
+    QThread m_thread;
+    QObject* m_engineContext = nullptr;     // Lives on m_thread, receives doorbells
+    std::unique_ptr<GameEngine> m_engine;
+    qint64 m_currentIssuedAt = 0;           // Engine thread only
+
+    SpscQueue<EngineCommand, CommandCapacity> m_commands;
+    SpscQueue<EngineEvent, EventCapacity> m_events;
+    std::atomic<bool> m_commandsSignalled{false};
+    std::atomic<bool> m_eventsSignalled{false};
+    std::atomic<bool> m_stopping{false};
+};
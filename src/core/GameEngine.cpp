@@ -1,381 +1,248 @@
 #include "GameEngine.h"
+#include "../database/AsyncDatabase.h"
+#include "../database/AutosaveWriter.h"
 #include "../database/DatabaseManager.h"
-#include "../utils/RandomGenerator.h"
-#include "../utils/TextGenerator.h"
-#include "Constants.h"
+#include "ContentPack.h"
+#include "LogArchive.h"
+#include "MctsPlayer.h"
+#include "../utils/WorkStealingPool.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QStandardPaths>
 #include <QDebug>
+#include <utility>
+
+namespace {
+
+const QString AutosaveSlot = QStringLiteral("autosave");
+
+}
 
 GameEngine::GameEngine(QObject* parent)
     : QObject(parent)
-    , m_database(std::make_unique<DatabaseManager>())
-    , m_movesRemaining(MOVES_PER_LOCATION)
+    , m_database(std::make_unique<AsyncDatabase>())
+    , m_logArchive(std::make_unique<LogArchive>(LogArchive::defaultPath()))
 {
-    RandomGenerator::initializeSeed();
+    m_session.setObserver(this);
+    m_session.setLogArchive(m_logArchive.get());
+    m_session.setJournal(&m_journal);
 }
 
-GameEngine::~GameEngine() = default;
+GameEngine::~GameEngine()
+{
+    if (!m_journal.isEmpty()) {
+        QDir().mkpath(QFileInfo(defaultJournalPath()).absolutePath());
+        saveJournal(defaultJournalPath());
+    }
+}
 
-void GameEngine::initializeGame()
+void GameEngine::withContent(std::function<void(const ContentCatalogPtr&)> ready)
 {
-    if (!m_database->connect()) {
-        emit errorOccurred("Не удалось подключиться к базе данных");
+    if (ContentCatalogPtr catalog = ContentCatalog::shared()) {
+        ready(catalog);
         return;
     }
-
-    m_locations = m_database->loadLocations();
-    m_riddles = m_database->loadRiddles();
-    m_notes = m_database->loadNotes();
-
-    if (m_locations.size() > 1) {
-        for (int i = m_locations.size() - 1; i > 0; --i) {
-            int j = RandomGenerator::random(0, i - 1);
-            std::swap(m_locations[i], m_locations[j]);
-        }
+    if (ContentCatalogPtr catalog = openContentPack()) {
+        ready(catalog);
+        return;
     }
 
-    if (m_locations.isEmpty()) {
-        emit errorOccurred("Локации не загружены из БД");
+    // The database is the fallback for development trees where labyrinth_packc
+    // has not run. Callers arriving while it loads wait for the same load
+    m_contentWaiters.append(std::move(ready));
+    if (m_contentWaiters.size() > 1) {
         return;
     }
-
-    m_currentState.setCurrentLocationIndex(0)
-                   .setCurrentRoomIndex(0)
-                   .setGoldBars(0)
-                   .setGameOver(false)
-                   .setGameWon(false);
-
-    m_currentState.addLog("Добро пожаловать в Лабиринт!");
-    m_currentState.addLog("Выберите дверь, чтобы начать приключение.");
-
-    m_currentState.setCurrentDoors(generateDoors());
-    generateRoomDescription(m_currentState);
-
-    emit gameInitialized(m_currentState);
-}
-
-void GameEngine::onDoorSelected(int doorIndex)
-{
-
-    GameState newState = processMove(m_currentState, doorIndex);
-    m_currentState = newState;
-    emit gameStateChanged(m_currentState);
+    m_database->loadContent().then(this, [this](ContentCatalogPtr catalog) {
+        const auto waiters = std::exchange(m_contentWaiters, {});
+        if (!catalog) {
+            emit errorOccurred("Не удалось подключиться к базе данных");
+            return;
+        }
+        ContentCatalog::setShared(catalog);
+        // Save retention runs beside the game; nothing waits for it
+        m_database->pruneSaves();
+        for (const auto& ready : waiters) {
+            ready(catalog);
+        }
+    });
+}
+
+ContentCatalogPtr GameEngine::openContentPack()
+{
+    // The compiled pack needs no SQLite and maps in microseconds
+    const QString packPath = ContentPack::defaultPath();
+    if (QFileInfo::exists(packPath)) {
+        QElapsedTimer timer;
+        timer.start();
+        QString error;
+        // A pack left over from an older SQL source must not shadow the database
+        if (ContentPackPtr pack = ContentPack::openCurrent(packPath, DatabaseManager::defaultSqlPath(), &error)) {
+            ContentCatalogPtr catalog = ContentPack::catalog(pack);
+            ContentCatalog::setShared(catalog);
+            qDebug() << "Content pack" << pack->contentVersion() << "mapped in" << timer.nsecsElapsed() / 1000 << "us";
+            return catalog;
+        }
+        qWarning() << "Cannot open content pack:" << packPath << error;
+    }
+    return nullptr;
 }
 
-void GameEngine::addFoundNote(const NoteData& note)
+void GameEngine::initializeGame()
 {
-    m_totalNotesFound++;
-    m_currentState.addLog(QString("[*] Записок найдено: %1").arg(m_totalNotesFound));
+    withContent([this](const ContentCatalogPtr& content) {
+        startGame(content);
+    });
 }
 
-void GameEngine::startRoomDescriptionTypeWriter(const QString& text)
+void GameEngine::startGame(const ContentCatalogPtr& content)
 {
-    if (!m_typeWriter) {
-        m_typeWriter = std::make_unique<TypeWriter>();
-        connect(m_typeWriter.get(), &TypeWriter::characterAdded,
-                this, &GameEngine::onTypeWriterCharacterAdded);
-        connect(m_typeWriter.get(), &TypeWriter::typingFinished,
-                this, &GameEngine::onTypeWriterFinished);
+    m_session.setSeed(RandomGenerator::entropySeed());
+    if (!m_session.start(content)) {
+        emit errorOccurred("Локации не загружены из БД");
+        return;
     }
+    m_batchRules = BatchRules::compile(m_session.getRules(), content->locations().size(),
+                                       content->riddles().size(), content->notes().size());
+    m_bot.reset();
 
-    m_typeWriter->startTyping(text, 50);
-    emit typeWriterStarted(text);
+    autosave();
+    emit gameInitialized(m_session.getCurrentState());
 }
 
-void GameEngine::skipCurrentTypeWriter()
+void GameEngine::autosave()
 {
-    if (m_typeWriter && m_typeWriter->isTyping()) {
-        m_typeWriter->skipToEnd();
+    if (!m_autosave) {
+        m_autosave = std::make_unique<AutosaveWriter>(DatabaseManager::defaultDatabasePath());
     }
+    m_autosave->record(AutosaveSlot, m_session.getSeed(), m_session.getCurrentState());
 }
 
-void GameEngine::onTypeWriterCharacterAdded(const QString& text)
-{
-    emit roomDescriptionUpdated(text);
-}
-
-void GameEngine::onTypeWriterFinished()
+bool GameEngine::saveJournal(const QString& filePath) const
 {
-    emit typeWriterFinished();
+    QString error;
+    if (!m_journal.save(filePath, &error)) {
+        qWarning() << "Cannot save game journal:" << filePath << error;
+        return false;
+    }
+    return true;
 }
 
-GameState GameEngine::processMove(const GameState& currentState, int doorIndex)
+bool GameEngine::replayJournal(const QString& filePath)
 {
-    if (currentState.isGameOver()) {
-        return currentState;
+    GameJournal journal;
+    QString error;
+    if (!GameJournal::load(filePath, journal, &error)) {
+        emit errorOccurred("Не удалось загрузить запись игры: " + error);
+        return false;
     }
-    GameState newState = currentState;
-    newState.setLoading(true);
 
-    if (doorIndex < 0 || doorIndex >= newState.getCurrentDoors().size()) {
-        newState.addLog("ОШИБКА: Неверный выбор двери");
-        newState.setLoading(false);
-        return newState;
-    }
-
-    const DoorData& door = newState.getCurrentDoors()[doorIndex];
-
-    if (!processKeyRequirement(newState, door)) {
-        newState.setLoading(false);
-        return newState;
-    }
+    withContent([this, journal](const ContentCatalogPtr& content) {
+        // Replay headlessly: no typewriter or dialogs for the intermediate moves
+        QString replayError;
+        m_session.setObserver(nullptr);
+        const bool replayed = journal.replay(m_session, content, -1, &replayError);
+        m_session.setObserver(this);
 
-    int newRoomIndex = newState.getCurrentRoomIndex() + 1;
-    newState.setCurrentRoomIndex(newRoomIndex);
-    newState.addLog(QString("Вы вошли в комнату %1/10").arg(newRoomIndex));
-
-    if (newRoomIndex >= MOVES_PER_LOCATION) {
-        handleLocationTransition(newState);
-        newState.setCurrentDoors(generateDoors());
-        generateRoomDescription(newState);
-        handleEventGeneration(newState, newState.getCurrentDoors().first());
-
-        newState.setLoading(false);
-        return newState;
-    }
-
-    if (checkWinCondition(newState)) {
-        newState.setGameWon(true);
-        newState.setGameOver(true);
-        emit gameWon(m_totalNotesFound, newState.getGoldBars());
-        return newState;
-    }
-
-    if (newRoomIndex < MOVES_PER_LOCATION) {
-        auto doors = generateDoors();
-        newState.setCurrentDoors(doors);
-
-        if (!doors.isEmpty()) {
-            handleEventGeneration(newState, doors.first());
-
-            if (newState.getActiveRiddle()) {
-                newState.setLoading(false);
-                return newState;
-            }
+        if (!replayed) {
+            emit errorOccurred("Не удалось воспроизвести запись игры: " + replayError);
+            return;
         }
+        m_batchRules = BatchRules::compile(m_session.getRules(), content->locations().size(),
+                                           content->riddles().size(), content->notes().size());
+        m_bot.reset();
 
-        generateRoomDescription(newState);
-    }
-
-    newState.setLoading(false);
-    return newState;
+        autosave();
+        emit gameInitialized(m_session.getCurrentState());
+    });
+    return true;
 }
 
-void GameEngine::handleRiddleAnswer(const QString& answer)
+QString GameEngine::defaultJournalPath()
 {
-    qDebug() << "handleRiddleAnswer called";
-
-    if (!m_currentRiddle) {
-        emit errorOccurred("Нет активной загадки");
-        return;
-    }
-
-    GameState newState = m_currentState;
-
-    QString normalizedAnswer = answer.toLower().trimmed();
-    QString correctAnswer = m_currentRiddle->answer.toLower().trimmed();
-
-    qDebug() << "Riddle answer given:" << normalizedAnswer
-             << "correct:" << correctAnswer;
-
-    if (normalizedAnswer == correctAnswer) {
-        newState.addLog("╔════════════════════════════════════════╗");
-        newState.addLog("║  ✓ ПРАВИЛЬНО! Загадка разгадана!      ║");
-        newState.addLog("╚════════════════════════════════════════╝");
-
-        if (newState.hasInventorySpace()) {
-            newState.addItem(ItemType::GOLD_KEY);
-            newState.addLog("🗝️  Вы получили: Золотой ключ");
-        } else {
-            newState.addLog("⚠️  Инвентарь полон! Золотой ключ утерян.");
-        }
-    } else {
-        newState.addLog("╔════════════════════════════════════════╗");
-        newState.addLog("║  ✗ НЕПРАВИЛЬНО!                       ║");
-        newState.addLog("╚════════════════════════════════════════╝");
-        newState.addLog(QString("Правильный ответ: %1").arg(m_currentRiddle->answer));
-    }
-
-    newState.setActiveRiddle(nullptr);
-    m_currentRiddle = nullptr;
-
-    generateRoomDescription(newState);
-
-    m_currentState = newState;
-
-    qDebug() << "Emitting gameStateChanged with logs count:" << newState.getLogs().size();
-    emit gameStateChanged(newState);
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+           + "/last_game." + GameJournal::fileExtension();
 }
 
-bool GameEngine::checkWinCondition(const GameState& state) const
+void GameEngine::onDoorSelected(int doorIndex)
 {
-
-    return state.getCurrentLocationIndex() >= m_locations.size();
+    m_session.chooseDoor(doorIndex);
+    autosave();
+    emit gameStateChanged(m_session.getCurrentState());
 }
 
-bool GameEngine::hasGameEnded(const GameState& state) const
+GameState GameEngine::processMove(const GameState& currentState, int doorIndex)
 {
-    return state.isGameOver();
+    return m_session.processMove(currentState, doorIndex);
 }
 
-QVector<DoorData> GameEngine::generateDoors() const
+void GameEngine::handleRiddleAnswer(const QString& answer)
 {
-    QVector<DoorData> doors;
-    int doorCount = RandomGenerator::random(2, 4);
-    doors.append({DoorType::NORMAL, "Обычная деревянная дверь"});
-
-    for (int i = 1; i < doorCount; ++i) {
-        double rand = RandomGenerator::randomDouble();
-        DoorType type;
-
-        if (rand < 0.4) {
-            type = DoorType::SILVER;
-        } else if (rand < 0.7) {
-            type = DoorType::GOLD;
-        } else {
-            type = DoorType::NORMAL;
-        }
-
-        doors.append({type, doorTypeToString(type) + " дверь"});
+    if (!m_session.answerRiddle(answer)) {
+        emit errorOccurred("Нет активной загадки");
+        return;
     }
 
-    if (doors.size() > 1) {
-        for (int i = doors.size() - 1; i > 0; --i) {
-            int j = RandomGenerator::random(0, i - 1);
-            std::swap(doors[i], doors[j]);
-        }
-    }
-    return doors;
+    autosave();
+    emit gameStateChanged(m_session.getCurrentState());
 }
 
-bool GameEngine::processKeyRequirement(GameState& state, const DoorData& door)
+void GameEngine::requestHint()
 {
-    if (door.type == DoorType::SILVER) {
-        if (!state.hasItem(ItemType::SILVER_KEY)) {
-            state.addLog("⚠️ Дверь заперта! Нужен серебряный ключ.");
-            return false;
-        }
-        state.removeItem(ItemType::SILVER_KEY);
-        state.addLog("🔑 Вы открыли серебряную дверь!");
-        return true;
+    if (m_session.getCurrentState().isGameOver() || m_session.hasActiveRiddle()) {
+        return;
     }
 
-    if (door.type == DoorType::GOLD) {
-        if (!state.hasItem(ItemType::GOLD_KEY)) {
-            state.addLog("⚠️ Дверь заперта! Нужен золотой ключ.");
-            return false;
+    if (!m_bot) {
+        if (!m_botPool) {
+            m_botPool = std::make_unique<WorkStealingPool>();
         }
-        state.removeItem(ItemType::GOLD_KEY);
-        state.addLog("✨ Вы открыли золотую дверь!");
-        state.setGoldBars(state.getGoldBars() + 1);
-        state.addLog(QString("💰 Золотых слитков: %1").arg(state.getGoldBars()));
-        return true;
+        MctsOptions options;
+        options.iterations = HINT_ROLLOUTS;
+        options.seed = RandomGenerator::entropySeed();
+        m_bot = std::make_unique<MctsPlayer>(m_batchRules, *m_botPool, options);
     }
 
-    state.addLog("Вы прошли через обычную дверь.");
-    return true;
+    const MctsResult result = m_bot->search(m_session);
+    if (result.door < 0) {
+        emit errorOccurred("Бот не может оценить эту позицию");
+        return;
+    }
+    emit hintReady(result.door, result.expectedGold);
 }
 
-void GameEngine::handleLocationTransition(GameState& state)
+bool GameEngine::checkWinCondition(const GameState& state) const
 {
-    int nextLocation = state.getCurrentLocationIndex() + 1;
-    state.setCurrentLocationIndex(nextLocation);
-    state.setCurrentRoomIndex(0);
-    state.addLog("");
-    state.addLog("╔════════════════════════════════════════╗");
-    state.addLog(QString("║  ЛОКАЦИЯ ПРОЙДЕНА! Уровень %1 завершён  ║").arg(nextLocation));
-    state.addLog("╚════════════════════════════════════════╝");
-    state.addLog("");
+    return m_session.checkWinCondition(state);
 }
 
-void GameEngine::handleEventGeneration(GameState& state, const DoorData& door)
+bool GameEngine::hasGameEnded(const GameState& state) const
 {
-    double eventRoll = RandomGenerator::randomDouble();
-
-    double noteChance = 0.4;
-    double itemChance = 0.25;
-    double riddleChance = 0.1;
-
-    if (door.type == DoorType::SILVER) {
-        itemChance += 0.15;
-        riddleChance += 0.05;
-    }
-
-    if (eventRoll < noteChance && !m_notes.isEmpty()) {
-        NoteData note = m_notes.takeFirst();
-        state.addNote(note);
-        addFoundNote(note);
-        state.addLog(QString("На полу найдена записка: \"%1\"").arg(note.content.left(30)));
-        emit noteFound(note);
-        return;
-    }
-
-    if (eventRoll < noteChance + itemChance) {
-        if (state.hasInventorySpace()) {
-            bool isSilverDoor = (door.type == DoorType::SILVER);
-            ItemType item = randomItem(isSilverDoor);  // Генерация случайного предмета
-            state.addItem(item);
-            state.addLog(QString(" Вы нашли: %1").arg(itemTypeToString(item)));
-        } else {
-            state.addLog(" Вы нашли ключ, но инвентарь полон!");
-        }
-        return;
-    }
-
-    if (eventRoll < noteChance + itemChance + riddleChance && !m_riddles.isEmpty()) {
-        RiddleData riddle = m_riddles.takeFirst();
-        m_currentRiddle = std::make_shared<RiddleData>(riddle);
-        state.setActiveRiddle(m_currentRiddle);
-
-        state.addLog("");
-        state.addLog("⚡ ПУТЬ ПРЕГРАЖДАЕТ ЗАГАДОЧНИК!");
-        state.addLog(QString("Загадка: %1").arg(m_currentRiddle->question));
-        state.addLog("");
-
-        emit riddleEncountered(riddle);
-        return;
-    }
+    return m_session.hasGameEnded(state);
 }
 
-
 QString GameEngine::getGeneratedRoomDescription(int locationId, int roomNumber)
 {
-    if (locationId < m_locations.size() && locationId >= 0) {
-        const LocationData& loc = m_locations[locationId];
-        return TextGenerator::generateRoomDescription(
-            locationId + 1,
-            roomNumber,
-            loc.name,
-            loc.theme
-        );
-    }
-    return "Вы входите в комнату...";
+    return m_session.getGeneratedRoomDescription(locationId, roomNumber);
 }
 
-void GameEngine::generateRoomDescription(GameState& state)
+void GameEngine::onRoomDescriptionGenerated(const QString& description)
 {
-    if (state.getCurrentLocationIndex() < m_locations.size()) {
-        const LocationData& loc = m_locations[state.getCurrentLocationIndex()];
-
-        QString description = TextGenerator::generateRoomDescription(
-            state.getCurrentLocationIndex() + 1,
-            state.getCurrentRoomIndex() + 1,
-            loc.name,
-            loc.theme
-        );
-
-        state.setRoomDescription(description);
+    emit roomDescriptionGenerated(description);
+}
 
-        QString imagePath = QString(":/assets/locations/location_%1.png").arg(state.getCurrentLocationIndex() + 1);
-        state.setLocationImagePath(imagePath);
+void GameEngine::onNoteFound(const NoteData& note)
+{
+    emit noteFound(note);
+}
 
-        startRoomDescriptionTypeWriter(description);
-    }
+void GameEngine::onRiddleEncountered(const RiddleData& riddle)
+{
+    emit riddleEncountered(riddle);
 }
 
-ItemType GameEngine::randomItem(bool isSilverDoor) const
+void GameEngine::onGameWon(int notesFound, int goldBars)
 {
-    double goldKeyChance = isSilverDoor ? 0.4 : 0.2;
-    return RandomGenerator::randomDouble() < goldKeyChance
-        ? ItemType::GOLD_KEY
-        : ItemType::SILVER_KEY;
+    emit gameWon(notesFound, goldBars);
 }
@@ -3,21 +3,31 @@
 #include <QObject>
 #include <QString>
 #include <QVector>
+#include <functional>
 #include <memory>
 #include "GameState.h"
+#include "GameSession.h"
+#include "GameJournal.h"
+#include "GameObserver.h"
+#include "BatchEngine.h"
 #include "Types.h"
-#include "../utils/TypeWriter.h"
 
 
-class DatabaseManager;
-class RiggleDIalog;
-class NotesDialog;
-class Location;
-class Item;
-class Riddle;
-class Note;
-
-class GameEngine : public QObject {
+class AsyncDatabase;
+class AutosaveWriter;
+class LogArchive;
+class MctsPlayer;
+class WorkStealingPool;
+
+/**
+ * @brief GameEngine - Qt front for a GameSession
+ *
+ * Loads content (the compiled pack, or the database on its worker threads
+ * without blocking this one), forwards player commands to the session
+ * and re-emits session events as signals. Presentation (the typewriter effect)
+ * lives in the UI and listens to roomDescriptionGenerated.
+ */
+class GameEngine : public QObject, public GameObserver {
     Q_OBJECT
 
 public:
@@ -26,11 +36,7 @@ public:
 
     void initializeGame();
 
-    void addFoundNote(const NoteData& note);
-    int getTotalNotesFound() const { return m_totalNotesFound; }
-
-    void startRoomDescriptionTypeWriter(const QString& text);
-    void skipCurrentTypeWriter();
+    int getTotalNotesFound() const { return m_session.getTotalNotesFound(); }
 
     GameState processMove(const GameState& currentState, int doorIndex);
 
@@ -39,41 +45,66 @@ public:
 
     QString getGeneratedRoomDescription(int locationId, int roomNumber);
 
-    const GameState& getCurrentState() const { return m_currentState; }
+    const GameState& getCurrentState() const { return m_session.getCurrentState(); }
+    GameSession& getSession() { return m_session; }
+
+    // Inputs of the current game, enough to reproduce it with GameJournal::replay
+    const GameJournal& getJournal() const { return m_journal; }
+    bool saveJournal(const QString& filePath) const;
+
+    /**
+     * @brief Load a recorded game and replay it against the database content
+     *
+     * Emits gameInitialized with the reconstructed state once the content is
+     * loaded; replay errors arrive through errorOccurred.
+     * @return false if the journal file cannot be read
+     */
+    bool replayJournal(const QString& filePath);
+
+    // Where the last played game is kept for bug reports
+    static QString defaultJournalPath();
 
 public slots:
     void onDoorSelected(int doorIndex);
     void handleRiddleAnswer(const QString& answer);
+
+    // Runs an MCTS search on the current state and emits hintReady
+    void requestHint();
 signals:
     void gameStateChanged(const GameState& newState);
     void errorOccurred(const QString& error);
     void gameInitialized(const GameState& initialState);
-    void typeWriterStarted(const QString& text);
-    void typeWriterFinished();
-    void roomDescriptionUpdated(const QString& description);
+    void roomDescriptionGenerated(const QString& description);
     void noteFound(const NoteData& note);
     void riddleEncountered(const RiddleData& riddle);
     void gameWon(int notesFound, int goldBars);
+    void hintReady(int doorIndex, double expectedGold);
+
+protected:
+    void onRoomDescriptionGenerated(const QString& description) override;
+    void onNoteFound(const NoteData& note) override;
+    void onRiddleEncountered(const RiddleData& riddle) override;
+    void onGameWon(int notesFound, int goldBars) override;
 
 private:
-    QVector<DoorData> generateDoors() const;
-    bool processKeyRequirement(GameState& state, const DoorData& door);
-    void handleLocationTransition(GameState& state);
-    void handleEventGeneration(GameState& state, const DoorData& door);
-    void generateRoomDescription(GameState& state);
-    ItemType randomItem(bool isSilverDoor = false) const;
-
-    void onTypeWriterCharacterAdded(const QString& text);
-    void onTypeWriterFinished();
-
-    std::unique_ptr<DatabaseManager> m_database;
-    std::unique_ptr<TypeWriter> m_typeWriter;
-    std::shared_ptr<RiddleData> m_currentRiddle;
-    QVector<LocationData> m_locations;
-    QVector<RiddleData> m_riddles;
-    QVector<NoteData> m_notes;
-    GameState m_currentState;
-    int m_moveCount = 0;
-    int m_movesRemaining;
-    int m_totalNotesFound = 0;
+    // Run ready with the shared catalog of the process: at once when it is
+    // already loaded or the pack maps, else after the database loads resolve
+    void withContent(std::function<void(const ContentCatalogPtr&)> ready);
+    ContentCatalogPtr openContentPack();
+    void startGame(const ContentCatalogPtr& content);
+
+    // Queue the current state for the background writer, started on first use
+    void autosave();
+
+    std::unique_ptr<AsyncDatabase> m_database;
+    QVector<std::function<void(const ContentCatalogPtr&)>> m_contentWaiters;
+    std::unique_ptr<AutosaveWriter> m_autosave;
+    std::unique_ptr<LogArchive> m_logArchive;
+    GameSession m_session;
+    GameJournal m_journal;
+
+    // Bot for hints, created on the first request of a game
+    BatchRules m_batchRules;
+    std::unique_ptr<WorkStealingPool> m_botPool;
+    std::unique_ptr<MctsPlayer> m_bot;
 };
@@ -0,0 +1,197 @@
+#include "GameJournal.h"
+#include "GameSession.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+namespace {
+
+const char Magic[3] = {'L', 'B', 'J'};
+
+void appendVarint(QByteArray& out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+// Reads one varint at pos, advancing it. False on truncated or oversized input
+bool readVarint(const QByteArray& in, int& pos, quint32& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= in.size()) {
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(in[pos++]);
+        value |= static_cast<quint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+void appendLittleEndian(QByteArray& out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void setError(QString* error, const QString& message)
+{
+    if (error) {
+        *error = message;
+    }
+}
+
+}
+
+void GameJournal::begin(quint64 seed, quint32 rulesFingerprint, quint32 contentFingerprint)
+{
+    m_seed = seed;
+    m_rulesFingerprint = rulesFingerprint;
+    m_contentFingerprint = contentFingerprint;
+    m_eventCount = 0;
+
+    m_data.clear();
+    m_data.reserve(256);
+    m_data.append(Magic, sizeof(Magic));
+    m_data.append(static_cast<char>(FormatVersion));
+    appendLittleEndian<quint32>(m_data, rulesFingerprint);
+    appendLittleEndian<quint32>(m_data, contentFingerprint);
+    appendLittleEndian<quint64>(m_data, seed);
+}
+
+void GameJournal::recordDoor(int doorIndex)
+{
+    // Invalid indices are recorded too, they still add a log line. Any
+    // out-of-range index replays the same way, so they are clamped to one
+    const quint32 invalid = 0x3FFFFFFF;
+    appendEvent(EventKind::Door, doorIndex < 0 ? invalid : qMin(static_cast<quint32>(doorIndex), invalid));
+}
+
+void GameJournal::recordAnswer(bool correct)
+{
+    appendEvent(EventKind::Answer, correct ? 1 : 0);
+}
+
+void GameJournal::appendEvent(EventKind kind, quint32 value)
+{
+    if (m_data.isEmpty()) {
+        return;
+    }
+    appendVarint(m_data, (value << 1) | static_cast<quint32>(kind));
+    m_eventCount++;
+}
+
+QVector<GameJournal::Event> GameJournal::events() const
+{
+    QVector<Event> result;
+    result.reserve(m_eventCount);
+
+    int pos = HeaderSize;
+    quint32 raw = 0;
+    while (pos < m_data.size() && readVarint(m_data, pos, raw)) {
+        result.append({static_cast<EventKind>(raw & 1), static_cast<int>(raw >> 1)});
+    }
+    return result;
+}
+
+bool GameJournal::fromData(const QByteArray& data, GameJournal& journal, QString* error)
+{
+    if (data.size() < HeaderSize || !data.startsWith(QByteArray(Magic, sizeof(Magic)))) {
+        setError(error, "Not a game journal");
+        return false;
+    }
+    if (static_cast<quint8>(data[3]) != FormatVersion) {
+        setError(error, QString("Unsupported journal version %1").arg(static_cast<quint8>(data[3])));
+        return false;
+    }
+
+    int count = 0;
+    int pos = HeaderSize;
+    quint32 raw = 0;
+    while (pos < data.size()) {
+        if (!readVarint(data, pos, raw)) {
+            setError(error, "Truncated journal event stream");
+            return false;
+        }
+        count++;
+    }
+
+    journal.m_data = data;
+    journal.m_rulesFingerprint = qFromLittleEndian<quint32>(data.constData() + 4);
+    journal.m_contentFingerprint = qFromLittleEndian<quint32>(data.constData() + 8);
+    journal.m_seed = qFromLittleEndian<quint64>(data.constData() + 12);
+    journal.m_eventCount = count;
+    return true;
+}
+
+bool GameJournal::save(const QString& filePath, QString* error) const
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+    file.write(m_data);
+    if (!file.commit()) {
+        setError(error, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+bool GameJournal::load(const QString& filePath, GameJournal& journal, QString* error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setError(error, file.errorString());
+        return false;
+    }
+    return fromData(file.readAll(), journal, error);
+}
+
+bool GameJournal::replay(GameSession& session,
+                         const ContentCatalogPtr& content,
+                         int maxEvents,
+                         QString* error) const
+{
+    if (m_data.isEmpty()) {
+        setError(error, "Empty journal");
+        return false;
+    }
+    if (session.getRules().fingerprint() != m_rulesFingerprint) {
+        setError(error, "Rules differ from the recorded game");
+        return false;
+    }
+    if (!content || content->fingerprint() != m_contentFingerprint) {
+        setError(error, "Content differs from the recorded game");
+        return false;
+    }
+
+    // Decoded up front: the session may be recording into this very journal
+    const QVector<Event> recorded = events();
+    const int count = maxEvents < 0 ? recorded.size() : qMin(maxEvents, recorded.size());
+
+    session.setSeed(m_seed);
+    if (!session.start(content)) {
+        setError(error, "No locations to replay");
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        const Event& event = recorded[i];
+        if (event.kind == EventKind::Door) {
+            session.chooseDoor(event.value);
+        } else {
+            session.resolveRiddle(event.value != 0);
+        }
+    }
+    return true;
+}
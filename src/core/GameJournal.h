@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "ContentCatalog.h"
+#include "Types.h"
+
+class GameSession;
+
+/**
+ * @brief GameJournal - Compact binary record of one game
+ *
+ * A game is fully determined by its content, rules, seed and the player's
+ * inputs, so that is all the journal keeps:
+ *
+ *   "LBJ" version:u8 rules:u32 content:u32 seed:u64   (little endian)
+ *   event*                                            (unsigned LEB128 varints)
+ *
+ * An event is (value << 1) | kind. A door choice stores the door index, a
+ * riddle answer stores only whether it was correct. A typical game is a few
+ * hundred bytes.
+ */
+class GameJournal {
+public:
+    enum class EventKind : quint8 {
+        Door = 0,
+        Answer = 1
+    };
+
+    struct Event {
+        EventKind kind;
+        int value;      // Door index, or 1/0 for a correct/wrong answer
+    };
+
+    static constexpr quint8 FormatVersion = 1;
+    static constexpr int HeaderSize = 3 + 1 + 4 + 4 + 8;
+
+    GameJournal() = default;
+
+    /**
+     * @brief Drop recorded events and start a new game
+     */
+    void begin(quint64 seed, quint32 rulesFingerprint, quint32 contentFingerprint);
+
+    void recordDoor(int doorIndex);
+    void recordAnswer(bool correct);
+
+    bool isEmpty() const { return m_data.isEmpty(); }
+    quint64 seed() const { return m_seed; }
+    quint32 rulesFingerprint() const { return m_rulesFingerprint; }
+    quint32 contentFingerprint() const { return m_contentFingerprint; }
+    int eventCount() const { return m_eventCount; }
+
+    // Decode the event stream
+    QVector<Event> events() const;
+
+    const QByteArray& data() const { return m_data; }
+
+    /**
+     * @brief Parse a serialized journal
+     * @return false if the header is invalid or the event stream is truncated
+     */
+    static bool fromData(const QByteArray& data, GameJournal& journal, QString* error = nullptr);
+
+    bool save(const QString& filePath, QString* error = nullptr) const;
+    static bool load(const QString& filePath, GameJournal& journal, QString* error = nullptr);
+
+    /**
+     * @brief Reconstruct the game on a session
+     *
+     * Seeds and starts the session with the given content, then applies the
+     * first maxEvents events (all of them if negative). The session keeps its
+     * rules; they must match the recorded fingerprint.
+     * @return false if the rules or content differ from the recording
+     */
+    bool replay(GameSession& session,
+                const ContentCatalogPtr& content,
+                int maxEvents = -1,
+                QString* error = nullptr) const;
+
+    static QString fileExtension() { return QStringLiteral("lbj"); }
+
+private:
+    void appendEvent(EventKind kind, quint32 value);
+
+    QByteArray m_data;
+    quint64 m_seed = 0;
+    quint32 m_rulesFingerprint = 0;
+    quint32 m_contentFingerprint = 0;
+    int m_eventCount = 0;
+};
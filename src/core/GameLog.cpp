@@ -0,0 +1,162 @@
+#include "GameLog.h"
+#include "Types.h"
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVector>
+
+namespace {
+
+struct StringPool {
+    QReadWriteLock lock;
+    QHash<QString, quint32> ids;
+    QVector<QString> strings{QString()};
+};
+
+StringPool& pool()
+{
+    static StringPool instance;
+    return instance;
+}
+
+}
+
+quint32 LogStrings::intern(const QString& text)
+{
+    if (text.isEmpty()) {
+        return 0;
+    }
+
+    StringPool& strings = pool();
+    {
+        QReadLocker locker(&strings.lock);
+        auto it = strings.ids.constFind(text);
+        if (it != strings.ids.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&strings.lock);
+    auto it = strings.ids.constFind(text);
+    if (it != strings.ids.constEnd()) {
+        return it.value();
+    }
+    // The pool outlives any content pack; pack strings are views of its mapping
+    const QString copy(text.constData(), text.size());
+    quint32 id = static_cast<quint32>(strings.strings.size());
+    strings.strings.append(copy);
+    strings.ids.insert(copy, id);
+    return id;
+}
+
+QString LogStrings::text(quint32 id)
+{
+    StringPool& strings = pool();
+    QReadLocker locker(&strings.lock);
+    return id < static_cast<quint32>(strings.strings.size()) ? strings.strings[id] : QString();
+}
+
+bool GameLog::append(const LogEntry& entry, LogEntry* evicted)
+{
+    LogEntry& slot = m_entries[m_total % Capacity];
+    const bool full = m_total >= Capacity;
+    if (full && evicted) {
+        *evicted = slot;
+    }
+    slot = entry;
+    ++m_total;
+    return full;
+}
+
+void GameLog::restore(const QVector<LogEntry>& entries, quint64 total)
+{
+    const qsizetype first = qMax<qsizetype>(0, entries.size() - Capacity);
+    const quint64 count = static_cast<quint64>(entries.size() - first);
+    // A partly filled ring cannot have seen more entries than it holds
+    m_total = count < static_cast<quint64>(Capacity) ? count : qMax(total, count);
+    m_entries = {};
+    for (quint64 i = 0; i < count; ++i) {
+        m_entries[(m_total - count + i) % Capacity] = entries[first + static_cast<qsizetype>(i)];
+    }
+}
+
+QStringList GameLog::lines() const
+{
+    QStringList result;
+    for (int i = 0; i < size(); ++i) {
+        result += format(at(i));
+    }
+    if (result.size() > LOG_MAX_LINES) {
+        result = result.mid(result.size() - LOG_MAX_LINES);
+    }
+    return result;
+}
+
+QStringList GameLog::format(const LogEntry& entry)
+{
+    switch (entry.message) {
+        case LogMessage::Blank:
+            return {""};
+        case LogMessage::Welcome:
+            return {"Добро пожаловать в Лабиринт!"};
+        case LogMessage::ChooseDoor:
+            return {"Выберите дверь, чтобы начать приключение."};
+        case LogMessage::InvalidDoor:
+            return {"ОШИБКА: Неверный выбор двери"};
+        case LogMessage::EnteredRoom:
+            return {QString("Вы вошли в комнату %1/10").arg(entry.value)};
+        case LogMessage::NormalDoorPassed:
+            return {"Вы прошли через обычную дверь."};
+        case LogMessage::SilverDoorLocked:
+            return {"⚠️ Дверь заперта! Нужен серебряный ключ."};
+        case LogMessage::SilverDoorOpened:
+            return {"🔑 Вы открыли серебряную дверь!"};
+        case LogMessage::GoldDoorLocked:
+            return {"⚠️ Дверь заперта! Нужен золотой ключ."};
+        case LogMessage::GoldDoorOpened:
+            return {"✨ Вы открыли золотую дверь!"};
+        case LogMessage::GoldBarsCount:
+            return {QString("💰 Золотых слитков: %1").arg(entry.value)};
+        case LogMessage::LocationCompleted:
+            return {
+                "",
+                "╔════════════════════════════════════════╗",
+                QString("║  ЛОКАЦИЯ ПРОЙДЕНА! Уровень %1 завершён  ║").arg(entry.value),
+                "╚════════════════════════════════════════╝",
+                ""
+            };
+        case LogMessage::NotesFoundCount:
+            return {QString("[*] Записок найдено: %1").arg(entry.value)};
+        case LogMessage::NoteFound:
+            return {QString("На полу найдена записка: \"%1\"").arg(LogStrings::text(entry.text).left(30))};
+        case LogMessage::ItemFound:
+            return {QString(" Вы нашли: %1").arg(itemTypeToString(static_cast<ItemType>(entry.value)))};
+        case LogMessage::ItemLostInventoryFull:
+            return {" Вы нашли ключ, но инвентарь полон!"};
+        case LogMessage::RiddleEncountered:
+            return {
+                "",
+                "⚡ ПУТЬ ПРЕГРАЖДАЕТ ЗАГАДОЧНИК!",
+                QString("Загадка: %1").arg(LogStrings::text(entry.text)),
+                ""
+            };
+        case LogMessage::RiddleSolved:
+            return {
+                "╔════════════════════════════════════════╗",
+                "║  ✓ ПРАВИЛЬНО! Загадка разгадана!      ║",
+                "╚════════════════════════════════════════╝"
+            };
+        case LogMessage::GoldKeyReceived:
+            return {"🗝️  Вы получили: Золотой ключ"};
+        case LogMessage::GoldKeyLostInventoryFull:
+            return {"⚠️  Инвентарь полон! Золотой ключ утерян."};
+        case LogMessage::RiddleFailed:
+            return {
+                "╔════════════════════════════════════════╗",
+                "║  ✗ НЕПРАВИЛЬНО!                       ║",
+                "╚════════════════════════════════════════╝"
+            };
+        case LogMessage::CorrectAnswer:
+            return {QString("Правильный ответ: %1").arg(LogStrings::text(entry.text))};
+    }
+    return {};
+}
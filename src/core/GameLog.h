@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+#include "Constants.h"
+
+/**
+ * @brief LogMessage - Template id of a game log line
+ *
+ * The text of each template lives in GameLog.cpp; banners expand to several
+ * lines when formatted.
+ */
+enum class LogMessage : quint16 {
+    Blank,
+    Welcome,
+    ChooseDoor,
+    InvalidDoor,
+    EnteredRoom,            // value: room number
+    NormalDoorPassed,
+    SilverDoorLocked,
+    SilverDoorOpened,
+    GoldDoorLocked,
+    GoldDoorOpened,
+    GoldBarsCount,          // value: gold bars
+    LocationCompleted,      // value: completed level
+    NotesFoundCount,        // value: notes found
+    NoteFound,              // text: note content
+    ItemFound,              // value: ItemType
+    ItemLostInventoryFull,
+    RiddleEncountered,      // text: question
+    RiddleSolved,
+    GoldKeyReceived,
+    GoldKeyLostInventoryFull,
+    RiddleFailed,
+    CorrectAnswer           // text: answer
+};
+
+/**
+ * @brief LogEntry - One log line as template id plus a small payload
+ *
+ * Trivially copyable; strings are referenced by LogStrings id.
+ */
+struct LogEntry {
+    LogMessage message = LogMessage::Blank;
+    qint32 value = 0;
+    quint32 text = 0;
+};
+
+/**
+ * @brief LogStrings - Process-wide intern pool for log string arguments
+ *
+ * Only content strings (notes, riddles, answers) are interned, so the pool
+ * is bounded by the content size. Id 0 is the empty string. Thread-safe.
+ */
+class LogStrings {
+public:
+    LogStrings() = delete;
+
+    static quint32 intern(const QString& text);
+    static QString text(quint32 id);
+};
+
+/**
+ * @brief GameLog - Fixed-capacity ring of the last LOG_MAX_LINES entries
+ *
+ * Entries are formatted only when rendered. Appending to a full log evicts
+ * the oldest entry; the caller decides whether it goes to a LogArchive.
+ */
+class GameLog {
+public:
+    static constexpr int Capacity = LOG_MAX_LINES;
+
+    int size() const { return static_cast<int>(qMin<quint64>(m_total, Capacity)); }
+    bool isEmpty() const { return m_total == 0; }
+    quint64 totalCount() const { return m_total; }
+
+    // 0 is the oldest retained entry
+    const LogEntry& at(int index) const { return m_entries[(m_total - size() + index) % Capacity]; }
+    const LogEntry& last() const { return m_entries[(m_total - 1) % Capacity]; }
+
+    /**
+     * @brief Append an entry
+     * @return true if the oldest entry was evicted (copied to *evicted)
+     */
+    bool append(const LogEntry& entry, LogEntry* evicted = nullptr);
+
+    /**
+     * @brief Replace the log with saved entries, oldest first
+     * @param total Entries ever appended; kept if larger than entries.size()
+     */
+    void restore(const QVector<LogEntry>& entries, quint64 total);
+
+    /**
+     * @brief Format the retained entries, at most LOG_MAX_LINES lines
+     */
+    QStringList lines() const;
+
+    static QStringList format(const LogEntry& entry);
+
+private:
+    std::array<LogEntry, Capacity> m_entries{};
+    quint64 m_total = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QString>
+#include "Types.h"
+
+/**
+ * @brief GameObserver - Optional receiver for events raised by GameSession
+ *
+ * Every callback is a no-op by default, so batch tools can run a session
+ * without any observer and pay nothing for presentation.
+ */
+class GameObserver {
+public:
+    virtual ~GameObserver() = default;
+
+    virtual void onRoomDescriptionGenerated(const QString& description) { Q_UNUSED(description); }
+    virtual void onNoteFound(const NoteData& note) { Q_UNUSED(note); }
+    virtual void onRiddleEncountered(const RiddleData& riddle) { Q_UNUSED(riddle); }
+    virtual void onGameWon(int notesFound, int goldBars) { Q_UNUSED(notesFound); Q_UNUSED(goldBars); }
+};
@@ -0,0 +1,115 @@
+#include "GameRules.h"
+#include <cmath>
+
+namespace {
+
+bool isChance(double p)
+{
+    return p >= 0.0 && p <= 1.0;
+}
+
+// Door counts are whole numbers; 2.5 is a typo, not a rounding request
+bool isDoorCount(double value)
+{
+    return value == std::floor(value) && value >= 0 && value <= DOOR_LIMIT;
+}
+
+bool assign(GameRules& rules, const QString& name, double value)
+{
+    if (name == "minDoors" || name == "maxDoors") {
+        if (!isDoorCount(value)) {
+            return false;
+        }
+        (name == "minDoors" ? rules.minDoors : rules.maxDoors) = static_cast<int>(value);
+        return true;
+    }
+    if (name == "doorSilverChance") { rules.doorSilverChance = value; return true; }
+    if (name == "doorGoldChance") { rules.doorGoldChance = value; return true; }
+    if (name == "noteChance") { rules.noteChance = value; return true; }
+    if (name == "itemChance") { rules.itemChance = value; return true; }
+    if (name == "riddleChance") { rules.riddleChance = value; return true; }
+    if (name == "silverDoorItemBonus") { rules.silverDoorItemBonus = value; return true; }
+    if (name == "silverDoorRiddleBonus") { rules.silverDoorRiddleBonus = value; return true; }
+    if (name == "goldKeyChance") { rules.goldKeyChance = value; return true; }
+    if (name == "silverDoorGoldKeyChance") { rules.silverDoorGoldKeyChance = value; return true; }
+    return false;
+}
+
+}
+
+bool GameRules::set(const QString& name, double value)
+{
+    GameRules changed = *this;
+    if (!assign(changed, name, value) || !changed.isValid()) {
+        return false;
+    }
+    *this = changed;
+    return true;
+}
+
+bool GameRules::isValid() const
+{
+    if (minDoors < 1 || minDoors > maxDoors || maxDoors > DOOR_LIMIT) {
+        return false;
+    }
+
+    // Bands are cumulative: past 1 the later outcomes would silently never happen
+    const double silverItem = itemChance + silverDoorItemBonus;
+    const double silverRiddle = riddleChance + silverDoorRiddleBonus;
+    return isChance(doorSilverChance) && isChance(doorGoldChance) && isChance(doorSilverChance + doorGoldChance)
+        && isChance(noteChance) && isChance(itemChance) && isChance(riddleChance)
+        && isChance(silverItem) && isChance(silverRiddle)
+        && isChance(noteChance + itemChance + riddleChance)
+        && isChance(noteChance + silverItem + silverRiddle)
+        && isChance(goldKeyChance) && isChance(silverDoorGoldKeyChance);
+}
+
+QStringList GameRules::names()
+{
+    return {
+        "minDoors", "maxDoors", "doorSilverChance", "doorGoldChance",
+        "noteChance", "itemChance", "riddleChance",
+        "silverDoorItemBonus", "silverDoorRiddleBonus",
+        "goldKeyChance", "silverDoorGoldKeyChance"
+    };
+}
+
+quint32 GameRules::fingerprint() const
+{
+    const RuleThresholds t = thresholds();
+    const quint32 values[] = {
+        static_cast<quint32>(minDoors), static_cast<quint32>(maxDoors),
+        t.doorSilver.threshold, t.doorSilverOrGold.threshold,
+        t.note[0].threshold, t.noteOrItem[0].threshold, t.noteItemOrRiddle[0].threshold,
+        t.note[1].threshold, t.noteOrItem[1].threshold, t.noteItemOrRiddle[1].threshold,
+        t.goldKey[0].threshold, t.goldKey[1].threshold
+    };
+
+    quint32 hash = 2166136261u;
+    for (quint32 value : values) {
+        for (int i = 0; i < 4; ++i) {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+RuleThresholds GameRules::thresholds() const
+{
+    RuleThresholds t;
+    t.doorSilver = Probability::fromDouble(doorSilverChance);
+    t.doorSilverOrGold = Probability::fromDouble(doorSilverChance + doorGoldChance);
+
+    for (int silver = 0; silver < 2; ++silver) {
+        const double item = itemChance + (silver ? silverDoorItemBonus : 0.0);
+        const double riddle = riddleChance + (silver ? silverDoorRiddleBonus : 0.0);
+        t.note[silver] = Probability::fromDouble(noteChance);
+        t.noteOrItem[silver] = Probability::fromDouble(noteChance + item);
+        t.noteItemOrRiddle[silver] = Probability::fromDouble(noteChance + item + riddle);
+    }
+
+    t.goldKey[0] = Probability::fromDouble(goldKeyChance);
+    t.goldKey[1] = Probability::fromDouble(silverDoorGoldKeyChance);
+    return t;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include "Constants.h"
+#include "../utils/RandomGenerator.h"
+
+/**
+ * @brief RuleThresholds - GameRules compiled to cumulative 32-bit roll thresholds
+ *
+ * A single next32() draw is compared against these, so rolls are integer-only
+ * and reproducible bit for bit.
+ */
+struct RuleThresholds {
+    Probability doorSilver;             // roll < doorSilver -> silver door
+    Probability doorSilverOrGold;       // roll < doorSilverOrGold -> gold door
+
+    // Event bands for a normal first door and for a silver first door
+    Probability note[2];
+    Probability noteOrItem[2];
+    Probability noteItemOrRiddle[2];
+
+    Probability goldKey[2];             // found key is gold: [normal, silver door]
+};
+
+/**
+ * @brief GameRules - Tunable probabilities used by GameSession
+ *
+ * Defaults come from Constants.h. Tools can override single values by name
+ * (see set()) to try a balance change without rebuilding.
+ */
+struct GameRules {
+    int minDoors = MIN_DOORS;
+    int maxDoors = MAX_DOORS;
+    double doorSilverChance = DOOR_SILVER_CHANCE;
+    double doorGoldChance = DOOR_GOLD_CHANCE;
+
+    double noteChance = EVENT_NOTE_CHANCE;
+    double itemChance = EVENT_ITEM_CHANCE;
+    double riddleChance = EVENT_RIDDLE_CHANCE;
+    double silverDoorItemBonus = SILVER_DOOR_ITEM_BONUS;
+    double silverDoorRiddleBonus = SILVER_DOOR_RIDDLE_BONUS;
+
+    double goldKeyChance = GOLD_KEY_CHANCE;
+    double silverDoorGoldKeyChance = SILVER_DOOR_GOLD_KEY_CHANCE;
+
+    /**
+     * @brief Override a rule by its field name
+     * @return false if the name is unknown or the rules would not be valid;
+     *         the rules are left unchanged then
+     */
+    bool set(const QString& name, double value);
+
+    // 1 <= minDoors <= maxDoors <= DOOR_LIMIT, and every chance and every
+    // band thresholds() adds up lies in [0, 1]
+    bool isValid() const;
+
+    RuleThresholds thresholds() const;
+
+    // Hash of the compiled rules, stored in journals to detect rule changes
+    quint32 fingerprint() const;
+
+    static QStringList names();
+};
@@ -0,0 +1,397 @@
+#include "GameSession.h"
+#include "GameObserver.h"
+#include "GameJournal.h"
+#include "PackedGameState.h"
+#include "LogArchive.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/TextGenerator.h"
+#include "Constants.h"
+
+namespace {
+
+// Deck streams of the session seed; separate from m_rng so dealing content
+// never shifts the rule outcomes
+constexpr quint64 RiddleDeckStream = 0x7269646C;
+constexpr quint64 NoteDeckStream = 0x6E6F7465;
+
+}
+
+GameSession::GameSession()
+    : m_thresholds(m_rules.thresholds())
+    , m_seed(RandomGenerator::entropySeed())
+{
+}
+
+GameSession::~GameSession() = default;
+
+bool GameSession::start(ContentCatalogPtr content)
+{
+    m_content = std::move(content);
+    m_currentRiddle = nullptr;
+    m_totalNotesFound = 0;
+    m_stats = SessionStats();
+    m_locationOrder.clear();
+
+    if (!m_content) {
+        return false;
+    }
+
+    if (m_journal) {
+        m_journal->begin(m_seed, m_rules.fingerprint(), m_content->fingerprint());
+    }
+
+    m_riddleDeck = ShuffledDeck(m_content->riddles().size(), RandomGenerator::deriveSeed(m_seed, RiddleDeckStream));
+    m_noteDeck = ShuffledDeck(m_content->notes().size(), RandomGenerator::deriveSeed(m_seed, NoteDeckStream));
+
+    m_rng.seed(m_seed);
+    m_flavorRng = m_rng;
+    m_flavorRng.jump();
+
+    const int locationCount = m_content->locations().size();
+    m_locationOrder.resize(locationCount);
+    for (int i = 0; i < locationCount; ++i) {
+        m_locationOrder[i] = i;
+    }
+    if (locationCount > 1) {
+        for (int i = locationCount - 1; i > 0; --i) {
+            int j = m_rng.random(0, i - 1);
+            std::swap(m_locationOrder[i], m_locationOrder[j]);
+        }
+    }
+
+    if (m_locationOrder.isEmpty()) {
+        return false;
+    }
+
+    m_currentState = GameState();
+    m_currentState.setCurrentLocationIndex(0)
+                   .setCurrentRoomIndex(0)
+                   .setGoldBars(0)
+                   .setGameOver(false)
+                   .setGameWon(false);
+
+    addLog(m_currentState, LogMessage::Welcome);
+    addLog(m_currentState, LogMessage::ChooseDoor);
+
+    m_currentState.setCurrentDoors(generateDoors());
+    generateRoomDescription(m_currentState);
+    return true;
+}
+
+void GameSession::setRules(const GameRules& rules)
+{
+    m_rules = rules;
+    m_thresholds = rules.thresholds();
+}
+
+void GameSession::chooseDoor(int doorIndex)
+{
+    if (m_journal) {
+        m_journal->recordDoor(doorIndex);
+    }
+    m_currentState = processMove(m_currentState, doorIndex);
+}
+
+void GameSession::addFoundNote(const NoteData& note, GameState& state)
+{
+    Q_UNUSED(note);
+    m_totalNotesFound++;
+    addLog(state, LogMessage::NotesFoundCount, m_totalNotesFound);
+}
+
+void GameSession::addLog(GameState& state, LogMessage message, int value, quint32 text)
+{
+    LogEntry evicted;
+    if (state.addLog({message, value, text}, &evicted) && m_logArchive) {
+        m_logArchive->append(evicted);
+    }
+}
+
+GameState GameSession::processMove(const GameState& currentState, int doorIndex)
+{
+    if (currentState.isGameOver()) {
+        return currentState;
+    }
+    GameState newState = currentState;
+    newState.setLoading(true);
+
+    if (doorIndex < 0 || doorIndex >= newState.getCurrentDoors().size()) {
+        addLog(newState, LogMessage::InvalidDoor);
+        newState.setLoading(false);
+        return newState;
+    }
+
+    const DoorData& door = newState.getCurrentDoors()[doorIndex];
+
+    if (!processKeyRequirement(newState, door)) {
+        m_stats.lockedDoorAttempts++;
+        newState.setLoading(false);
+        return newState;
+    }
+
+    m_stats.moves++;
+
+    int newRoomIndex = newState.getCurrentRoomIndex() + 1;
+    newState.setCurrentRoomIndex(newRoomIndex);
+    addLog(newState, LogMessage::EnteredRoom, newRoomIndex);
+
+    if (newRoomIndex >= MOVES_PER_LOCATION) {
+        handleLocationTransition(newState);
+        newState.setCurrentDoors(generateDoors());
+        generateRoomDescription(newState);
+        handleEventGeneration(newState, newState.getCurrentDoors().first());
+
+        newState.setLoading(false);
+        return newState;
+    }
+
+    if (checkWinCondition(newState)) {
+        newState.setGameWon(true);
+        newState.setGameOver(true);
+        if (m_observer) {
+            m_observer->onGameWon(m_totalNotesFound, newState.getGoldBars());
+        }
+        return newState;
+    }
+
+    if (newRoomIndex < MOVES_PER_LOCATION) {
+        auto doors = generateDoors();
+        newState.setCurrentDoors(doors);
+
+        if (!doors.isEmpty()) {
+            handleEventGeneration(newState, doors.first());
+
+            if (newState.hasActiveRiddle()) {
+                newState.setLoading(false);
+                return newState;
+            }
+        }
+
+        generateRoomDescription(newState);
+    }
+
+    newState.setLoading(false);
+    return newState;
+}
+
+bool GameSession::answerRiddle(const QString& answer)
+{
+    if (!m_currentRiddle) {
+        return false;
+    }
+
+    QString normalizedAnswer = answer.toLower().trimmed();
+    QString correctAnswer = m_currentRiddle->answer.toLower().trimmed();
+
+    return resolveRiddle(normalizedAnswer == correctAnswer);
+}
+
+bool GameSession::resolveRiddle(bool correct)
+{
+    if (!m_currentRiddle) {
+        return false;
+    }
+    if (m_journal) {
+        m_journal->recordAnswer(correct);
+    }
+
+    GameState& state = m_currentState;
+
+    if (correct) {
+        m_stats.riddlesSolved++;
+        m_stats.keysFound++;
+        addLog(state, LogMessage::RiddleSolved);
+
+        if (state.hasInventorySpace()) {
+            state.addItem(ItemType::GOLD_KEY);
+            addLog(state, LogMessage::GoldKeyReceived);
+        } else {
+            m_stats.keysWasted++;
+            addLog(state, LogMessage::GoldKeyLostInventoryFull);
+        }
+    } else {
+        addLog(state, LogMessage::RiddleFailed);
+        addLog(state, LogMessage::CorrectAnswer, 0, LogStrings::intern(m_currentRiddle->answer));
+    }
+
+    state.setActiveRiddleId(NoContent);
+    m_currentRiddle = nullptr;
+
+    generateRoomDescription(state);
+    return true;
+}
+
+bool GameSession::checkWinCondition(const GameState& state) const
+{
+    return state.getCurrentLocationIndex() >= m_locationOrder.size();
+}
+
+bool GameSession::hasGameEnded(const GameState& state) const
+{
+    return state.isGameOver();
+}
+
+QVector<DoorData> GameSession::generateDoors()
+{
+    QVector<DoorData> doors;
+    int doorCount = m_rng.random(m_rules.minDoors, m_rules.maxDoors);
+    doors.append(PackedGameState::doorData(PackedGameState::WoodenDoor));
+
+    for (int i = 1; i < doorCount; ++i) {
+        quint32 roll = m_rng.next32();
+        PackedGameState::DoorCode code;
+
+        if (roll < m_thresholds.doorSilver.threshold) {
+            code = PackedGameState::SilverDoor;
+        } else if (roll < m_thresholds.doorSilverOrGold.threshold) {
+            code = PackedGameState::GoldDoor;
+        } else {
+            code = PackedGameState::NormalDoor;
+        }
+
+        doors.append(PackedGameState::doorData(code));
+    }
+
+    if (doors.size() > 1) {
+        for (int i = doors.size() - 1; i > 0; --i) {
+            int j = m_rng.random(0, i - 1);
+            std::swap(doors[i], doors[j]);
+        }
+    }
+    return doors;
+}
+
+bool GameSession::processKeyRequirement(GameState& state, const DoorData& door)
+{
+    if (door.type == DoorType::SILVER) {
+        if (!state.hasItem(ItemType::SILVER_KEY)) {
+            addLog(state, LogMessage::SilverDoorLocked);
+            return false;
+        }
+        state.removeItem(ItemType::SILVER_KEY);
+        addLog(state, LogMessage::SilverDoorOpened);
+        return true;
+    }
+
+    if (door.type == DoorType::GOLD) {
+        if (!state.hasItem(ItemType::GOLD_KEY)) {
+            addLog(state, LogMessage::GoldDoorLocked);
+            return false;
+        }
+        state.removeItem(ItemType::GOLD_KEY);
+        addLog(state, LogMessage::GoldDoorOpened);
+        state.setGoldBars(state.getGoldBars() + 1);
+        addLog(state, LogMessage::GoldBarsCount, state.getGoldBars());
+        return true;
+    }
+
+    addLog(state, LogMessage::NormalDoorPassed);
+    return true;
+}
+
+void GameSession::handleLocationTransition(GameState& state)
+{
+    int nextLocation = state.getCurrentLocationIndex() + 1;
+    state.setCurrentLocationIndex(nextLocation);
+    state.setCurrentRoomIndex(0);
+    addLog(state, LogMessage::LocationCompleted, nextLocation);
+}
+
+void GameSession::handleEventGeneration(GameState& state, const DoorData& door)
+{
+    quint32 eventRoll = m_rng.next32();
+    const int band = door.type == DoorType::SILVER ? 1 : 0;
+
+    const QVector<NoteData>& notes = m_content->notes();
+    if (eventRoll < m_thresholds.note[band].threshold && !m_noteDeck.isEmpty()) {
+        const NoteData& note = notes[m_noteDeck.draw()];
+        m_stats.notesFound++;
+        state.addNote(note.id);
+        addFoundNote(note, state);
+        addLog(state, LogMessage::NoteFound, 0, LogStrings::intern(note.content));
+        if (m_observer) {
+            m_observer->onNoteFound(note);
+        }
+        return;
+    }
+
+    if (eventRoll < m_thresholds.noteOrItem[band].threshold) {
+        m_stats.keysFound++;
+        if (state.hasInventorySpace()) {
+            bool isSilverDoor = (door.type == DoorType::SILVER);
+            ItemType item = randomItem(isSilverDoor);  // Генерация случайного предмета
+            state.addItem(item);
+            addLog(state, LogMessage::ItemFound, static_cast<int>(item));
+        } else {
+            m_stats.keysWasted++;
+            addLog(state, LogMessage::ItemLostInventoryFull);
+        }
+        return;
+    }
+
+    const QVector<RiddleData>& riddles = m_content->riddles();
+    if (eventRoll < m_thresholds.noteItemOrRiddle[band].threshold && !m_riddleDeck.isEmpty()) {
+        const RiddleData& riddle = riddles[m_riddleDeck.draw()];
+        m_stats.riddlesEncountered++;
+        m_currentRiddle = &riddle;
+        state.setActiveRiddleId(riddle.id);
+
+        addLog(state, LogMessage::RiddleEncountered, 0, LogStrings::intern(m_currentRiddle->question));
+
+        if (m_observer) {
+            m_observer->onRiddleEncountered(riddle);
+        }
+        return;
+    }
+}
+
+QString GameSession::getGeneratedRoomDescription(int locationId, int roomNumber)
+{
+    if (const LocationData* loc = locationAt(locationId)) {
+        return TextGenerator::generateRoomDescription(
+            m_flavorRng,
+            locationId + 1,
+            roomNumber,
+            loc->name,
+            loc->theme
+        );
+    }
+    return "Вы входите в комнату...";
+}
+
+void GameSession::generateRoomDescription(GameState& state)
+{
+    if (const LocationData* loc = locationAt(state.getCurrentLocationIndex())) {
+        QString description = TextGenerator::generateRoomDescription(
+            m_flavorRng,
+            state.getCurrentLocationIndex() + 1,
+            state.getCurrentRoomIndex() + 1,
+            loc->name,
+            loc->theme
+        );
+
+        state.setRoomDescription(description);
+
+        QString imagePath = QString(":/assets/locations/location_%1.png").arg(state.getCurrentLocationIndex() + 1);
+        state.setLocationImagePath(imagePath);
+
+        if (m_observer) {
+            m_observer->onRoomDescriptionGenerated(description);
+        }
+    }
+}
+
+const LocationData* GameSession::locationAt(int index) const
+{
+    if (index < 0 || index >= m_locationOrder.size()) {
+        return nullptr;
+    }
+    return &m_content->locations()[m_locationOrder[index]];
+}
+
+ItemType GameSession::randomItem(bool isSilverDoor)
+{
+    return m_rng.roll(m_thresholds.goldKey[isSilverDoor ? 1 : 0])
+        ? ItemType::GOLD_KEY
+        : ItemType::SILVER_KEY;
+}
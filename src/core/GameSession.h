@@ -0,0 +1,131 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "ContentCatalog.h"
+#include "GameState.h"
+#include "GameRules.h"
+#include "Types.h"
+#include "../utils/RandomGenerator.h"
+#include "../utils/ShuffledDeck.h"
+
+class GameObserver;
+class GameJournal;
+class LogArchive;
+
+/**
+ * @brief SessionStats - Counters collected while a session is played
+ */
+struct SessionStats {
+    int moves = 0;
+    int lockedDoorAttempts = 0;
+    int notesFound = 0;
+    int riddlesEncountered = 0;
+    int riddlesSolved = 0;
+    int keysFound = 0;      // In rooms and as riddle rewards
+    int keysWasted = 0;     // Of those, lost because the inventory was full
+};
+
+/**
+ * @brief GameSession - Headless game rules for a single player
+ *
+ * Owns the current state of one game and a reference to the shared content
+ * catalog; riddles and notes are dealt from seeded decks over it, never copied.
+ * Has no QObject, timer or widget dependencies; presentation hooks go
+ * through an optional GameObserver.
+ */
+class GameSession {
+public:
+    GameSession();
+    ~GameSession();
+
+    /**
+     * @brief Start a new game with the given content
+     *
+     * Both random streams are reseeded from getSeed(), so a game is fully
+     * determined by content, rules, seed and the player's choices.
+     * @return false if the catalog is missing or has no locations
+     */
+    bool start(ContentCatalogPtr content);
+    const ContentCatalogPtr& getContent() const { return m_content; }
+
+    void setObserver(GameObserver* observer) { m_observer = observer; }
+    GameObserver* getObserver() const { return m_observer; }
+
+    // Entries pushed out of the bounded log go here; nullptr drops them
+    void setLogArchive(LogArchive* archive) { m_logArchive = archive; }
+
+    // Records the seed and every player input from the next start(); nullptr stops recording
+    void setJournal(GameJournal* journal) { m_journal = journal; }
+    GameJournal* getJournal() const { return m_journal; }
+
+    void setRules(const GameRules& rules);
+    const GameRules& getRules() const { return m_rules; }
+
+    // Seed used by the next start(); defaults to an entropy seed
+    void setSeed(quint64 seed) { m_seed = seed; }
+    quint64 getSeed() const { return m_seed; }
+
+    // Catalog order of the notes and riddles of the current game
+    const ShuffledDeck& getNoteDeck() const { return m_noteDeck; }
+    const ShuffledDeck& getRiddleDeck() const { return m_riddleDeck; }
+
+    // Advances the random streams but not the current state or the journal
+    GameState processMove(const GameState& currentState, int doorIndex);
+
+    /**
+     * @brief Apply a door choice to the current state
+     */
+    void chooseDoor(int doorIndex);
+
+    /**
+     * @brief Answer the active riddle
+     * @return false if there is no active riddle
+     */
+    bool answerRiddle(const QString& answer);
+
+    /**
+     * @brief Resolve the active riddle without answer text (replays, simulation)
+     * @return false if there is no active riddle
+     */
+    bool resolveRiddle(bool correct);
+
+    bool hasActiveRiddle() const { return m_currentRiddle != nullptr; }
+    bool checkWinCondition(const GameState& state) const;
+    bool hasGameEnded(const GameState& state) const;
+
+    QString getGeneratedRoomDescription(int locationId, int roomNumber);
+
+    int getTotalNotesFound() const { return m_totalNotesFound; }
+    const SessionStats& getStats() const { return m_stats; }
+    const GameState& getCurrentState() const { return m_currentState; }
+
+private:
+    QVector<DoorData> generateDoors();
+    bool processKeyRequirement(GameState& state, const DoorData& door);
+    void handleLocationTransition(GameState& state);
+    void handleEventGeneration(GameState& state, const DoorData& door);
+    void generateRoomDescription(GameState& state);
+    void addFoundNote(const NoteData& note, GameState& state);
+    ItemType randomItem(bool isSilverDoor = false);
+    void addLog(GameState& state, LogMessage message, int value = 0, quint32 text = 0);
+    const LocationData* locationAt(int index) const;
+
+    GameObserver* m_observer = nullptr;
+    LogArchive* m_logArchive = nullptr;
+    GameJournal* m_journal = nullptr;
+    GameRules m_rules;
+    RuleThresholds m_thresholds;
+    quint64 m_seed = 0;
+    RandomGenerator m_rng;          // Rule outcomes
+    RandomGenerator m_flavorRng;    // Room descriptions, never affects rules
+    SessionStats m_stats;
+    ContentCatalogPtr m_content;
+    QVector<int> m_locationOrder;   // Catalog indices in the order of this game
+    ShuffledDeck m_riddleDeck;
+    ShuffledDeck m_noteDeck;
+    const RiddleData* m_currentRiddle = nullptr;     // Points into m_content
+    GameState m_currentState;
+    int m_totalNotesFound = 0;
+};
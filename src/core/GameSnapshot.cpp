@@ -0,0 +1,306 @@
+#include "GameSnapshot.h"
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QHash>
+#include <climits>
+
+/*
+ * Layout, one CBOR array:
+ *   version, location, room, gold bars, notes found, flags, active riddle,
+ *   [inventory], [note ids], [door type, door text, ...],
+ *   room description, location image, log total, log size, log section
+ *
+ * The log section is a byte string holding its own CBOR array:
+ *   [text, ...], [message, value, text index, ...]
+ * Text index 0 is no text; 1 is the first string of the table.
+ */
+
+namespace {
+
+enum Flag : qint64 {
+    GameOverFlag = 1,
+    GameWonFlag = 2,
+    LoadingFlag = 4
+};
+
+constexpr int LastLogMessage = static_cast<int>(LogMessage::CorrectAnswer);
+
+QByteArray encodeLog(const GameLog& log)
+{
+    QVector<quint32> textIds;
+    QHash<quint32, qint64> textIndex;
+    for (int i = 0; i < log.size(); ++i) {
+        const quint32 text = log.at(i).text;
+        if (text != 0 && !textIndex.contains(text)) {
+            textIds.append(text);
+            textIndex.insert(text, textIds.size());
+        }
+    }
+
+    QByteArray section;
+    QCborStreamWriter writer(&section);
+    writer.startArray(2);
+    writer.startArray(textIds.size());
+    for (quint32 text : textIds) {
+        writer.append(LogStrings::text(text));
+    }
+    writer.endArray();
+    writer.startArray(3 * static_cast<quint64>(log.size()));
+    for (int i = 0; i < log.size(); ++i) {
+        const LogEntry& entry = log.at(i);
+        writer.append(static_cast<qint64>(entry.message));
+        writer.append(static_cast<qint64>(entry.value));
+        writer.append(entry.text != 0 ? textIndex.value(entry.text) : qint64(0));
+    }
+    writer.endArray();
+    writer.endArray();
+    return section;
+}
+
+bool readInteger(QCborStreamReader& reader, qint64& value)
+{
+    if (!reader.isInteger()) {
+        return false;
+    }
+    value = reader.toInteger();
+    return reader.next();
+}
+
+bool readInt(QCborStreamReader& reader, int& value, qint64 min = 0, qint64 max = INT_MAX)
+{
+    qint64 wide = 0;
+    if (!readInteger(reader, wide) || wide < min || wide > max) {
+        return false;
+    }
+    value = static_cast<int>(wide);
+    return true;
+}
+
+// Strings are read chunk by chunk: readAllString() only exists since Qt 6.7
+bool readString(QCborStreamReader& reader, QString& value)
+{
+    if (!reader.isString()) {
+        return false;
+    }
+    value.clear();
+    QCborStreamReader::StringResult<QString> chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        value += chunk.data;
+        chunk = reader.readString();
+    }
+    return chunk.status == QCborStreamReader::EndOfString;
+}
+
+bool readByteArray(QCborStreamReader& reader, QByteArray& value)
+{
+    if (!reader.isByteArray()) {
+        return false;
+    }
+    value.clear();
+    QCborStreamReader::StringResult<QByteArray> chunk = reader.readByteArray();
+    while (chunk.status == QCborStreamReader::Ok) {
+        value += chunk.data;
+        chunk = reader.readByteArray();
+    }
+    return chunk.status == QCborStreamReader::EndOfString;
+}
+
+// Array of integers appended through `add`; false on anything else
+template <typename Add>
+bool readIntArray(QCborStreamReader& reader, Add add)
+{
+    if (!reader.isArray() || !reader.enterContainer()) {
+        return false;
+    }
+    while (reader.hasNext()) {
+        int value = 0;
+        if (!readInt(reader, value, INT_MIN) || !add(value)) {
+            return false;
+        }
+    }
+    return reader.leaveContainer();
+}
+
+}
+
+QByteArray GameSnapshot::encode(const GameState& state)
+{
+    QByteArray data;
+    QCborStreamWriter writer(&data);
+    writer.startArray(15);
+    writer.append(qint64(Version));
+    writer.append(static_cast<qint64>(state.getCurrentLocationIndex()));
+    writer.append(static_cast<qint64>(state.getCurrentRoomIndex()));
+    writer.append(static_cast<qint64>(state.getGoldBars()));
+    writer.append(static_cast<qint64>(state.getNotesFound()));
+    writer.append(static_cast<qint64>((state.isGameOver() ? GameOverFlag : 0)
+                                      | (state.isGameWon() ? GameWonFlag : 0)
+                                      | (state.isLoading() ? LoadingFlag : 0)));
+    writer.append(static_cast<qint64>(state.getActiveRiddleId()));
+
+    writer.startArray(state.getInventory().size());
+    for (ItemType item : state.getInventory()) {
+        writer.append(static_cast<qint64>(item));
+    }
+    writer.endArray();
+
+    const PersistentVector<ContentId>& notes = state.getNoteIds();
+    writer.startArray(notes.size());
+    for (int i = 0; i < notes.size(); ++i) {
+        writer.append(static_cast<qint64>(notes.at(i)));
+    }
+    writer.endArray();
+
+    writer.startArray(2 * static_cast<quint64>(state.getCurrentDoors().size()));
+    for (const DoorData& door : state.getCurrentDoors()) {
+        writer.append(static_cast<qint64>(door.type));
+        writer.append(door.description);
+    }
+    writer.endArray();
+
+    writer.append(state.getRoomDescription());
+    writer.append(state.getLocationImagePath());
+    writer.append(static_cast<quint64>(state.getLog().totalCount()));
+    writer.append(static_cast<qint64>(state.getLog().size()));
+    writer.append(encodeLog(state.getLog()));
+    writer.endArray();
+    return data;
+}
+
+bool GameSnapshot::read(const QByteArray& data, GameSnapshot& snapshot)
+{
+    QCborStreamReader reader(data);
+    int version = 0;
+    if (!reader.isArray() || !reader.enterContainer()
+        || !readInt(reader, version) || version < 1 || version > Version) {
+        return false;
+    }
+
+    int location = 0;
+    int room = 0;
+    int goldBars = 0;
+    int notesFound = 0;
+    int flags = 0;
+    int riddleId = 0;
+    if (!readInt(reader, location) || !readInt(reader, room) || !readInt(reader, goldBars)
+        || !readInt(reader, notesFound) || !readInt(reader, flags)
+        || !readInt(reader, riddleId, NoContent)) {
+        return false;
+    }
+
+    QVector<ItemType> inventory;
+    QVector<ContentId> noteIds;
+    const bool arraysOk =
+        readIntArray(reader, [&](int item) {
+            if (item > static_cast<int>(ItemType::GOLD_KEY) || item < 0) {
+                return false;
+            }
+            inventory.append(static_cast<ItemType>(item));
+            return inventory.size() <= MAX_INVENTORY_SIZE;
+        })
+        && readIntArray(reader, [&](int id) {
+            noteIds.append(id);
+            return true;
+        });
+    if (!arraysOk) {
+        return false;
+    }
+
+    QVector<DoorData> doors;
+    if (!reader.isArray() || !reader.enterContainer()) {
+        return false;
+    }
+    while (reader.hasNext()) {
+        DoorData door;
+        int type = 0;
+        if (!readInt(reader, type, 0, static_cast<int>(DoorType::GOLD)) || !readString(reader, door.description)) {
+            return false;
+        }
+        door.type = static_cast<DoorType>(type);
+        doors.append(door);
+    }
+    if (!reader.leaveContainer()) {
+        return false;
+    }
+
+    QString roomDescription;
+    QString imagePath;
+    qint64 logTotal = 0;
+    int logSize = 0;
+    if (!readString(reader, roomDescription) || !readString(reader, imagePath)
+        || !readInteger(reader, logTotal) || logTotal < 0
+        || !readInt(reader, logSize, 0, GameLog::Capacity)) {
+        return false;
+    }
+    // The log section is kept encoded until someone asks for it
+    QByteArray log;
+    if (!readByteArray(reader, log)) {
+        return false;
+    }
+
+    snapshot.m_state = GameState();
+    snapshot.m_state.setCurrentLocationIndex(location)
+                    .setCurrentRoomIndex(room)
+                    .setGoldBars(goldBars)
+                    .setNotesFound(notesFound)
+                    .setGameOver(flags & GameOverFlag)
+                    .setGameWon(flags & GameWonFlag)
+                    .setLoading(flags & LoadingFlag)
+                    .setActiveRiddleId(riddleId)
+                    .setInventory(inventory)
+                    .setNoteIds(noteIds)
+                    .setCurrentDoors(doors)
+                    .setRoomDescription(roomDescription)
+                    .setLocationImagePath(imagePath);
+    snapshot.m_log = log;
+    snapshot.m_logSize = logSize;
+    snapshot.m_logTotal = static_cast<quint64>(logTotal);
+    return true;
+}
+
+bool GameSnapshot::logEntries(QVector<LogEntry>& entries) const
+{
+    entries.clear();
+    QCborStreamReader reader(m_log);
+    if (!reader.isArray() || !reader.enterContainer() || !reader.isArray() || !reader.enterContainer()) {
+        return false;
+    }
+
+    QVector<quint32> texts{0};
+    while (reader.hasNext()) {
+        QString text;
+        if (!readString(reader, text)) {
+            return false;
+        }
+        texts.append(LogStrings::intern(text));
+    }
+    if (!reader.leaveContainer() || !reader.isArray() || !reader.enterContainer()) {
+        return false;
+    }
+
+    entries.reserve(m_logSize);
+    while (reader.hasNext()) {
+        int message = 0;
+        int value = 0;
+        int text = 0;
+        if (!readInt(reader, message, 0, LastLogMessage) || !readInt(reader, value, INT_MIN)
+            || !readInt(reader, text, 0, texts.size() - 1)) {
+            return false;
+        }
+        entries.append({static_cast<LogMessage>(message), value, texts[text]});
+    }
+    return reader.leaveContainer() && entries.size() == m_logSize;
+}
+
+bool GameSnapshot::restore(GameState& state) const
+{
+    QVector<LogEntry> entries;
+    if (!logEntries(entries)) {
+        return false;
+    }
+    GameLog log;
+    log.restore(entries, m_logTotal);
+    state = m_state;
+    state.setLog(log);
+    return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+#include "GameState.h"
+
+/**
+ * @brief GameSnapshot - Versioned CBOR save of a whole GameState
+ *
+ * read() decodes the rule state, notes, doors and texts but keeps the log as
+ * its encoded section; the entries are decoded only by logEntries() or
+ * restore(), so peeking at a save never pays for its log. Log strings are
+ * stored once per snapshot and re-interned on decode. Typewriter progress is
+ * presentation and is not saved.
+ */
+class GameSnapshot {
+public:
+    static constexpr int Version = 1;
+
+    static QByteArray encode(const GameState& state);
+
+    // Everything but the log; false if the data is malformed or from a newer version
+    static bool read(const QByteArray& data, GameSnapshot& snapshot);
+
+    // The saved state without its log
+    const GameState& state() const { return m_state; }
+    int logSize() const { return m_logSize; }
+    quint64 logTotal() const { return m_logTotal; }
+
+    // Decode the log section, oldest entry first
+    bool logEntries(QVector<LogEntry>& entries) const;
+
+    // The saved state with its log; false if the log section is malformed
+    bool restore(GameState& state) const;
+
+private:
+    GameState m_state;
+    QByteArray m_log;
+    int m_logSize = 0;
+    quint64 m_logTotal = 0;
+};
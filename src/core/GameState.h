@@ -5,7 +5,16 @@
 #include <QMetaType>
 #include "Types.h"
 #include "Constants.h"
+#include "GameLog.h"
+#include "../utils/PersistentVector.h"
 
+/**
+ * @brief GameState - Value snapshot of one game
+ *
+ * Notes are a persistent vector and the log is a fixed-size ring of compact
+ * entries, so copying a state costs the same on move 1 and on move 100k.
+ * Notes and the active riddle are ContentCatalog ids, not copies.
+ */
 class GameState {
 public:
 
@@ -15,11 +24,12 @@ public:
     int getCurrentRoomIndex() const { return m_currentRoomIndex; }
     int getGoldBars() const { return m_goldBars; }
     const QVector<ItemType>& getInventory() const { return m_inventory; }
-    const QVector<NoteData>& getNotes() const { return m_notes; }
-    const QVector<QString>& getLogs() const { return m_logs; }
+    const PersistentVector<ContentId>& getNoteIds() const { return m_noteIds; }
+    const GameLog& getLog() const { return m_log; }
     bool isGameOver() const { return m_isGameOver; }
     bool isGameWon() const { return m_gameWon; }
-    const RiddleData* getActiveRiddle() const { return m_activeRiddle.get(); }
+    bool hasActiveRiddle() const { return m_activeRiddleId != NoContent; }
+    ContentId getActiveRiddleId() const { return m_activeRiddleId; }
     const QVector<DoorData>& getCurrentDoors() const { return m_doors; }
     const QString& getRoomDescription() const { return m_roomDescription; }
     bool isLoading() const { return m_isLoading; }
@@ -32,11 +42,11 @@ public:
     GameState& setCurrentRoomIndex(int index) { m_currentRoomIndex = index; return *this; }
     GameState& setGoldBars(int bars) { m_goldBars = bars; return *this; }
     GameState& setInventory(const QVector<ItemType>& inv) { m_inventory = inv; return *this; }
-    GameState& setNotes(const QVector<NoteData>& notes) { m_notes = notes; return *this; }
-    GameState& setLogs(const QVector<QString>& logs) { m_logs = logs; return *this; }
+    GameState& setNoteIds(const QVector<ContentId>& ids) { m_noteIds = PersistentVector<ContentId>(ids); return *this; }
+    GameState& setLog(const GameLog& log) { m_log = log; return *this; }
     GameState& setGameOver(bool value) { m_isGameOver = value; return *this; }
     GameState& setGameWon(bool value) { m_gameWon = value; return *this; }
-    GameState& setActiveRiddle(std::shared_ptr<RiddleData> riddle) { m_activeRiddle = riddle; return *this; }
+    GameState& setActiveRiddleId(ContentId id) { m_activeRiddleId = id; return *this; }
     GameState& setCurrentDoors(const QVector<DoorData>& doors) { m_doors = doors; return *this; }
     GameState& setRoomDescription(const QString& desc) { m_roomDescription = desc; return *this; }
     GameState& setLoading(bool value) { m_isLoading = value; return *this; }
@@ -46,11 +56,11 @@ public:
     GameState& setTypeWriterProgress(float progress) { m_typeWriterProgress = progress; return *this; }
 
     bool hasInventorySpace() const { return m_inventory.size() < MAX_INVENTORY_SIZE; }
-    void addLog(const QString& message) { m_logs.append(message); }
+    bool addLog(const LogEntry& entry, LogEntry* evicted = nullptr) { return m_log.append(entry, evicted); }
     void addItem(ItemType item) { if (hasInventorySpace()) m_inventory.append(item); }
     bool hasItem(ItemType item) const { return m_inventory.contains(item); }
     void removeItem(ItemType item) { m_inventory.removeOne(item); }
-    void addNote(const NoteData& note) { m_notes.append(note); }
+    void addNote(ContentId id) { m_noteIds.append(id); }
 
 
 private:
@@ -62,11 +72,11 @@ private:
     int m_currentRoomIndex = 0;
     int m_goldBars = 0;
     QVector<ItemType> m_inventory;
-    QVector<NoteData> m_notes;
-    QVector<QString> m_logs;
+    PersistentVector<ContentId> m_noteIds;
+    GameLog m_log;
     bool m_isGameOver = false;
     bool m_gameWon = false;
-    std::shared_ptr<RiddleData> m_activeRiddle = nullptr;
+    ContentId m_activeRiddleId = NoContent;
     QVector<DoorData> m_doors;
     QString m_roomDescription;
     bool m_isLoading = false;
@@ -0,0 +1,58 @@
+#include "LogArchive.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QDebug>
+
+LogArchive::LogArchive(const QString& filePath)
+    : m_file(filePath)
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "Cannot open log archive:" << filePath << m_file.errorString();
+    }
+}
+
+LogArchive::~LogArchive()
+{
+    flush();
+}
+
+void LogArchive::append(const LogEntry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    for (const QString& line : GameLog::format(entry)) {
+        m_buffer += line.toUtf8();
+        m_buffer += '\n';
+    }
+    m_archived++;
+
+    if (m_buffer.size() >= FlushThreshold) {
+        flushLocked();
+    }
+}
+
+void LogArchive::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    flushLocked();
+}
+
+void LogArchive::flushLocked()
+{
+    if (m_buffer.isEmpty() || !m_file.isOpen()) {
+        return;
+    }
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_buffer.clear();
+}
+
+QString LogArchive::defaultPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/log_archive.txt";
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include "GameLog.h"
+
+/**
+ * @brief LogArchive - Append-only on-disk store for log entries spilled
+ * out of the in-memory GameLog ring
+ *
+ * Entries are formatted once, on eviction, and written as UTF-8 lines through
+ * a small write buffer. Thread-safe.
+ */
+class LogArchive {
+public:
+    explicit LogArchive(const QString& filePath);
+    ~LogArchive();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    QString filePath() const { return m_file.fileName(); }
+    quint64 archivedCount() const { return m_archived; }
+
+    void append(const LogEntry& entry);
+    void flush();
+
+    // Default location next to the other per-user application data
+    static QString defaultPath();
+
+private:
+    void flushLocked();
+
+    static constexpr int FlushThreshold = 64 * 1024;
+
+    QFile m_file;
+    QByteArray m_buffer;
+    QMutex m_mutex;
+    quint64 m_archived = 0;
+};
@@ -0,0 +1,285 @@
+#include "MctsPlayer.h"
+#include "GameSession.h"
+#include "PackedGameState.h"
+#include "Constants.h"
+#include "../utils/WorkStealingPool.h"
+#include <QElapsedTimer>
+#include <QtAlgorithms>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+
+namespace {
+
+// Longer than any game: 15 locations of MOVES_PER_LOCATION rooms and the final move
+constexpr int MaxDepth = 256;
+
+}
+
+MctsPlayer::MctsPlayer(const BatchRules& rules, WorkStealingPool& pool, const MctsOptions& options)
+    : m_rules(rules)
+    , m_pool(pool)
+{
+    setOptions(options);
+}
+
+MctsPlayer::~MctsPlayer() = default;
+
+void MctsPlayer::setOptions(const MctsOptions& options)
+{
+    const int previous = m_nodes ? m_options.maxNodes : 0;
+    m_options = options;
+    m_options.maxNodes = qMax(1, m_options.maxNodes);
+    if (m_options.maxNodes != previous) {
+        m_nodes.reset(new Node[m_options.maxNodes]);
+    }
+}
+
+MctsResult MctsPlayer::search(const GameSession& session)
+{
+    PackedGameState packed;
+    if (!PackedGameState::pack(session.getCurrentState(), packed)) {
+        return MctsResult();
+    }
+    return search(BatchEngine::unpackLane(packed, session.getStats().riddlesEncountered));
+}
+
+MctsResult MctsPlayer::search(const BatchLane& root)
+{
+    MctsResult result;
+    if (root.isGameOver()) {
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    resetNode(0);
+    m_used.store(1);
+    m_nextIteration.store(0);
+    const quint64 seed = RandomGenerator::deriveSeed(m_options.seed, m_searches++);
+
+    // The calling thread works too and then waits for the helpers
+    const int helpers = qMin(m_pool.threadCount(), m_options.iterations / 64);
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = helpers;
+
+    for (int i = 0; i < helpers; ++i) {
+        m_pool.submit([&]() {
+            runRollouts(root, seed);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        });
+    }
+    runRollouts(root, seed);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]() { return running == 0; });
+    }
+
+    // Most visited child: the mean of a rarely tried door is noise
+    BatchLane first = root;
+    RandomGenerator player(RandomGenerator::deriveSeed(seed, std::numeric_limits<quint64>::max()));
+    answerRiddle(first, player);
+    const quint32 available = availableActions(first);
+
+    int bestVisits = -1;
+    for (int action = 0; action < ActionCount; ++action) {
+        const int child = m_nodes[0].children[action].load();
+        if (!(available & (1u << action)) || child < 0) {
+            continue;
+        }
+        const int visits = m_nodes[child].visits.load();
+        if (visits > bestVisits) {
+            bestVisits = visits;
+            result.door = doorFor(first, action);
+            result.expectedGold = visits > 0 ? static_cast<double>(m_nodes[child].gold.load()) / visits : 0.0;
+        }
+    }
+
+    result.rollouts = m_options.iterations;
+    result.nodes = qMin(m_used.load(), m_options.maxNodes);
+    result.nanoseconds = timer.nsecsElapsed();
+    return result;
+}
+
+void MctsPlayer::runRollouts(const BatchLane& root, quint64 seed)
+{
+    for (int i = m_nextIteration.fetch_add(1, std::memory_order_relaxed); i < m_options.iterations;
+         i = m_nextIteration.fetch_add(1, std::memory_order_relaxed)) {
+        rollout(root, RandomGenerator::deriveSeed(seed, static_cast<quint64>(i)));
+    }
+}
+
+void MctsPlayer::rollout(const BatchLane& root, quint64 seed)
+{
+    // Fork with a fresh future: the root's own stream is the real one
+    BatchLane lane = root;
+    lane.rng.seed(seed);
+    RandomGenerator player(RandomGenerator::deriveSeed(seed, 1));
+
+    int path[MaxDepth];
+    int depth = 0;
+    int node = 0;
+    path[depth++] = node;
+    m_nodes[node].visits.fetch_add(1, std::memory_order_relaxed);
+
+    // Tree walk, until a new node is attached
+    while (!lane.isGameOver() && depth < MaxDepth) {
+        answerRiddle(lane, player);
+
+        int action = WalkNormal;
+        int child = selectChild(node, availableActions(lane), action);
+        const bool expanding = child < 0;
+        if (expanding) {
+            child = expand(node, action);
+        }
+
+        BatchEngine::stepLane(lane, static_cast<quint32>(doorFor(lane, action)), m_rules);
+        if (child < 0) {
+            break;  // Node pool is full
+        }
+        m_nodes[child].visits.fetch_add(1, std::memory_order_relaxed);
+        path[depth++] = child;
+        node = child;
+        if (expanding) {
+            break;
+        }
+    }
+
+    while (!lane.isGameOver()) {
+        answerRiddle(lane, player);
+        BatchEngine::stepLane(lane, static_cast<quint32>(greedyDoor(lane)), m_rules);
+    }
+
+    const qint64 gold = lane.goldBars - root.goldBars;
+    for (int i = 0; i < depth; ++i) {
+        m_nodes[path[i]].gold.fetch_add(gold, std::memory_order_relaxed);
+    }
+}
+
+int MctsPlayer::selectChild(int node, quint32 available, int& action)
+{
+    const Node& parent = m_nodes[node];
+    const int parentVisits = qMax(1, parent.visits.load(std::memory_order_relaxed));
+    const double parentMean = static_cast<double>(parent.gold.load(std::memory_order_relaxed)) / parentVisits;
+    const double exploration = m_options.exploration * qMax(1.0, parentMean);
+    const double logVisits = std::log(static_cast<double>(parentVisits));
+
+    int best = -1;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (int a = 0; a < ActionCount; ++a) {
+        if (!(available & (1u << a))) {
+            continue;
+        }
+        const int child = parent.children[a].load(std::memory_order_acquire);
+        if (child < 0) {
+            action = a;
+            return -1;
+        }
+
+        // Visits are counted before the gold arrives; in-flight rollouts
+        // lower the mean, which steers other threads elsewhere
+        const int visits = m_nodes[child].visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            action = a;
+            return child;
+        }
+        const double mean = static_cast<double>(m_nodes[child].gold.load(std::memory_order_relaxed)) / visits;
+        const double score = mean + exploration * std::sqrt(logVisits / visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = child;
+            action = a;
+        }
+    }
+    return best;
+}
+
+int MctsPlayer::expand(int node, int action)
+{
+    std::atomic<qint32>& slot = m_nodes[node].children[action];
+    qint32 existing = slot.load(std::memory_order_acquire);
+    if (existing >= 0) {
+        return existing;
+    }
+
+    const int index = m_used.fetch_add(1, std::memory_order_relaxed);
+    if (index >= m_options.maxNodes) {
+        return -1;
+    }
+    resetNode(index);
+
+    // A thread that loses the race uses the winner's node; its own stays unused
+    if (slot.compare_exchange_strong(existing, index, std::memory_order_acq_rel)) {
+        return index;
+    }
+    return existing;
+}
+
+void MctsPlayer::resetNode(int index)
+{
+    Node& node = m_nodes[index];
+    node.visits.store(0, std::memory_order_relaxed);
+    node.gold.store(0, std::memory_order_relaxed);
+    for (std::atomic<qint32>& child : node.children) {
+        child.store(-1, std::memory_order_relaxed);
+    }
+}
+
+void MctsPlayer::answerRiddle(BatchLane& lane, RandomGenerator& player) const
+{
+    if (lane.hasRiddle()) {
+        BatchEngine::resolveLane(lane, player.randomDouble() < m_options.riddleSolveRate);
+    }
+}
+
+quint32 MctsPlayer::availableActions(const BatchLane& lane)
+{
+    const int size = lane.inventory & 0x3;
+    const int gold = qPopulationCount(static_cast<quint32>((lane.inventory >> 2) & ((1u << size) - 1)));
+    const int silver = size - gold;
+
+    quint32 available = 0;
+    for (int i = 0; i < lane.doorCount; ++i) {
+        const quint32 code = (lane.doors >> (2 * i)) & 0x3;
+        if (code == PackedGameState::SilverDoor) {
+            available |= silver > 0 ? 1u << OpenSilver : 0;
+        } else if (code == PackedGameState::GoldDoor) {
+            available |= gold > 0 ? 1u << OpenGold : 0;
+        } else {
+            available |= 1u << WalkNormal;
+        }
+    }
+    return available;
+}
+
+int MctsPlayer::doorFor(const BatchLane& lane, int action)
+{
+    for (int i = 0; i < lane.doorCount; ++i) {
+        const quint32 code = (lane.doors >> (2 * i)) & 0x3;
+        const bool match = action == OpenGold ? code == PackedGameState::GoldDoor
+                         : action == OpenSilver ? code == PackedGameState::SilverDoor
+                         : (code == PackedGameState::NormalDoor || code == PackedGameState::WoodenDoor);
+        if (match) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+int MctsPlayer::greedyDoor(const BatchLane& lane)
+{
+    const quint32 available = availableActions(lane);
+    if (available & (1u << OpenGold)) {
+        return doorFor(lane, OpenGold);
+    }
+    if ((available & (1u << OpenSilver)) && (lane.inventory & 0x3) >= MAX_INVENTORY_SIZE) {
+        return doorFor(lane, OpenSilver);
+    }
+    return doorFor(lane, WalkNormal);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "BatchEngine.h"
+
+class GameSession;
+class WorkStealingPool;
+
+/**
+ * @brief MctsOptions - Search budget and player model of MctsPlayer
+ */
+struct MctsOptions {
+    int iterations = 20000;         // Rollouts per search
+    int maxNodes = 1 << 18;         // Tree size; full trees keep searching without expanding
+    double exploration = 1.0;       // UCB constant, scaled by the parent's mean gold
+    double riddleSolveRate = 1.0;   // Chance the simulated player answers a riddle correctly
+    quint64 seed = 0;               // Searches draw from deriveSeed(seed, search number)
+};
+
+/**
+ * @brief MctsResult - Door picked by a search and its statistics
+ */
+struct MctsResult {
+    int door = -1;                  // Index into the current doors, -1 if the game is over
+    double expectedGold = 0.0;      // Mean gold the chosen door led to in rollouts
+    qint64 rollouts = 0;
+    qint64 nanoseconds = 0;
+    int nodes = 0;
+};
+
+/**
+ * @brief MctsPlayer - Monte Carlo tree search bot on the batch kernels
+ *
+ * Actions are door kinds (normal, silver, gold): the doors of a room are
+ * random, which kind is open is what matters. The tree is open-loop: every
+ * rollout forks the root lane, reseeds its random stream so the real future
+ * stays unknown, and walks the tree by the actions available in that sample.
+ * Below the tree a greedy policy finishes the game. Forks are BatchLane
+ * copies on the stack, so rollouts never allocate.
+ *
+ * Rollouts run on a WorkStealingPool and the calling thread. Tree statistics
+ * are atomics; a visit is counted on the way down and its gold on the way
+ * up, which works as a virtual loss and spreads threads over the tree.
+ * Children are attached with a compare-and-swap into a preallocated pool.
+ */
+class MctsPlayer {
+public:
+    MctsPlayer(const BatchRules& rules, WorkStealingPool& pool, const MctsOptions& options = MctsOptions());
+    ~MctsPlayer();
+
+    MctsPlayer(const MctsPlayer&) = delete;
+    MctsPlayer& operator=(const MctsPlayer&) = delete;
+
+    const MctsOptions& options() const { return m_options; }
+    void setOptions(const MctsOptions& options);
+
+    // Blocks until the search is done; must not be called from a pool worker
+    MctsResult search(const BatchLane& root);
+    MctsResult search(const GameSession& session);
+
+    // Greedy door for a lane: gold door with a gold key, silver door when the
+    // inventory is full, otherwise normal
+    static int greedyDoor(const BatchLane& lane);
+
+private:
+    enum Action {
+        WalkNormal = 0,
+        OpenSilver = 1,
+        OpenGold = 2,
+        ActionCount = 3
+    };
+
+    struct Node {
+        std::atomic<qint32> visits{0};
+        std::atomic<qint64> gold{0};
+        std::atomic<qint32> children[ActionCount];
+    };
+
+    void runRollouts(const BatchLane& root, quint64 seed);
+    void rollout(const BatchLane& root, quint64 seed);
+    int selectChild(int node, quint32 available, int& action);
+    int expand(int node, int action);
+    void resetNode(int index);
+
+    static quint32 availableActions(const BatchLane& lane);
+    static int doorFor(const BatchLane& lane, int action);
+    void answerRiddle(BatchLane& lane, RandomGenerator& player) const;
+
+    BatchRules m_rules;
+    WorkStealingPool& m_pool;
+    MctsOptions m_options;
+    quint64 m_searches = 0;
+
+    std::unique_ptr<Node[]> m_nodes;
+    std::atomic<int> m_used{0};
+    std::atomic<int> m_nextIteration{0};
+};
@@ -0,0 +1,122 @@
+#include "PackedGameState.h"
+#include "ContentCatalog.h"
+#include "../utils/ShuffledDeck.h"
+
+namespace {
+
+bool encodeDoor(const DoorData& door, quint32& code)
+{
+    const DoorData wooden = PackedGameState::doorData(PackedGameState::WoodenDoor);
+    if (door.type == DoorType::NORMAL && door.description == wooden.description) {
+        code = PackedGameState::WoodenDoor;
+        return true;
+    }
+    if (door.description != doorTypeToString(door.type) + " дверь") {
+        return false;
+    }
+    switch (door.type) {
+        case DoorType::NORMAL: code = PackedGameState::NormalDoor; return true;
+        case DoorType::SILVER: code = PackedGameState::SilverDoor; return true;
+        case DoorType::GOLD: code = PackedGameState::GoldDoor; return true;
+    }
+    return false;
+}
+
+}
+
+bool PackedGameState::pack(const GameState& state, PackedGameState& packed)
+{
+    const int location = state.getCurrentLocationIndex();
+    const int room = state.getCurrentRoomIndex();
+    const QVector<ItemType>& inventory = state.getInventory();
+    const QVector<DoorData>& doors = state.getCurrentDoors();
+
+    if (location < 0 || location > 0xF || room < 0 || room > 0xF
+        || inventory.size() > 3 || doors.size() > 4
+        || state.getGoldBars() < 0 || state.getGoldBars() > 0xFFFF
+        || state.getNoteIds().size() > 0xFFFF) {
+        return false;
+    }
+
+    quint32 bits = static_cast<quint32>(location) | (static_cast<quint32>(room) << 4);
+
+    bits |= static_cast<quint32>(inventory.size()) << 8;
+    for (int slot = 0; slot < inventory.size(); ++slot) {
+        if (inventory[slot] == ItemType::GOLD_KEY) {
+            bits |= 1u << (10 + slot);
+        }
+    }
+
+    bits |= static_cast<quint32>(doors.size()) << 13;
+    for (int i = 0; i < doors.size(); ++i) {
+        quint32 code = 0;
+        if (!encodeDoor(doors[i], code)) {
+            return false;
+        }
+        bits |= code << (16 + 2 * i);
+    }
+
+    if (state.isGameOver()) {
+        bits |= 1u << 24;
+    }
+    if (state.isGameWon()) {
+        bits |= 1u << 25;
+    }
+    if (state.isLoading()) {
+        bits |= 1u << 26;
+    }
+
+    packed.bits = bits;
+    packed.goldBars = static_cast<quint16>(state.getGoldBars());
+    packed.notes = static_cast<quint16>(state.getNoteIds().size());
+    packed.riddleId = state.getActiveRiddleId();
+    return true;
+}
+
+GameState PackedGameState::unpack(const ContentCatalog& content, const ShuffledDeck& noteDeck) const
+{
+    QVector<ItemType> inventory;
+    inventory.reserve(inventorySize());
+    for (int slot = 0; slot < inventorySize(); ++slot) {
+        inventory.append(inventoryItem(slot));
+    }
+
+    QVector<DoorData> doors;
+    doors.reserve(doorCount());
+    for (int i = 0; i < doorCount(); ++i) {
+        doors.append(doorData(door(i)));
+    }
+
+    GameState state;
+    state.setCurrentLocationIndex(location())
+         .setCurrentRoomIndex(room())
+         .setGoldBars(goldBars)
+         .setInventory(inventory)
+         .setCurrentDoors(doors)
+         .setGameOver(isGameOver())
+         .setGameWon(isGameWon())
+         .setLoading(isLoading());
+
+    const QVector<NoteData>& noteSequence = content.notes();
+    const int noteCount = qMin<int>(notes, qMin(noteDeck.size(), noteSequence.size()));
+    QVector<ContentId> noteIds;
+    noteIds.reserve(noteCount);
+    for (int i = 0; i < noteCount; ++i) {
+        noteIds.append(noteSequence[noteDeck.at(i)].id);
+    }
+    state.setNoteIds(noteIds);
+    state.setActiveRiddleId(riddleId);
+    return state;
+}
+
+DoorData PackedGameState::doorData(DoorCode code)
+{
+    // Built once; copies share the string data
+    static const DoorData doors[4] = {
+        {DoorType::NORMAL, doorTypeToString(DoorType::NORMAL) + " дверь"},
+        {DoorType::SILVER, doorTypeToString(DoorType::SILVER) + " дверь"},
+        {DoorType::GOLD, doorTypeToString(DoorType::GOLD) + " дверь"},
+        {DoorType::NORMAL, QStringLiteral("Обычная деревянная дверь")}
+    };
+    return doors[code & 0x3];
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QtGlobal>
+#include <QVector>
+#include <type_traits>
+#include "GameState.h"
+
+class ContentCatalog;
+class ShuffledDeck;
+
+/**
+ * @brief PackedGameState - Rule state of a GameState in 12 trivially copyable bytes
+ *
+ * Layout of `bits`:
+ *   0-3   location index        4-7   room index
+ *   8-9   inventory size        10-12 inventory slots (0 = silver, 1 = gold key)
+ *   13-15 door count            16-23 doors, 2 bits each (see DoorCode)
+ *   24    game over             25    game won
+ *   26    loading
+ *
+ * Content is referenced, not copied: the active riddle by id and the notes as
+ * a count, because a session deals notes from a deck whose order is fixed by
+ * its seed. Presentation fields (log, room description, typewriter, background)
+ * are not stored; unpack() leaves them empty.
+ */
+struct PackedGameState {
+    enum DoorCode : quint32 {
+        NormalDoor = 0,
+        SilverDoor = 1,
+        GoldDoor = 2,
+        WoodenDoor = 3      // The always-present normal door of a room
+    };
+
+    static constexpr ContentId NoRiddle = NoContent;
+
+    quint32 bits = 0;
+    quint16 goldBars = 0;
+    quint16 notes = 0;
+    qint32 riddleId = NoRiddle;
+
+    int location() const { return bits & 0xF; }
+    int room() const { return (bits >> 4) & 0xF; }
+    int inventorySize() const { return (bits >> 8) & 0x3; }
+    ItemType inventoryItem(int slot) const { return ((bits >> (10 + slot)) & 1) ? ItemType::GOLD_KEY : ItemType::SILVER_KEY; }
+    int doorCount() const { return (bits >> 13) & 0x7; }
+    DoorCode door(int index) const { return static_cast<DoorCode>((bits >> (16 + 2 * index)) & 0x3); }
+    bool isGameOver() const { return bits & (1u << 24); }
+    bool isGameWon() const { return bits & (1u << 25); }
+    bool isLoading() const { return bits & (1u << 26); }
+    bool hasRiddle() const { return riddleId != NoRiddle; }
+
+    /**
+     * @brief Pack the rule state of a GameState
+     * @return false if a field does not fit (more than 15 locations, unknown door text, ...)
+     */
+    static bool pack(const GameState& state, PackedGameState& packed);
+
+    /**
+     * @brief Rebuild a GameState
+     * @param content Catalog the session drew its notes from
+     * @param noteDeck Note deck of that session (GameSession::getNoteDeck())
+     */
+    GameState unpack(const ContentCatalog& content, const ShuffledDeck& noteDeck) const;
+
+    static DoorData doorData(DoorCode code);
+
+    bool operator==(const PackedGameState& other) const
+    {
+        return bits == other.bits && goldBars == other.goldBars
+            && notes == other.notes && riddleId == other.riddleId;
+    }
+    bool operator!=(const PackedGameState& other) const { return !(*this == other); }
+};
+
+static_assert(std::is_trivially_copyable<PackedGameState>::value, "PackedGameState must stay memcpy-able");
+static_assert(sizeof(PackedGameState) == 12, "PackedGameState layout changed");
@@ -4,6 +4,10 @@
 #include <QVector>
 #include <memory>
 
+// Database id of a location, riddle or note; game state stores these instead of copies
+using ContentId = qint32;
+constexpr ContentId NoContent = -1;
+
 enum class DoorType {
     NORMAL,
     SILVER,
@@ -0,0 +1,180 @@
+#include "AsyncDatabase.h"
+#include "DatabaseManager.h"
+#include <QDebug>
+#include <variant>
+
+namespace {
+
+// Readers: one per content table loaded by loadContent()
+constexpr int ReaderThreads = 3;
+
+using ContentLoad = std::variant<QFuture<QVector<LocationData>>,
+                                 QFuture<QVector<RiddleData>>,
+                                 QFuture<QVector<NoteData>>>;
+
+}
+
+AsyncDatabase::AsyncDatabase()
+    : AsyncDatabase(QString(), QString())
+{
+}
+
+AsyncDatabase::AsyncDatabase(const QString& dbPath, const QString& sqlPath)
+    : m_database(std::make_unique<DatabaseManager>())
+    , m_dbPath(dbPath)
+    , m_sqlPath(sqlPath)
+{
+    m_readers.setMaxThreadCount(ReaderThreads);
+    m_writer.setMaxThreadCount(1);
+    // The writer keeps its connection, and with it a ":memory:" database, alive
+    m_writer.setExpiryTimeout(-1);
+    m_maintenance.setMaxThreadCount(1);
+}
+
+AsyncDatabase::~AsyncDatabase()
+{
+    // Queued saves are not dropped; pruning stops at its next transaction
+    m_stopping = true;
+    m_writer.waitForDone();
+    m_readers.waitForDone();
+    m_maintenance.waitForDone();
+}
+
+template <typename T, typename Task>
+QFuture<T> AsyncDatabase::run(QThreadPool* pool, Task task)
+{
+    auto promise = std::make_shared<QPromise<T>>();
+    QFuture<T> future = promise->future();
+    promise->start();
+    pool->start([promise, task = std::move(task)]() mutable {
+        promise->addResult(task());
+        promise->finish();
+    });
+    return future;
+}
+
+template <typename T, typename Task>
+QFuture<T> AsyncDatabase::read(Task task)
+{
+    if (m_connected) {
+        return run<T>(&m_readers, std::move(task));
+    }
+    return connect().then(&m_readers, [task = std::move(task)](bool) mutable {
+        return task();
+    });
+}
+
+template <typename Task>
+QFuture<bool> AsyncDatabase::write(Task task)
+{
+    return run<bool>(&m_writer, [this, task = std::move(task)]() mutable {
+        return connectOnWriter() && task();
+    });
+}
+
+bool AsyncDatabase::connectOnWriter()
+{
+    if (!m_connected) {
+        m_connected = m_dbPath.isEmpty() ? m_database->connect() : m_database->connect(m_dbPath, m_sqlPath);
+    }
+    return m_connected;
+}
+
+QFuture<bool> AsyncDatabase::connect()
+{
+    return run<bool>(&m_writer, [this]() {
+        return connectOnWriter();
+    });
+}
+
+QFuture<QVector<LocationData>> AsyncDatabase::loadLocations()
+{
+    return read<QVector<LocationData>>([this]() {
+        return m_database->loadLocations();
+    });
+}
+
+QFuture<QVector<RiddleData>> AsyncDatabase::loadRiddles()
+{
+    return read<QVector<RiddleData>>([this]() {
+        return m_database->loadRiddles();
+    });
+}
+
+QFuture<QVector<NoteData>> AsyncDatabase::loadNotes()
+{
+    return read<QVector<NoteData>>([this]() {
+        return m_database->loadNotes();
+    });
+}
+
+QFuture<QVector<ItemData>> AsyncDatabase::loadItems()
+{
+    return read<QVector<ItemData>>([this]() {
+        return m_database->loadItems();
+    });
+}
+
+QFuture<ContentCatalogPtr> AsyncDatabase::loadContent()
+{
+    // Каталог собирается в потоке, завершившем последнюю загрузку
+    return QtFuture::whenAll(loadLocations(), loadRiddles(), loadNotes())
+        .then([this](const QList<ContentLoad>& loads) {
+            if (!m_connected) {
+                return ContentCatalogPtr();
+            }
+            return ContentCatalog::create(std::get<0>(loads[0]).result(),
+                                          std::get<1>(loads[1]).result(),
+                                          std::get<2>(loads[2]).result());
+        });
+}
+
+QFuture<bool> AsyncDatabase::saveGameState(const QString& playerName, const GameState& state,
+                                           QObject* context, std::function<void(bool)> done)
+{
+    QFuture<bool> saved = write([this, playerName, state]() {
+        return m_database->saveGameState(playerName, state);
+    });
+    if (!context || !done) {
+        return saved;
+    }
+    return saved.then(context, [done = std::move(done)](bool ok) {
+        done(ok);
+        return ok;
+    });
+}
+
+QFuture<std::optional<GameState>> AsyncDatabase::loadGameState(const QString& playerName)
+{
+    // Через писателя: загрузка видит все сохранения, поставленные до неё
+    return run<std::optional<GameState>>(&m_writer, [this, playerName]() -> std::optional<GameState> {
+        GameState state;
+        if (!connectOnWriter() || !m_database->loadGameState(playerName, state)) {
+            return std::nullopt;
+        }
+        return state;
+    });
+}
+
+QFuture<QVector<SaveInfo>> AsyncDatabase::saveHistory(const QString& playerName, int limit,
+                                                      std::optional<SaveInfo> after)
+{
+    return run<QVector<SaveInfo>>(&m_writer, [this, playerName, limit, after]() {
+        if (!connectOnWriter()) {
+            return QVector<SaveInfo>();
+        }
+        return m_database->saves().history(playerName, limit, after ? &*after : nullptr);
+    });
+}
+
+QFuture<qint64> AsyncDatabase::pruneSaves()
+{
+    return connect().then(&m_maintenance, [this](bool connected) -> qint64 {
+        return connected ? m_database->saves().prune(SaveRetention(), &m_stopping) : -1;
+    });
+}
+
+QString AsyncDatabase::getLastError() const
+{
+    return m_database->getLastError();
+}
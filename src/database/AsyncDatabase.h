@@ -0,0 +1,101 @@
+#ifndef ASYNCDATABASE_H
+#define ASYNCDATABASE_H
+
+#include <QFuture>
+#include <QObject>
+#include <QPromise>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include "../core/ContentCatalog.h"
+#include "../core/GameState.h"
+#include "../core/Types.h"
+#include "SaveStore.h"
+
+class DatabaseManager;
+
+/**
+ * @brief AsyncDatabase - Future-based front for DatabaseManager on worker threads
+ *
+ * Content loads run concurrently on a reader pool, each on its thread's own
+ * pooled connection. The import, saves and save lookups run in call order on
+ * one writer thread, so a load issued after a save sees it. Save retention
+ * runs on a third, maintenance thread. Nothing here blocks the calling
+ * thread; the destructor waits for queued work.
+ */
+class AsyncDatabase {
+public:
+    // The default database and SQL source of DatabaseManager::connect()
+    AsyncDatabase();
+    AsyncDatabase(const QString& dbPath, const QString& sqlPath);
+    ~AsyncDatabase();
+
+    AsyncDatabase(const AsyncDatabase&) = delete;
+    AsyncDatabase& operator=(const AsyncDatabase&) = delete;
+
+    // Open and import; once that succeeded, later calls just resolve to true
+    QFuture<bool> connect();
+
+    QFuture<QVector<LocationData>> loadLocations();
+    QFuture<QVector<RiddleData>> loadRiddles();
+    QFuture<QVector<NoteData>> loadNotes();
+    QFuture<QVector<ItemData>> loadItems();
+
+    // Locations, riddles and notes loaded side by side; null if the database is unavailable
+    QFuture<ContentCatalogPtr> loadContent();
+
+    /**
+     * @brief Queue a save
+     *
+     * done, if given, runs on context's thread with the outcome; it is
+     * dropped if context is destroyed first.
+     */
+    QFuture<bool> saveGameState(const QString& playerName, const GameState& state,
+                                QObject* context = nullptr, std::function<void(bool)> done = nullptr);
+
+    // Empty if the player has no save or it cannot be read
+    QFuture<std::optional<GameState>> loadGameState(const QString& playerName);
+
+    // A page of the player's saves, newest first, continuing after `after`
+    QFuture<QVector<SaveInfo>> saveHistory(const QString& playerName, int limit,
+                                           std::optional<SaveInfo> after = std::nullopt);
+
+    /**
+     * @brief Apply the save retention policy on a maintenance thread
+     *
+     * Runs beside the writer on its own connection, in short transactions;
+     * the destructor stops it between them. Resolves to the rows deleted.
+     */
+    QFuture<qint64> pruneSaves();
+
+    QString getLastError() const;
+
+private:
+    template <typename T, typename Task>
+    static QFuture<T> run(QThreadPool* pool, Task task);
+
+    // Reader task, started once the database is connected
+    template <typename T, typename Task>
+    QFuture<T> read(Task task);
+
+    // Writer task, connecting first if needed
+    template <typename Task>
+    QFuture<bool> write(Task task);
+
+    bool connectOnWriter();         // Writer thread only
+
+    std::unique_ptr<DatabaseManager> m_database;
+    QString m_dbPath;
+    QString m_sqlPath;
+    std::atomic<bool> m_connected{false};
+    std::atomic<bool> m_stopping{false};
+    QThreadPool m_readers;
+    QThreadPool m_writer;
+    QThreadPool m_maintenance;
+};
+
+#endif // ASYNCDATABASE_H
@@ -0,0 +1,324 @@
+#include "AutosaveWriter.h"
+#include "../core/GameState.h"
+#include <QDataStream>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QSqlError>
+#include <QVariantList>
+
+namespace {
+
+constexpr quint8 PayloadVersion = 1;
+
+// Seed, rule state and log lines; the lines go as UTF-8, half the size of QStringList's UTF-16
+QByteArray encode(quint64 seed, const PackedGameState& packed, const QStringList& lines)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << PayloadVersion << seed << packed.bits << packed.goldBars << packed.notes << packed.riddleId
+           << static_cast<quint32>(lines.size());
+    for (const QString& line : lines) {
+        stream << line.toUtf8();
+    }
+    return payload;
+}
+
+bool decode(const QByteArray& payload, quint64& seed, PackedGameState& packed, QStringList& lines)
+{
+    QDataStream stream(payload);
+    quint8 version = 0;
+    quint32 count = 0;
+    stream >> version;
+    if (version != PayloadVersion) {
+        return false;
+    }
+    stream >> seed >> packed.bits >> packed.goldBars >> packed.notes >> packed.riddleId >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QByteArray line;
+        stream >> line;
+        lines.append(QString::fromUtf8(line));
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+}
+
+AutosaveWriter::AutosaveWriter(const QString& dbPath, const AutosaveOptions& options)
+    : m_dbPath(dbPath)
+    , m_options(options)
+{
+    m_thread = std::thread([this]() { run(); });
+}
+
+AutosaveWriter::~AutosaveWriter()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopping = true;
+        m_wake.wakeOne();
+    }
+    // The writer commits what is still queued before it exits
+    m_thread.join();
+}
+
+void AutosaveWriter::record(const QString& slot, quint64 seed, const GameState& state)
+{
+    PackedGameState packed;
+    if (!PackedGameState::pack(state, packed)) {
+        qWarning() << "Autosave skipped: state does not pack";
+        return;
+    }
+
+    Record record;
+    record.slot = slot;
+    const auto found = m_cursors.find(slot);
+    record.reset = found == m_cursors.end();
+    SlotCursor& cursor = record.reset ? m_cursors[slot] : *found;
+
+    // Moves of a slot count up across games, so deleting below a snapshot
+    // also drops the previous game
+    const GameLog& log = state.getLog();
+    const bool newGame = record.reset || cursor.seed != seed || log.totalCount() < cursor.logTotal;
+    record.move = record.reset ? 0 : cursor.move + 1;
+    record.kind = newGame || record.move - cursor.snapshotMove >= static_cast<quint32>(m_options.snapshotMoves)
+                      ? Snapshot : Delta;
+
+    QStringList lines;
+    if (record.kind == Snapshot) {
+        lines = log.lines();
+        cursor.snapshotMove = record.move;
+    } else {
+        const int added = static_cast<int>(qMin<quint64>(log.totalCount() - cursor.logTotal, log.size()));
+        for (int i = log.size() - added; i < log.size(); ++i) {
+            lines += GameLog::format(log.at(i));
+        }
+    }
+    record.payload = encode(seed, packed, lines);
+    cursor.seed = seed;
+    cursor.move = record.move;
+    cursor.logTotal = log.totalCount();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.isEmpty()) {
+        m_oldestQueued.start();
+    }
+    m_queue.append(std::move(record));
+    m_enqueuedCount++;
+    // The writer sleeps indefinitely on an empty queue and until the deadline otherwise
+    if (m_queue.size() == 1 || m_queue.size() >= m_options.flushMoves) {
+        m_wake.wakeOne();
+    }
+}
+
+bool AutosaveWriter::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    const quint64 target = m_enqueuedCount;
+    m_flushRequested = true;
+    m_wake.wakeOne();
+    while (m_committedCount < target) {
+        m_committed.wait(&m_mutex);
+    }
+    const bool failed = m_failed;
+    m_failed = false;
+    return !failed;
+}
+
+AutosaveStats AutosaveWriter::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
+
+void AutosaveWriter::run()
+{
+    const bool ready = m_connection.connectSQLite(m_dbPath) && createSchema();
+    if (!ready) {
+        qCritical() << "Autosave is disabled: cannot open" << m_dbPath;
+    }
+
+    QVector<Record> batch;
+    for (;;) {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopping && !m_flushRequested && m_queue.size() < m_options.flushMoves) {
+                if (m_queue.isEmpty()) {
+                    m_wake.wait(&m_mutex);
+                    continue;
+                }
+                const qint64 remaining = m_options.flushIntervalMs - m_oldestQueued.elapsed();
+                if (remaining <= 0) {
+                    break;
+                }
+                m_wake.wait(&m_mutex, QDeadlineTimer(remaining));
+            }
+            if (m_stopping && m_queue.isEmpty()) {
+                break;
+            }
+            batch.swap(m_queue);
+            m_flushRequested = false;
+        }
+
+        // Without a database the queue is still drained, so flush() returns
+        const bool ok = ready && (batch.isEmpty() || commit(batch));
+        {
+            QMutexLocker locker(&m_mutex);
+            m_committedCount += batch.size();
+            m_failed = m_failed || !ok;
+            m_committed.wakeAll();
+        }
+        batch.clear();
+    }
+    m_connection.disconnect();
+}
+
+bool AutosaveWriter::createSchema()
+{
+    QSqlQuery query(m_connection.getDatabase());
+    // Кластеризована по (slot, move): компактизация удаляет один диапазон
+    if (!query.exec("CREATE TABLE IF NOT EXISTS autosaves ("
+                    "slot TEXT NOT NULL, "
+                    "move INTEGER NOT NULL, "
+                    "kind INTEGER NOT NULL, "
+                    "payload BLOB NOT NULL, "
+                    "saved_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP, "
+                    "PRIMARY KEY (slot, move)) WITHOUT ROWID")) {
+        qCritical() << "Failed to create autosaves:" << query.lastError().text();
+        return false;
+    }
+    if (query.exec("PRAGMA page_size") && query.next()) {
+        QMutexLocker locker(&m_mutex);
+        m_stats.pageSize = query.value(0).toULongLong();
+    }
+    return true;
+}
+
+bool AutosaveWriter::commit(const QVector<Record>& batch)
+{
+    QSqlDatabase db = m_connection.getDatabase();
+    if (!db.transaction()) {
+        qWarning() << "Autosave cannot start a transaction:" << db.lastError().text();
+        return false;
+    }
+
+    QVariantList slotNames;
+    QVariantList moves;
+    QVariantList kinds;
+    QVariantList payloads;
+    QHash<QString, quint32> snapshotMoves;  // Latest snapshot of each slot in the batch
+    quint64 payloadBytes = 0;
+    quint64 snapshots = 0;
+    bool ok = true;
+
+    for (const Record& record : batch) {
+        if (record.reset) {
+            QSqlQuery& clear = m_connection.prepared("DELETE FROM autosaves WHERE slot = ?");
+            clear.bindValue(0, record.slot);
+            ok = ok && clear.exec();
+        }
+        slotNames.append(record.slot);
+        moves.append(record.move);
+        kinds.append(static_cast<int>(record.kind));
+        payloads.append(record.payload);
+        payloadBytes += static_cast<quint64>(record.payload.size());
+        if (record.kind == Snapshot) {
+            snapshotMoves.insert(record.slot, record.move);
+            snapshots++;
+        }
+    }
+
+    QSqlQuery& insert = m_connection.prepared("INSERT OR REPLACE INTO autosaves (slot, move, kind, payload) "
+                                              "VALUES (?, ?, ?, ?)");
+    insert.bindValue(0, slotNames);
+    insert.bindValue(1, moves);
+    insert.bindValue(2, kinds);
+    insert.bindValue(3, payloads);
+    ok = ok && insert.execBatch();
+
+    quint64 compacted = 0;
+    for (auto it = snapshotMoves.cbegin(); ok && it != snapshotMoves.cend(); ++it) {
+        QSqlQuery& compact = m_connection.prepared("DELETE FROM autosaves WHERE slot = ? AND move < ?");
+        compact.bindValue(0, it.key());
+        compact.bindValue(1, it.value());
+        ok = compact.exec();
+        compacted += static_cast<quint64>(qMax(0, compact.numRowsAffected()));
+    }
+
+    if (!ok || !db.commit()) {
+        qWarning() << "Autosave commit failed:" << insert.lastError().text() << db.lastError().text();
+        db.rollback();
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stats.moves += static_cast<quint64>(batch.size());
+        m_stats.snapshots += snapshots;
+        m_stats.commits++;
+        m_stats.payloadBytes += payloadBytes;
+        m_stats.compactedRows += compacted;
+    }
+    checkpoint();
+    return true;
+}
+
+void AutosaveWriter::checkpoint()
+{
+    // Passive: copies what no reader still needs and never waits. The frame
+    // count doubles as the writer's WAL traffic; other writers to the same
+    // file make it approximate
+    QSqlQuery query(m_connection.getDatabase());
+    if (!query.exec("PRAGMA wal_checkpoint(PASSIVE)") || !query.next() || query.value(1).toLongLong() < 0) {
+        return;
+    }
+    const quint64 logFrames = query.value(1).toULongLong();
+    const quint64 checkpointed = query.value(2).toULongLong();
+    // After a complete checkpoint the next transaction starts the WAL over
+    const quint64 appended = m_walRestarts || logFrames < m_lastWalFrames ? logFrames : logFrames - m_lastWalFrames;
+    m_walRestarts = checkpointed == logFrames;
+    m_lastWalFrames = logFrames;
+
+    QMutexLocker locker(&m_mutex);
+    m_stats.walFrames += appended;
+    if (checkpointed > 0) {
+        m_stats.checkpointSyncs += 2;     // WAL before copying, database after
+    }
+}
+
+bool AutosaveWriter::load(DatabaseConnection& connection, const QString& slot, AutosavePoint& point)
+{
+    QSqlQuery& query = connection.prepared("SELECT move, kind, payload FROM autosaves "
+                                           "WHERE slot = ? AND move >= "
+                                           "(SELECT MAX(move) FROM autosaves WHERE slot = ? AND kind = 0) "
+                                           "ORDER BY move");
+    query.bindValue(0, slot);
+    query.bindValue(1, slot);
+    if (!query.exec()) {
+        qWarning() << "Failed to load autosave:" << query.lastError().text();
+        return false;
+    }
+
+    bool found = false;
+    while (query.next()) {
+        quint64 seed = 0;
+        PackedGameState packed;
+        QStringList lines;
+        if (!decode(query.value(2).toByteArray(), seed, packed, lines)) {
+            qWarning() << "Corrupt autosave record" << slot << query.value(0).toUInt();
+            query.finish();
+            return false;
+        }
+        if (query.value(1).toInt() == Snapshot) {
+            point.log.clear();
+        }
+        point.seed = seed;
+        point.move = query.value(0).toUInt();
+        point.state = packed;
+        point.log += lines;
+        found = true;
+    }
+    if (point.log.size() > LOG_MAX_LINES) {
+        point.log = point.log.mid(point.log.size() - LOG_MAX_LINES);
+    }
+    return found;
+}
@@ -0,0 +1,127 @@
+#ifndef AUTOSAVEWRITER_H
+#define AUTOSAVEWRITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+#include <thread>
+#include "DatabaseConnection.h"
+#include "../core/Constants.h"
+#include "../core/PackedGameState.h"
+
+struct AutosaveOptions {
+    int flushIntervalMs = AUTOSAVE_FLUSH_MS;    // Oldest queued move waits at most this long
+    int flushMoves = AUTOSAVE_FLUSH_MOVES;      // ... or until this many moves are queued
+    int snapshotMoves = AUTOSAVE_SNAPSHOT_MOVES;    // Full snapshot every N moves of a slot
+};
+
+/**
+ * @brief AutosaveStats - What the writer cost, for write amplification reports
+ */
+struct AutosaveStats {
+    quint64 moves = 0;              // Records committed
+    quint64 snapshots = 0;
+    quint64 commits = 0;            // Group commits; fsyncs under synchronous=FULL
+    quint64 payloadBytes = 0;       // Serialized records handed to SQLite
+    quint64 walFrames = 0;          // Pages SQLite appended to the WAL
+    quint64 pageSize = 0;
+    quint64 checkpointSyncs = 0;    // fsyncs of the checkpoints (synchronous=NORMAL)
+    quint64 compactedRows = 0;
+};
+
+/**
+ * @brief AutosavePoint - Game restored from the latest snapshot and its deltas
+ */
+struct AutosavePoint {
+    quint64 seed = 0;
+    quint32 move = 0;
+    PackedGameState state;
+    QStringList log;                // Last LOG_MAX_LINES formatted lines
+};
+
+/**
+ * @brief AutosaveWriter - Background autosave with group commit
+ *
+ * record() serializes a move on the caller's thread and queues it. A writer
+ * thread with its own WAL connection commits the queue in one transaction
+ * every flushIntervalMs or flushMoves moves, whichever comes first. A slot
+ * gets a full snapshot (rule state and the whole log) every snapshotMoves
+ * moves and on a new seed; the moves in between are deltas carrying the rule
+ * state and only the log lines added since the previous move. Committing a
+ * snapshot deletes the slot's older rows.
+ */
+class AutosaveWriter {
+public:
+    explicit AutosaveWriter(const QString& dbPath, const AutosaveOptions& options = AutosaveOptions());
+    ~AutosaveWriter();
+
+    AutosaveWriter(const AutosaveWriter&) = delete;
+    AutosaveWriter& operator=(const AutosaveWriter&) = delete;
+
+    // Queue the state after a move; call from one thread
+    void record(const QString& slot, quint64 seed, const GameState& state);
+
+    // Block until everything queued so far is committed; false if any commit
+    // failed since the previous flush()
+    bool flush();
+
+    AutosaveStats stats() const;
+
+    // Latest state of a slot, on the calling thread's connection of the pool
+    static bool load(DatabaseConnection& connection, const QString& slot, AutosavePoint& point);
+
+private:
+    enum Kind : int {
+        Snapshot = 0,
+        Delta = 1
+    };
+
+    struct Record {
+        QString slot;
+        quint32 move = 0;
+        Kind kind = Delta;
+        bool reset = false;         // First record of the slot in this process: drop its old rows
+        QByteArray payload;
+    };
+
+    // Per-slot position of the producer
+    struct SlotCursor {
+        quint64 seed = 0;
+        quint32 move = 0;
+        quint32 snapshotMove = 0;
+        quint64 logTotal = 0;
+    };
+
+    void run();
+    bool createSchema();
+    bool commit(const QVector<Record>& batch);
+    void checkpoint();
+
+    const QString m_dbPath;
+    const AutosaveOptions m_options;
+    QHash<QString, SlotCursor> m_cursors;   // Producer thread only
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_wake;
+    QWaitCondition m_committed;
+    QVector<Record> m_queue;
+    QElapsedTimer m_oldestQueued;
+    quint64 m_enqueuedCount = 0;
+    quint64 m_committedCount = 0;
+    bool m_flushRequested = false;
+    bool m_stopping = false;
+    bool m_failed = false;                  // Sticky until flush() reports it
+    AutosaveStats m_stats;
+
+    DatabaseConnection m_connection;        // Used by the writer thread only
+    quint64 m_lastWalFrames = 0;
+    bool m_walRestarts = true;              // Last checkpoint was complete
+    std::thread m_thread;
+};
+
+#endif // AUTOSAVEWRITER_H
@@ -1,44 +1,267 @@
 #include "DatabaseConnection.h"
 #include <QSqlError>
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <utility>
 
-DatabaseConnection::DatabaseConnection()
-    : m_connected(false)
+namespace {
+
+std::atomic<int> nextPoolId{1};
+
+// Prepared statements cached per connection
+constexpr int MaxCachedStatements = 64;
+
+/**
+ * @brief PooledConnection - One thread's connection and its statement cache
+ */
+struct PooledConnection {
+    QString name;
+    QSqlDatabase database;
+    QHash<QString, std::shared_ptr<QSqlQuery>> statements;
+    QSqlQuery uncached;             // Returned by prepared() for statements kept out of the cache
+    QElapsedTimer lastUsed;
+    // The idle connection this one replaced. Callers may still hold copies of
+    // its QSqlDatabase or queries on it, so it is removed one reopen later
+    std::shared_ptr<PooledConnection> retired;
+};
+
+struct Settings {
+    QString driver;
+    QString databaseName;
+    QString host;
+    QString user;
+    QString password;
+    int port = -1;
+    QString options;
+    bool memory = false;            // Shared in-memory SQLite; dies with its last connection
+};
+
+// Our own statements, which callers reach only through prepared()
+void clearStatements(PooledConnection& connection)
 {
+    connection.statements.clear();
+    connection.uncached = QSqlQuery();
 }
 
-DatabaseConnection::~DatabaseConnection()
+// Queries hold the connection; they go first
+void closeConnection(PooledConnection& connection)
 {
-    if (m_connected) {
-        m_database.close();
+    if (connection.retired) {
+        closeConnection(*connection.retired);
+        connection.retired.reset();
     }
+    clearStatements(connection);
+    connection.database.close();
+    connection.database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connection.name);
 }
 
-bool DatabaseConnection::connectSQLite(const QString &databasePath)
+}
+
+struct DatabaseConnection::Pool {
+    const int id = nextPoolId++;
+
+    mutable QMutex mutex;
+    Settings settings;
+    bool configured = false;
+    int idleTimeoutMs = DefaultIdleTimeoutMs;
+    int serial = 0;
+    QString lastError;
+    QHash<Qt::HANDLE, std::shared_ptr<PooledConnection>> connections;
+
+    std::shared_ptr<PooledConnection> acquire(const std::shared_ptr<Pool>& self);
+    void release(Qt::HANDLE thread);
+    void closeAll();
+    bool open(PooledConnection& connection, const Settings& settings);
+};
+
+namespace {
+
+/**
+ * @brief ThreadConnections - Closes a thread's pooled connections when it exits
+ */
+struct ThreadConnections {
+    QVector<std::weak_ptr<DatabaseConnection::Pool>> pools;
+
+    ~ThreadConnections()
+    {
+        const Qt::HANDLE thread = QThread::currentThreadId();
+        for (const auto& weak : pools) {
+            if (auto pool = weak.lock()) {
+                pool->release(thread);
+            }
+        }
+    }
+
+    void add(const std::shared_ptr<DatabaseConnection::Pool>& pool)
+    {
+        for (const auto& weak : pools) {
+            if (!weak.owner_before(pool) && !pool.owner_before(weak)) {
+                return;
+            }
+        }
+        pools.removeIf([](const auto& weak) { return weak.expired(); });
+        pools.append(pool);
+    }
+};
+
+thread_local ThreadConnections threadConnections;
+
+}
+
+std::shared_ptr<PooledConnection> DatabaseConnection::Pool::acquire(const std::shared_ptr<Pool>& self)
+{
+    const Qt::HANDLE thread = QThread::currentThreadId();
+    std::shared_ptr<PooledConnection> connection;
+    std::shared_ptr<PooledConnection> stale;
+    Settings current;
+    {
+        QMutexLocker locker(&mutex);
+        if (!configured) {
+            return nullptr;
+        }
+        connection = connections.value(thread);
+        // Закрытие последнего соединения уничтожило бы базу в памяти
+        if (connection && idleTimeoutMs > 0 && !settings.memory && connection->lastUsed.hasExpired(idleTimeoutMs)) {
+            stale = std::move(connection);
+            connections.remove(thread);
+        }
+        if (connection) {
+            connection->lastUsed.start();
+            return connection;
+        }
+        connection = std::make_shared<PooledConnection>();
+        connection->name = QString("labyrinth_%1_%2").arg(id).arg(++serial);
+        connections.insert(thread, connection);
+        current = settings;
+    }
+
+    if (stale) {
+        // Not removed yet: handles taken before the timeout may still be in
+        // scope. The one it replaced has been idle a whole timeout since
+        if (stale->retired) {
+            closeConnection(*stale->retired);
+            stale->retired.reset();
+        }
+        clearStatements(*stale);
+        connection->retired = std::move(stale);
+    }
+    threadConnections.add(self);
+
+    if (!open(*connection, current)) {
+        const QString error = connection->database.lastError().text();
+        {
+            QMutexLocker locker(&mutex);
+            lastError = error;
+            connections.remove(thread);
+        }
+        qCritical() << "Database connection failed:" << error;
+        closeConnection(*connection);
+        return nullptr;
+    }
+    connection->lastUsed.start();
+    return connection;
+}
+
+bool DatabaseConnection::Pool::open(PooledConnection& connection, const Settings& settings)
+{
+    connection.database = QSqlDatabase::addDatabase(settings.driver, connection.name);
+    connection.database.setDatabaseName(settings.databaseName);
+    if (!settings.host.isEmpty()) {
+        connection.database.setHostName(settings.host);
+        connection.database.setUserName(settings.user);
+        connection.database.setPassword(settings.password);
+        connection.database.setPort(settings.port);
+    }
+    connection.database.setConnectOptions(settings.options);
+    if (!connection.database.open()) {
+        return false;
+    }
+
+    if (settings.driver == "QSQLITE" && !settings.memory) {
+        // WAL: читатели не блокируют писателя; NORMAL достаточно для WAL.
+        // auto_vacuum действует только на новый файл: чистка сохранений сможет вернуть место
+        QSqlQuery query(connection.database);
+        if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL")
+            || !query.exec("PRAGMA journal_mode = WAL") || !query.exec("PRAGMA synchronous = NORMAL")) {
+            qWarning() << "Failed to enable WAL:" << query.lastError().text();
+        }
+    }
+    return true;
+}
+
+void DatabaseConnection::Pool::release(Qt::HANDLE thread)
 {
-    // Если уже подключены, закрываем старое соединение
-    if (m_connected && m_database.isOpen()) {
-        m_database.close();
-        m_connected = false;
+    std::shared_ptr<PooledConnection> connection;
+    {
+        QMutexLocker locker(&mutex);
+        connection = connections.take(thread);
     }
+    if (connection) {
+        closeConnection(*connection);
+    }
+}
 
-    // Удаляем старое соединение если оно существует
-    if (QSqlDatabase::contains(QSqlDatabase::defaultConnection)) {
-        QSqlDatabase::removeDatabase(QSqlDatabase::defaultConnection);
+void DatabaseConnection::Pool::closeAll()
+{
+    QHash<Qt::HANDLE, std::shared_ptr<PooledConnection>> closing;
+    {
+        QMutexLocker locker(&mutex);
+        closing.swap(connections);
+        configured = false;
     }
+    for (const auto& connection : std::as_const(closing)) {
+        closeConnection(*connection);
+    }
+}
 
-    m_database = QSqlDatabase::addDatabase("QSQLITE");
-    m_database.setDatabaseName(databasePath);
+DatabaseConnection::DatabaseConnection()
+    : m_pool(std::make_shared<Pool>())
+{
+}
+
+DatabaseConnection::~DatabaseConnection()
+{
+    m_pool->closeAll();
+}
+
+bool DatabaseConnection::connectSQLite(const QString &databasePath)
+{
+    // Переподключение закрывает соединения всех потоков
+    m_pool->closeAll();
+
+    Settings settings;
+    settings.driver = "QSQLITE";
+    settings.options = "QSQLITE_BUSY_TIMEOUT=5000";
+    if (databasePath == ":memory:") {
+        // Общий кэш: все потоки пула видят одну базу в памяти
+        settings.databaseName = QString("file:labyrinth_%1?mode=memory&cache=shared").arg(m_pool->id);
+        settings.options += ";QSQLITE_OPEN_URI";
+        settings.memory = true;
+    } else {
+        settings.databaseName = databasePath;
+    }
 
     qDebug() << "Available SQL drivers:" << QSqlDatabase::drivers();
 
-    if (!m_database.open()) {
-        m_lastError = m_database.lastError().text();
-        qCritical() << "SQLite connection failed:" << m_lastError;
+    {
+        QMutexLocker locker(&m_pool->mutex);
+        m_pool->settings = settings;
+        m_pool->configured = true;
+    }
+    // The calling thread's connection opens now so errors surface here
+    if (!m_pool->acquire(m_pool)) {
+        QMutexLocker locker(&m_pool->mutex);
+        m_pool->configured = false;
+        qCritical() << "SQLite connection failed:" << m_pool->lastError;
         return false;
     }
 
-    m_connected = true;
     qDebug() << "Connected to SQLite database:" << databasePath;
     return true;
 }
@@ -47,56 +270,96 @@ bool DatabaseConnection::connectSQLite(const QString &databasePath)
 bool DatabaseConnection::connect(const QString &host, const QString &database,
                                 const QString &user, const QString &password, int port)
 {
-    if (m_connected) {
+    if (isConnected()) {
         return true;
     }
 
-    m_database = QSqlDatabase::addDatabase("QMYSQL");
-    m_database.setHostName(host);
-    m_database.setDatabaseName(database);
-    m_database.setUserName(user);
-    m_database.setPassword(password);
-    m_database.setPort(port);
+    Settings settings;
+    settings.driver = "QMYSQL";
+    settings.databaseName = database;
+    settings.host = host;
+    settings.user = user;
+    settings.password = password;
+    settings.port = port;
 
-    if (!m_database.open()) {
-        m_lastError = m_database.lastError().text();
-        qCritical() << "MySQL connection failed:" << m_lastError;
+    {
+        QMutexLocker locker(&m_pool->mutex);
+        m_pool->settings = settings;
+        m_pool->configured = true;
+    }
+    if (!m_pool->acquire(m_pool)) {
+        QMutexLocker locker(&m_pool->mutex);
+        m_pool->configured = false;
+        qCritical() << "MySQL connection failed:" << m_pool->lastError;
         return false;
     }
 
-    m_connected = true;
     qDebug() << "Connected to MySQL database:" << database;
     return true;
 }
 
 bool DatabaseConnection::isConnected() const
 {
-    return m_connected && m_database.isOpen();
+    QMutexLocker locker(&m_pool->mutex);
+    return m_pool->configured;
 }
 
 QSqlDatabase DatabaseConnection::getDatabase()
 {
-    return m_database;
+    const std::shared_ptr<PooledConnection> connection = m_pool->acquire(m_pool);
+    return connection ? connection->database : QSqlDatabase();
+}
+
+QSqlQuery& DatabaseConnection::prepared(const QString &sql)
+{
+    static thread_local QSqlQuery disconnected;
+    const std::shared_ptr<PooledConnection> connection = m_pool->acquire(m_pool);
+    if (!connection) {
+        disconnected = QSqlQuery();
+        return disconnected;
+    }
+
+    // Only the owning thread touches its cache
+    const auto cached = connection->statements.constFind(sql);
+    if (cached != connection->statements.constEnd()) {
+        QSqlQuery& query = **cached;
+        query.finish();
+        return query;
+    }
+
+    // A failed prepare is not cached: the table may exist by the next call.
+    // A full cache is not evicted, callers may still hold its queries
+    auto query = std::make_shared<QSqlQuery>(connection->database);
+    if (!query->prepare(sql) || connection->statements.size() >= MaxCachedStatements) {
+        connection->uncached = std::move(*query);
+        return connection->uncached;
+    }
+    connection->statements.insert(sql, query);
+    return *query;
 }
 
 QString DatabaseConnection::getLastError() const
 {
-    return m_lastError;
+    QMutexLocker locker(&m_pool->mutex);
+    return m_pool->lastError;
 }
 
 void DatabaseConnection::disconnect()
 {
-    if (m_connected) {
-        QString connectionName = m_database.connectionName();
-        m_database.close();
-        m_connected = false;
-
-        // Удаляем соединение из пула Qt
-        if (QSqlDatabase::contains(connectionName)) {
-            QSqlDatabase::removeDatabase(connectionName);
-        }
-
+    if (isConnected()) {
+        m_pool->closeAll();
         qDebug() << "Database disconnected";
     }
 }
 
+void DatabaseConnection::setIdleTimeout(int milliseconds)
+{
+    QMutexLocker locker(&m_pool->mutex);
+    m_pool->idleTimeoutMs = milliseconds;
+}
+
+int DatabaseConnection::connectionCount() const
+{
+    QMutexLocker locker(&m_pool->mutex);
+    return static_cast<int>(m_pool->connections.size());
+}
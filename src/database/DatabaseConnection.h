@@ -3,26 +3,63 @@
 
 #include <QString>
 #include <QSqlDatabase>
+#include <QSqlQuery>
+#include <memory>
 
+/**
+ * @brief DatabaseConnection - Pool of per-thread connections to one database
+ *
+ * A QSqlDatabase may only be used by the thread that opened it, so each
+ * thread gets its own uniquely named connection, opened on first use and
+ * closed when the thread exits. Every connection caches its prepared
+ * statements; one left idle past the idle timeout is reopened fresh on its
+ * next use. The idle one is closed on the reopen after that, so handles
+ * still holding it don't point at a removed connection. SQLite files are
+ * switched to WAL so readers on one thread do not block a writer on another.
+ */
 class DatabaseConnection {
 public:
+    static constexpr int DefaultIdleTimeoutMs = 60000;
+
     DatabaseConnection();
     ~DatabaseConnection();
 
+    DatabaseConnection(const DatabaseConnection&) = delete;
+    DatabaseConnection& operator=(const DatabaseConnection&) = delete;
+
+    // ":memory:" is one in-memory database shared by the threads of this pool
     bool connectSQLite(const QString &databasePath);
     bool connect(const QString &host, const QString &database,
                 const QString &user, const QString &password, int port = 3306);
 
     bool isConnected() const;
+
+    // Connection of the calling thread, opened on first use
     QSqlDatabase getDatabase();
+
+    /**
+     * @brief Prepared statement of the calling thread's connection
+     *
+     * Cached by SQL text and reset for reuse; bind and exec it right away.
+     * The reference stays valid until the thread's next getDatabase() or
+     * prepared() call after the idle timeout.
+     */
+    QSqlQuery& prepared(const QString &sql);
+
     QString getLastError() const;
+
+    // Close every thread's connection; no thread may be using the pool
     void disconnect();
 
+    // 0 keeps connections open until their thread exits
+    void setIdleTimeout(int milliseconds);
+    int connectionCount() const;
+
+    // Shared with the hooks that close a thread's connections at its exit
+    struct Pool;
+
 private:
-    QSqlDatabase m_database;
-    bool m_connected;
-    QString m_lastError;
+    std::shared_ptr<Pool> m_pool;
 };
 
 #endif // DATABASECONNECTION_H
-
@@ -10,52 +10,224 @@
 #include <QCoreApplication>
 #include "../core/Constants.h"
 #include <QDir>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QStringList>
+#include "SqlScript.h"
+#include "SaveStore.h"
 
-DatabaseManager::DatabaseManager()
-    : m_connection(std::make_unique<DatabaseConnection>())
+namespace {
+
+quint64 fnv1a64(QByteArrayView data)
 {
+    quint64 hash = 14695981039346656037ull;
+    for (char c : data) {
+        hash ^= static_cast<quint8>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
 }
 
-DatabaseManager::~DatabaseManager() = default;
+// Rows bound per execBatch; keeps the bound columns of a huge run bounded
+constexpr int InsertBatchRows = 8192;
 
-bool DatabaseManager::shouldReinitialize()
+// Tables whose rows come in bulk from the content team's generators
+bool isContentTable(QByteArrayView table)
 {
-    // Проверяем последнюю модификацию SQL файла
-    QFileInfo sqlFileInfo("../src/database/game_database.sql");
-    QFileInfo dbFileInfo("../src/database/maze_game.db");
+    for (const char* name : {"locations", "riddles", "notes", "items"}) {
+        if (table.compare(name, Qt::CaseInsensitive) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    if (sqlFileInfo.exists() && dbFileInfo.exists()) {
-        return sqlFileInfo.lastModified() > dbFileInfo.lastModified();
+/**
+ * @brief InsertBatch - Run of same-shaped INSERTs bound as columns for execBatch
+ */
+class InsertBatch {
+public:
+    bool isEmpty() const { return m_statements == 0; }
+    int rows() const { return m_rows; }
+    int statements() const { return m_statements; }
+    qsizetype offset() const { return m_offset; }
+
+    bool accepts(const SqlInsert& insert) const
+    {
+        return isEmpty() || (insert.head == m_head && insert.columns == m_columns.size());
     }
 
-    return false;
+    void add(const SqlInsert& insert, qsizetype offset)
+    {
+        if (isEmpty()) {
+            m_head = insert.head.toByteArray();
+            m_offset = offset;
+            m_columns.resize(insert.columns);
+        }
+        for (qsizetype i = 0; i < insert.values.size(); ++i) {
+            m_columns[i % insert.columns].append(insert.values[i]);
+        }
+        m_rows += static_cast<int>(insert.values.size() / insert.columns);
+        m_statements++;
+    }
+
+    // One prepared statement for the whole run
+    bool exec(const QSqlDatabase& db, QString& error)
+    {
+        QStringList placeholders;
+        for (int i = 0; i < m_columns.size(); ++i) {
+            placeholders.append("?");
+        }
+        QSqlQuery query(db);
+        bool ok = query.prepare(QString::fromUtf8(m_head) + " VALUES (" + placeholders.join(", ") + ")");
+        if (ok) {
+            for (const QVariantList& column : m_columns) {
+                query.addBindValue(column);
+            }
+            ok = query.execBatch();
+        }
+        if (!ok) {
+            error = query.lastError().text();
+        }
+
+        m_columns.clear();
+        m_rows = 0;
+        m_statements = 0;
+        return ok;
+    }
+
+private:
+    QByteArray m_head;
+    QVector<QVariantList> m_columns;
+    qsizetype m_offset = 0;
+    int m_rows = 0;
+    int m_statements = 0;
+};
+
+/**
+ * @brief ImportPragmas - SQLite settings for a bulk import, restored on scope exit
+ *
+ * The journal mode is left alone: saved games live in the same file, and an
+ * in-memory journal would let a crash mid-import corrupt them.
+ */
+class ImportPragmas {
+public:
+    explicit ImportPragmas(const QSqlDatabase& db)
+        : m_db(db)
+        , m_synchronous(value("synchronous"))
+        , m_cacheSize(value("cache_size"))
+        , m_tempStore(value("temp_store"))
+    {
+        set("synchronous", "OFF");
+        set("cache_size", "-65536");    // 64 MiB
+        set("temp_store", "MEMORY");
+    }
+
+    ~ImportPragmas()
+    {
+        set("synchronous", m_synchronous);
+        set("cache_size", m_cacheSize);
+        set("temp_store", m_tempStore);
+    }
+
+private:
+    QString value(const char* name) const
+    {
+        QSqlQuery query(m_db);
+        if (query.exec(QString("PRAGMA %1").arg(QLatin1String(name))) && query.next()) {
+            return query.value(0).toString();
+        }
+        return QString();
+    }
+
+    void set(const char* name, const QString& value) const
+    {
+        if (value.isEmpty()) {
+            return;
+        }
+        QSqlQuery query(m_db);
+        if (!query.exec(QString("PRAGMA %1 = %2").arg(QLatin1String(name), value))) {
+            qWarning() << "Failed to set PRAGMA" << name << ":" << query.lastError().text();
+        }
+    }
+
+    QSqlDatabase m_db;
+    QString m_synchronous;
+    QString m_cacheSize;
+    QString m_tempStore;
+};
+
 }
 
+DatabaseManager::DatabaseManager()
+    : m_connection(std::make_unique<DatabaseConnection>())
+    , m_saves(std::make_unique<SaveStore>(*m_connection))
+{
+}
+
+DatabaseManager::~DatabaseManager() = default;
+
 bool DatabaseManager::connect()
 {
-    QString dbPath = "../src/database/maze_game.db";
+    return connect(defaultDatabasePath(), defaultSqlPath());
+}
+
+QString DatabaseManager::defaultDatabasePath()
+{
+    return "../src/database/maze_game.db";
+}
+
+QString DatabaseManager::defaultSqlPath()
+{
+    return "../src/database/game_database.sql";
+}
 
+bool DatabaseManager::connect(const QString& dbPath, const QString& sqlPath)
+{
+    QElapsedTimer timer;
+    timer.start();
 
     if (!m_connection->connectSQLite(dbPath)) {
-        m_lastError = m_connection->getLastError();
-        qCritical() << "Failed to connect to SQLite:" << m_lastError;
+        setLastError(m_connection->getLastError());
+        qCritical() << "Failed to connect to SQLite:" << getLastError();
         return false;
     }
 
-    QString sqlPath = "../src/database/game_database.sql";
-
-    if (!loadSqlFile(sqlPath)) {
-        m_lastError = "Failed to load database from SQL file";
+    QFile file(sqlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Без исходника работаем с тем, что уже импортировано
+        if (isDatabaseInitialized()) {
+            qWarning() << "Cannot open SQL file:" << sqlPath << "- using the existing database";
+            return ensureSaveSchema();
+        }
+        qCritical() << "Cannot open SQL file:" << sqlPath;
+        qCritical() << "Current dir:" << QDir::currentPath();
+        setLastError("Cannot open SQL file: " + sqlPath);
         return false;
     }
+    // Mapped, not read: the tokenizer works on views of the file
+    QByteArray buffer;
+    const uchar* mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (!mapped) {
+        buffer = file.readAll();
+    }
+    const QByteArrayView sqlData = mapped ? QByteArrayView(mapped, file.size()) : QByteArrayView(buffer);
 
-    qDebug() << "Database initialized successfully!";
-    return true;
-}
-
-
+    const QString version = contentVersion(sqlData);
+    if (storedContentVersion() == version && isDatabaseInitialized()) {
+        qDebug() << "Database content is up to date (" << version << "), opened in"
+                 << timer.elapsed() << "ms";
+        return ensureSaveSchema();
+    }
 
+    if (!migrate(sqlData, version)) {
+        setLastError("Failed to load database from SQL file");
+        return false;
+    }
 
+    qDebug() << "Database initialized successfully in" << timer.elapsed() << "ms";
+    return ensureSaveSchema();
+}
 
 bool DatabaseManager::isConnected() const
 {
@@ -84,64 +256,36 @@ bool DatabaseManager::isDatabaseInitialized()
     return false;
 }
 
-bool DatabaseManager::loadSqlFile(const QString &filePath)
+bool DatabaseManager::ensureSaveSchema()
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        qCritical() << "Cannot open SQL file:" << filePath;
-        qCritical() << "Current dir:" << QDir::currentPath();
-        m_lastError = "Cannot open SQL file: " + filePath;
+    if (!m_saves->ensureSchema()) {
+        setLastError(m_saves->getLastError());
         return false;
     }
+    return true;
+}
 
-    QByteArray sqlData = file.readAll();
-    file.close();
-
-    QString sqlContent = QString::fromUtf8(sqlData);
-
-    qDebug() << "SQL file loaded, size:" << sqlContent.length() << "bytes";
-
-    // КРИТИЧНО: Принудительная замена AUTO_INCREMENT -> AUTOINCREMENT
-    sqlContent.replace(QRegularExpression("AUTO_INCREMENT", QRegularExpression::CaseInsensitiveOption),
-                      "AUTOINCREMENT");
-
-    // Разбиваем на отдельные операторы вручную
-    QStringList statements;
-    QString currentStatement;
-    bool inString = false;
-
-    for (int i = 0; i < sqlContent.length(); i++) {
-        QChar c = sqlContent[i];
-
-        // Отслеживаем строки (чтобы не разбивать по ; внутри строк)
-        if (c == '\'' && (i == 0 || sqlContent[i-1] != '\\')) {
-            inString = !inString;
-        }
-
-        // Пропускаем комментарии --
-        if (!inString && c == '-' && i + 1 < sqlContent.length() && sqlContent[i+1] == '-') {
-            // Пропускаем до конца строки
-            while (i < sqlContent.length() && sqlContent[i] != '\n') {
-                i++;
-            }
-            continue;
-        }
-
-        currentStatement += c;
+QString DatabaseManager::contentVersion(QByteArrayView sqlData)
+{
+    return QString("%1:%2").arg(DB_SCHEMA_VERSION).arg(fnv1a64(sqlData), 16, 16, QChar('0'));
+}
 
-        // Разделяем по ; вне строк
-        if (!inString && c == ';') {
-            QString stmt = currentStatement.trimmed();
-            if (!stmt.isEmpty() && !stmt.startsWith("--")) {
-                statements.append(stmt);
-            }
-            currentStatement.clear();
-        }
+QString DatabaseManager::storedContentVersion()
+{
+    QSqlQuery query(m_connection->getDatabase());
+    // Таблицы может не быть в базе, созданной до версионирования
+    if (!query.exec("SELECT version FROM content_version WHERE id = 1") || !query.next()) {
+        return QString();
     }
+    return query.value(0).toString();
+}
 
-    qDebug() << "Found" << statements.size() << "SQL statements";
+bool DatabaseManager::migrate(QByteArrayView sqlData, const QString& version)
+{
+    qDebug() << "Importing SQL file, size:" << sqlData.size() << "bytes";
 
     QSqlDatabase db = m_connection->getDatabase();
+    ImportPragmas pragmas(db);
 
     if (!db.transaction()) {
         qWarning() << "Failed to start transaction:" << db.lastError().text();
@@ -151,16 +295,87 @@ bool DatabaseManager::loadSqlFile(const QString &filePath)
     int successCount = 0;
     int failCount = 0;
 
-    for (const QString &stmt : statements) {
-        if (query.exec(stmt)) {
+    // Подряд идущие INSERT одной формы в таблицы контента выполняются
+    // одним подготовленным запросом через execBatch
+    InsertBatch batch;
+    SqlInsert insert;
+    const auto flushBatch = [&]() {
+        if (batch.isEmpty()) {
+            return;
+        }
+        const int statements = batch.statements();
+        const qsizetype offset = batch.offset();
+        QString error;
+        if (batch.exec(db, error)) {
+            successCount += statements;
+        } else {
+            failCount += statements;
+            qCritical() << "✗ FAIL in" << statements << "inserts from line"
+                        << SqlScriptReader::lineAt(sqlData, offset) << ":" << error;
+        }
+    };
+
+    // Операторы читаются из файла по одному, без копии всего скрипта
+    SqlScriptReader reader(sqlData);
+    SqlStatement statement;
+    while (reader.next(statement)) {
+        if (SqlScriptReader::parseInsert(statement.text, insert) && isContentTable(insert.table)) {
+            if (!batch.accepts(insert)) {
+                flushBatch();
+            }
+            batch.add(insert, statement.offset);
+            if (batch.rows() >= InsertBatchRows) {
+                flushBatch();
+            }
+            continue;
+        }
+        flushBatch();
+
+        QString text = QString::fromUtf8(statement.text);
+        if (statement.autoIncrement) {
+            // MySQL-дамп: AUTO_INCREMENT -> AUTOINCREMENT
+            text.replace("AUTO_INCREMENT", "AUTOINCREMENT", Qt::CaseInsensitive);
+        }
+
+        if (query.exec(text)) {
             successCount++;
-            qDebug() << "✓ OK:" << stmt.left(60) + "...";
         } else {
             failCount++;
-            qCritical() << "✗ FAIL:" << query.lastError().text();
-            qCritical() << "Statement:" << stmt.left(150);
+            qCritical() << "✗ FAIL at line" << SqlScriptReader::lineAt(sqlData, statement.offset)
+                        << ":" << query.lastError().text();
+            qCritical() << "Statement:" << text.left(150);
         }
     }
+    flushBatch();
+    if (reader.isTruncated()) {
+        failCount++;
+        qCritical() << "SQL file ends inside a string or a comment";
+    }
+
+    // Версия пишется только после полностью успешного импорта,
+    // иначе следующий запуск повторит миграцию
+    if (successCount == 0 || failCount > 0) {
+        db.rollback();
+        qCritical() << "SQL import failed, rolled back. Success:" << successCount << "Failed:" << failCount;
+        return false;
+    }
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS content_version ("
+                    "id INTEGER PRIMARY KEY CHECK (id = 1), "
+                    "version TEXT NOT NULL, "
+                    "imported_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP)")) {
+        qCritical() << "Failed to create content_version:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
+    query.prepare("INSERT OR REPLACE INTO content_version (id, version, imported_at) "
+                  "VALUES (1, :version, CURRENT_TIMESTAMP)");
+    query.bindValue(":version", version);
+    if (!query.exec()) {
+        qCritical() << "Failed to record content version:" << query.lastError().text();
+        db.rollback();
+        return false;
+    }
 
     if (!db.commit()) {
         qCritical() << "Failed to commit transaction:" << db.lastError().text();
@@ -168,9 +383,9 @@ bool DatabaseManager::loadSqlFile(const QString &filePath)
         return false;
     }
 
-    qDebug() << "SQL execution completed. Success:" << successCount << "Failed:" << failCount;
-
-    return successCount > 0 && failCount == 0;
+    qDebug() << "SQL execution completed. Success:" << successCount << "Failed:" << failCount
+             << "- content version" << version;
+    return true;
 }
 
 
@@ -179,12 +394,11 @@ QVector<LocationData> DatabaseManager::loadLocations()
 {
     QVector<LocationData> locations;
 
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("SELECT id, name, theme, description FROM locations ORDER BY id");
+    QSqlQuery& query = m_connection->prepared("SELECT id, name, theme, description FROM locations ORDER BY id");
 
     if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to load locations:" << m_lastError;
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to load locations:" << query.lastError().text();
         return locations;
     }
 
@@ -205,12 +419,11 @@ QVector<RiddleData> DatabaseManager::loadRiddles()
 {
     QVector<RiddleData> riddles;
 
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("SELECT id, question, answer, difficulty FROM riddles ORDER BY RANDOM()");
+    QSqlQuery& query = m_connection->prepared("SELECT id, question, answer, difficulty FROM riddles ORDER BY id");
 
     if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to load riddles:" << m_lastError;
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to load riddles:" << query.lastError().text();
         return riddles;
     }
 
@@ -231,12 +444,11 @@ QVector<NoteData> DatabaseManager::loadNotes()
 {
     QVector<NoteData> notes;
 
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("SELECT id, content, location_id FROM notes ORDER BY RANDOM()");
+    QSqlQuery& query = m_connection->prepared("SELECT id, content, location_id FROM notes ORDER BY id");
 
     if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to load notes:" << m_lastError;
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to load notes:" << query.lastError().text();
         return notes;
     }
 
@@ -256,12 +468,11 @@ QVector<ItemData> DatabaseManager::loadItems()
 {
     QVector<ItemData> items;
 
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("SELECT id, type, name, description, rarity FROM items");
+    QSqlQuery& query = m_connection->prepared("SELECT id, type, name, description, rarity FROM items");
 
     if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to load items:" << m_lastError;
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to load items:" << query.lastError().text();
         return items;
     }
 
@@ -289,54 +500,32 @@ QVector<ItemData> DatabaseManager::loadItems()
     return items;
 }
 
-bool DatabaseManager::saveGameState(const QString& playerName, int goldBars, int currentLocation,
-                                    const QString& inventoryJson, const QString& logsJson)
+bool DatabaseManager::saveGameState(const QString& playerName, const GameState& state)
 {
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("INSERT INTO game_saves (player_name, gold_bars, current_location, inventory, logs) "
-                  "VALUES (:player, :gold, :location, :inventory, :logs)");
-
-    query.bindValue(":player", playerName);
-    query.bindValue(":gold", goldBars);
-    query.bindValue(":location", currentLocation);
-    query.bindValue(":inventory", inventoryJson);
-    query.bindValue(":logs", logsJson);
-
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to save game state:" << m_lastError;
+    if (!m_saves->save(playerName, state)) {
+        setLastError(m_saves->getLastError());
         return false;
     }
-
-    qDebug() << "Game state saved for player:" << playerName;
     return true;
 }
 
-bool DatabaseManager::loadGameState(const QString& playerName)
+bool DatabaseManager::loadGameState(const QString& playerName, GameState& state)
 {
-    QSqlQuery query(m_connection->getDatabase());
-    query.prepare("SELECT gold_bars, current_location, inventory, logs FROM game_saves "
-                  "WHERE player_name = :player ORDER BY saved_at DESC LIMIT 1");
-    query.bindValue(":player", playerName);
-
-    if (!query.exec()) {
-        m_lastError = query.lastError().text();
-        qCritical() << "Failed to load game state:" << m_lastError;
+    if (!m_saves->load(playerName, state)) {
+        setLastError(m_saves->getLastError());
         return false;
     }
-
-    if (query.next()) {
-        qDebug() << "Game state loaded for player:" << playerName;
-        qDebug() << "Gold bars:" << query.value(0).toInt();
-        qDebug() << "Current location:" << query.value(1).toInt();
-        return true;
-    }
-
-    qWarning() << "No saved game found for player:" << playerName;
-    return false;
+    return true;
 }
 
 QString DatabaseManager::getLastError() const
 {
+    QMutexLocker locker(&m_errorMutex);
     return m_lastError;
 }
+
+void DatabaseManager::setLastError(const QString& error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    m_lastError = error;
+}
@@ -1,12 +1,23 @@
 #ifndef DATABASEMANAGER_H
 #define DATABASEMANAGER_H
 
+#include <QByteArrayView>
+#include <QMutex>
 #include <QString>
 #include <QVector>
 #include <memory>
 #include "DatabaseConnection.h"
 #include "../core/Types.h"
 
+class GameState;
+class SaveStore;
+
+/**
+ * @brief DatabaseManager - Content import and queries over a per-thread connection pool
+ *
+ * Methods may be called from any thread; each runs on the calling thread's
+ * own connection.
+ */
 class DatabaseManager
 {
 public:
@@ -14,6 +25,8 @@ public:
     ~DatabaseManager();
 
     bool connect();
+    // Open dbPath (":memory:" works) and import sqlPath into it if its content version changed
+    bool connect(const QString& dbPath, const QString& sqlPath);
     bool isConnected() const;
 
     QVector<LocationData> loadLocations();
@@ -21,19 +34,39 @@ public:
     QVector<NoteData> loadNotes();
     QVector<ItemData> loadItems();
 
-    bool saveGameState(const QString& playerName, int goldBars, int currentLocation,
-                      const QString& inventoryJson, const QString& logsJson);
-    bool loadGameState(const QString& playerName);
+    // Saves store a GameSnapshot; rows from before snapshots restore without their log
+    bool saveGameState(const QString& playerName, const GameState& state);
+    bool loadGameState(const QString& playerName, GameState& state);
+
+    // History listing and retention; errors are reported by saves().getLastError()
+    SaveStore& saves() { return *m_saves; }
 
     QString getLastError() const;
 
+    // What connect() opens and imports, relative to the working directory
+    static QString defaultDatabasePath();
+    static QString defaultSqlPath();
+
+    // Content version of an SQL source: schema version and hash of the file
+    static QString contentVersion(QByteArrayView sqlData);
+
 private:
-    bool shouldReinitialize();
     std::unique_ptr<DatabaseConnection> m_connection;
+    std::unique_ptr<SaveStore> m_saves;
+    mutable QMutex m_errorMutex;
     QString m_lastError;
 
+    void setLastError(const QString& error);
+
     bool isDatabaseInitialized();
-    bool loadSqlFile(const QString &filePath);
+
+    // Save tables and indexes, whatever the SQL source created
+    bool ensureSaveSchema();
+
+    QString storedContentVersion();
+
+    // Re-import the SQL source and record its version in one transaction
+    bool migrate(QByteArrayView sqlData, const QString& version);
 };
 
 #endif // DATABASEMANAGER_H
@@ -0,0 +1,362 @@
+#include "SaveStore.h"
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+#include <QtSql/QSqlRecord>
+#include <QDebug>
+#include <QStringList>
+#include "../core/GameSnapshot.h"
+#include "../core/GameState.h"
+#include "../utils/JsonUtils.h"
+
+namespace {
+
+// Players whose saves are pruned per round of prune()
+constexpr int PrunePlayersPerPage = 256;
+
+// Free pages returned per vacuum transaction
+constexpr int VacuumPagesPerStep = 1024;
+
+// The newest save through latest_saves; the index is the fallback for a
+// pointer whose row was deleted by hand
+const char LatestSaveSql[] =
+    "SELECT gold_bars, current_location, inventory, snapshot FROM game_saves "
+    "WHERE id = (SELECT save_id FROM latest_saves WHERE player_name = :player)";
+const char NewestSaveSql[] =
+    "SELECT gold_bars, current_location, inventory, snapshot FROM game_saves "
+    "WHERE player_name = :player ORDER BY saved_at DESC, id DESC LIMIT 1";
+
+bool restoreSave(int goldBars, int location, const QString& inventoryJson, const QByteArray& snapshotData,
+                 GameState& state)
+{
+    if (!snapshotData.isEmpty()) {
+        GameSnapshot snapshot;
+        return GameSnapshot::read(snapshotData, snapshot) && snapshot.restore(state);
+    }
+
+    // Сохранение до снимков: лог хранился готовыми строками и не восстанавливается
+    QVector<ItemType> inventory;
+    for (int item : JsonUtils::inventoryFromJson(inventoryJson)) {
+        if (item == static_cast<int>(ItemType::SILVER_KEY) || item == static_cast<int>(ItemType::GOLD_KEY)) {
+            inventory.append(static_cast<ItemType>(item));
+        }
+    }
+    state = GameState();
+    state.setGoldBars(goldBars)
+         .setCurrentLocationIndex(location)
+         .setInventory(inventory.mid(0, MAX_INVENTORY_SIZE));
+    return true;
+}
+
+bool isCancelled(const std::atomic<bool>* cancel)
+{
+    return cancel && cancel->load();
+}
+
+}
+
+SaveStore::SaveStore(DatabaseConnection& connection)
+    : m_connection(connection)
+{
+}
+
+bool SaveStore::ensureSchema()
+{
+    QSqlDatabase db = m_connection.getDatabase();
+    QSqlQuery query(db);
+    const bool hasLatest = db.tables().contains("latest_saves");
+
+    if (!db.transaction()) {
+        setLastError(db.lastError().text());
+        return false;
+    }
+    auto fail = [&](const char* what) {
+        setLastError(query.lastError().text());
+        qCritical() << what << getLastError();
+        db.rollback();
+        return false;
+    };
+
+    if (!query.exec("CREATE TABLE IF NOT EXISTS game_saves ("
+                    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+                    "player_name TEXT NOT NULL, "
+                    "gold_bars INTEGER, "
+                    "current_location INTEGER, "
+                    "inventory TEXT, "
+                    "logs TEXT, "
+                    "snapshot BLOB, "
+                    "saved_at TEXT DEFAULT CURRENT_TIMESTAMP)")) {
+        return fail("Failed to create game_saves:");
+    }
+    // Таблица из старого SQL-исходника: снимок добавляется отдельной колонкой
+    if (!db.record("game_saves").contains("snapshot")
+        && !query.exec("ALTER TABLE game_saves ADD COLUMN snapshot BLOB")) {
+        return fail("Failed to add the snapshot column:");
+    }
+    // Покрывающий индекс: история читается без обращения к строкам таблицы
+    if (!query.exec("CREATE INDEX IF NOT EXISTS game_saves_history "
+                    "ON game_saves (player_name, saved_at, id, gold_bars, current_location)")) {
+        return fail("Failed to create the save history index:");
+    }
+    if (!query.exec("CREATE TABLE IF NOT EXISTS latest_saves ("
+                    "player_name TEXT PRIMARY KEY, "
+                    "save_id INTEGER NOT NULL) WITHOUT ROWID")) {
+        return fail("Failed to create latest_saves:");
+    }
+    if (!hasLatest
+        && !query.exec("INSERT OR REPLACE INTO latest_saves (player_name, save_id) "
+                       "SELECT player_name, MAX(id) FROM game_saves GROUP BY player_name")) {
+        return fail("Failed to fill latest_saves:");
+    }
+    if (!query.exec("CREATE TRIGGER IF NOT EXISTS game_saves_latest AFTER INSERT ON game_saves BEGIN "
+                    "INSERT OR REPLACE INTO latest_saves (player_name, save_id) VALUES (NEW.player_name, NEW.id); "
+                    "END")) {
+        return fail("Failed to create the latest save trigger:");
+    }
+
+    if (!db.commit()) {
+        setLastError(db.lastError().text());
+        db.rollback();
+        return false;
+    }
+    return true;
+}
+
+bool SaveStore::save(const QString& playerName, const GameState& state)
+{
+    QSqlQuery& query = m_connection.prepared("INSERT INTO game_saves (player_name, gold_bars, current_location, snapshot) "
+                                             "VALUES (:player, :gold, :location, :snapshot)");
+
+    query.bindValue(":player", playerName);
+    query.bindValue(":gold", state.getGoldBars());
+    query.bindValue(":location", state.getCurrentLocationIndex());
+    query.bindValue(":snapshot", GameSnapshot::encode(state));
+
+    if (!query.exec()) {
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to save game state:" << query.lastError().text();
+        return false;
+    }
+
+    qDebug() << "Game state saved for player:" << playerName;
+    return true;
+}
+
+bool SaveStore::load(const QString& playerName, GameState& state)
+{
+    for (const char* sql : {LatestSaveSql, NewestSaveSql}) {
+        QSqlQuery& query = m_connection.prepared(sql);
+        query.bindValue(":player", playerName);
+
+        if (!query.exec()) {
+            setLastError(query.lastError().text());
+            qCritical() << "Failed to load game state:" << query.lastError().text();
+            return false;
+        }
+        if (!query.next()) {
+            continue;
+        }
+
+        const int goldBars = query.value(0).toInt();
+        const int location = query.value(1).toInt();
+        const QString inventoryJson = query.value(2).toString();
+        const QByteArray snapshotData = query.value(3).toByteArray();
+        // Кэшированный запрос не должен держать снимок WAL до следующего вызова
+        query.finish();
+
+        if (!restoreSave(goldBars, location, inventoryJson, snapshotData, state)) {
+            setLastError("Corrupt or unsupported save for player: " + playerName);
+            qCritical() << getLastError();
+            return false;
+        }
+        qDebug() << "Game state loaded for player:" << playerName;
+        return true;
+    }
+
+    qWarning() << "No saved game found for player:" << playerName;
+    return false;
+}
+
+QVector<SaveInfo> SaveStore::history(const QString& playerName, int limit, const SaveInfo* after)
+{
+    QSqlQuery& query = m_connection.prepared(after
+        ? "SELECT id, saved_at, gold_bars, current_location FROM game_saves "
+          "WHERE player_name = :player AND (saved_at, id) < (:savedAt, :id) "
+          "ORDER BY saved_at DESC, id DESC LIMIT :limit"
+        : "SELECT id, saved_at, gold_bars, current_location FROM game_saves "
+          "WHERE player_name = :player "
+          "ORDER BY saved_at DESC, id DESC LIMIT :limit");
+    query.bindValue(":player", playerName);
+    query.bindValue(":limit", limit);
+    if (after) {
+        query.bindValue(":savedAt", after->savedAt);
+        query.bindValue(":id", after->id);
+    }
+
+    QVector<SaveInfo> page;
+    if (!query.exec()) {
+        setLastError(query.lastError().text());
+        qCritical() << "Failed to list saves:" << query.lastError().text();
+        return page;
+    }
+    page.reserve(limit);
+    while (query.next()) {
+        page.append({query.value(0).toLongLong(), query.value(1).toString(),
+                     query.value(2).toInt(), query.value(3).toInt()});
+    }
+    return page;
+}
+
+qint64 SaveStore::prune(const SaveRetention& retention, const std::atomic<bool>* cancel)
+{
+    QSqlDatabase db = m_connection.getDatabase();
+    QSqlQuery players(db);
+    QSqlQuery remove(db);
+    if (!players.prepare("SELECT player_name FROM latest_saves WHERE player_name > :after "
+                         "ORDER BY player_name LIMIT :limit")
+        || !remove.prepare("DELETE FROM game_saves WHERE id IN ("
+                           "SELECT id FROM game_saves WHERE player_name = :player "
+                           "ORDER BY saved_at DESC, id DESC LIMIT :batch OFFSET :keep)")) {
+        setLastError(players.lastError().isValid() ? players.lastError().text() : remove.lastError().text());
+        qCritical() << "Failed to prepare pruning:" << getLastError();
+        return -1;
+    }
+    const int batchRows = qMax(1, retention.batchRows);
+
+    qint64 pruned = 0;
+    QString after;
+    for (bool more = true; more && !isCancelled(cancel);) {
+        players.bindValue(":after", after);
+        players.bindValue(":limit", PrunePlayersPerPage);
+        if (!players.exec()) {
+            setLastError(players.lastError().text());
+            qCritical() << "Failed to list players for pruning:" << getLastError();
+            return -1;
+        }
+        QStringList names;
+        while (players.next()) {
+            names.append(players.value(0).toString());
+        }
+        players.finish();
+        more = names.size() == PrunePlayersPerPage;
+
+        // Короткие транзакции: сохранения игры не ждут всю чистку
+        if (!db.transaction()) {
+            setLastError(db.lastError().text());
+            return -1;
+        }
+        int pending = 0;
+        for (const QString& name : std::as_const(names)) {
+            int removed = 0;
+            do {
+                remove.bindValue(":player", name);
+                remove.bindValue(":batch", batchRows);
+                remove.bindValue(":keep", qMax(1, retention.keepPerPlayer));
+                if (!remove.exec()) {
+                    setLastError(remove.lastError().text());
+                    qCritical() << "Failed to prune saves:" << getLastError();
+                    db.rollback();
+                    return -1;
+                }
+                removed = remove.numRowsAffected();
+                pruned += removed;
+                pending += removed;
+                if (pending >= batchRows) {
+                    if (!db.commit() || !db.transaction()) {
+                        setLastError(db.lastError().text());
+                        db.rollback();
+                        return -1;
+                    }
+                    pending = 0;
+                }
+            } while (removed == batchRows && !isCancelled(cancel));
+            after = name;
+            if (isCancelled(cancel)) {
+                break;
+            }
+        }
+        if (!db.commit()) {
+            setLastError(db.lastError().text());
+            db.rollback();
+            return -1;
+        }
+    }
+
+    if (pruned > 0) {
+        qDebug() << "Pruned" << pruned << "old saves";
+        vacuum(cancel);
+    }
+    return pruned;
+}
+
+void SaveStore::vacuum(const std::atomic<bool>* cancel)
+{
+    QSqlQuery query(m_connection.getDatabase());
+    if (!query.exec("PRAGMA auto_vacuum") || !query.next()) {
+        return;
+    }
+    const int mode = query.value(0).toInt();
+
+    if (mode == 2) {
+        // INCREMENTAL: страницы возвращаются порциями, между ними можно остановиться.
+        // Each step of incremental_vacuum frees one page and Qt steps a PRAGMA
+        // once per exec(), so a portion is that many execs in one transaction
+        QSqlDatabase db = m_connection.getDatabase();
+        QSqlQuery step(db);
+        if (!step.prepare("PRAGMA incremental_vacuum")) {
+            return;
+        }
+        while (!isCancelled(cancel)) {
+            if (!query.exec("PRAGMA freelist_count") || !query.next()) {
+                break;
+            }
+            const qint64 portion = qMin<qint64>(query.value(0).toLongLong(), VacuumPagesPerStep);
+            query.finish();
+            if (portion == 0 || !db.transaction()) {
+                break;
+            }
+            for (qint64 i = 0; i < portion; ++i) {
+                if (!step.exec()) {
+                    qWarning() << "Incremental vacuum failed:" << step.lastError().text();
+                    db.rollback();
+                    return;
+                }
+            }
+            step.finish();
+            if (!db.commit()) {
+                db.rollback();
+                break;
+            }
+        }
+        return;
+    }
+
+    // Файл без auto_vacuum: один полный VACUUM переводит его в INCREMENTAL,
+    // если свободной стала хотя бы половина страниц
+    qint64 freePages = 0;
+    qint64 pages = 0;
+    if (query.exec("PRAGMA freelist_count") && query.next()) {
+        freePages = query.value(0).toLongLong();
+    }
+    if (query.exec("PRAGMA page_count") && query.next()) {
+        pages = query.value(0).toLongLong();
+    }
+    query.finish();
+    if (freePages * 2 < pages || isCancelled(cancel)) {
+        return;
+    }
+    if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL") || !query.exec("VACUUM")) {
+        qWarning() << "Vacuum failed:" << query.lastError().text();
+    }
+}
+
+QString SaveStore::getLastError() const
+{
+    QMutexLocker locker(&m_errorMutex);
+    return m_lastError;
+}
+
+void SaveStore::setLastError(const QString& error)
+{
+    QMutexLocker locker(&m_errorMutex);
+    m_lastError = error;
+}
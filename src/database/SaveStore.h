@@ -0,0 +1,68 @@
+#ifndef SAVESTORE_H
+#define SAVESTORE_H
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include "DatabaseConnection.h"
+#include "../core/Constants.h"
+
+class GameState;
+
+/**
+ * @brief SaveInfo - One row of a player's save history
+ */
+struct SaveInfo {
+    qint64 id = 0;
+    QString savedAt;
+    int goldBars = 0;
+    int location = 0;
+};
+
+struct SaveRetention {
+    int keepPerPlayer = SAVE_KEEP_PER_PLAYER;  // Newest saves kept for each player
+    int batchRows = SAVE_PRUNE_BATCH;          // Rows deleted per transaction
+};
+
+/**
+ * @brief SaveStore - game_saves with indexed lookups, paging and retention
+ *
+ * A trigger keeps latest_saves pointing at each player's newest save, so
+ * loading is two primary key lookups whatever the table size. History is
+ * listed newest first by keyset over the covering (player_name, saved_at, id)
+ * index. prune() drops all but the newest saves of each player in short
+ * transactions and hands the freed pages back to the file system.
+ */
+class SaveStore {
+public:
+    explicit SaveStore(DatabaseConnection& connection);
+
+    // Table, index, pointer table and trigger; idempotent, run after each connect
+    bool ensureSchema();
+
+    bool save(const QString& playerName, const GameState& state);
+    bool load(const QString& playerName, GameState& state);
+
+    // Newest first; pass the last entry of the previous page to continue after it
+    QVector<SaveInfo> history(const QString& playerName, int limit, const SaveInfo* after = nullptr);
+
+    /**
+     * @brief Apply the retention policy
+     * @param cancel Checked between transactions; a cancelled prune resumes on the next call
+     * @return Rows deleted, -1 on error
+     */
+    qint64 prune(const SaveRetention& retention = SaveRetention(), const std::atomic<bool>* cancel = nullptr);
+
+    QString getLastError() const;
+
+private:
+    void setLastError(const QString& error);
+    void vacuum(const std::atomic<bool>* cancel);
+
+    DatabaseConnection& m_connection;
+    mutable QMutex m_errorMutex;
+    QString m_lastError;
+};
+
+#endif // SAVESTORE_H
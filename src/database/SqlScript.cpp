@@ -0,0 +1,399 @@
+#include "SqlScript.h"
+#include <QString>
+#include <cstring>
+
+namespace {
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+}
+
+// Identifier or keyword character; bytes of multi-byte UTF-8 sequences count as letters
+bool isWordChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+        || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+// Case-insensitive match of a whole word against an upper-case keyword
+bool isKeyword(const char* word, qsizetype length, const char* keyword)
+{
+    for (qsizetype i = 0; i < length; ++i) {
+        char c = word[i];
+        if (c >= 'a' && c <= 'z') {
+            c = static_cast<char>(c - 'a' + 'A');
+        }
+        if (c != keyword[i]) {
+            return false;       // Also stops at the keyword's terminator
+        }
+    }
+    return keyword[length] == '\0';
+}
+
+const char* findByte(const char* p, const char* end, char c)
+{
+    return static_cast<const char*>(std::memchr(p, c, static_cast<size_t>(end - p)));
+}
+
+// Blanks and comments within one statement
+const char* skipSpace(const char* p, const char* end)
+{
+    while (p < end) {
+        if (isBlank(*p)) {
+            ++p;
+        } else if (*p == '-' && p + 1 < end && p[1] == '-') {
+            const char* newline = findByte(p + 2, end, '\n');
+            p = newline ? newline + 1 : end;
+        } else if (*p == '/' && p + 1 < end && p[1] == '*') {
+            const char* close = p + 2;
+            while ((close = findByte(close, end, '*')) != nullptr && (close + 1 >= end || close[1] != '/')) {
+                ++close;
+            }
+            p = close ? close + 2 : end;
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+// Past the quoted string or identifier starting at p; nullptr if it is not closed
+const char* skipQuotedIn(const char* p, const char* end)
+{
+    const char quote = *p == '[' ? ']' : *p;
+    for (++p;;) {
+        const char* close = findByte(p, end, quote);
+        if (!close) {
+            return nullptr;
+        }
+        if (quote != ']' && close + 1 < end && close[1] == quote) {
+            p = close + 2;
+            continue;
+        }
+        return close + 1;
+    }
+}
+
+// Number, 'string', NULL, TRUE or FALSE; nullptr for anything else
+const char* parseLiteral(const char* p, const char* end, QVariant& value)
+{
+    if (*p == '\'') {
+        const char* close = skipQuotedIn(p, end);
+        if (!close) {
+            return nullptr;
+        }
+        const QByteArrayView body(p + 1, close - 1 - (p + 1));
+        QString text = QString::fromUtf8(body);
+        if (body.contains("''")) {
+            text.replace(QLatin1String("''"), QLatin1String("'"));
+        }
+        value = text;
+        return close;
+    }
+
+    if ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.') {
+        const char* q = p + 1;
+        bool integral = *p != '.';
+        while (q < end) {
+            const char c = *q;
+            if (c >= '0' && c <= '9') {
+                ++q;
+            } else if (c == '.' || c == 'e' || c == 'E') {
+                integral = false;
+                ++q;
+            } else if ((c == '-' || c == '+') && (q[-1] == 'e' || q[-1] == 'E')) {
+                ++q;
+            } else {
+                break;
+            }
+        }
+        const QByteArrayView token(p, q - p);
+        bool ok = false;
+        if (integral) {
+            value = token.toLongLong(&ok);
+        } else {
+            value = token.toDouble(&ok);
+        }
+        return ok ? q : nullptr;
+    }
+
+    const char* q = p;
+    while (q < end && isWordChar(*q)) {
+        ++q;
+    }
+    if (isKeyword(p, q - p, "NULL")) {
+        value = QVariant();
+    } else if (isKeyword(p, q - p, "TRUE")) {
+        value = qlonglong(1);
+    } else if (isKeyword(p, q - p, "FALSE")) {
+        value = qlonglong(0);
+    } else {
+        return nullptr;
+    }
+    return q;
+}
+
+}
+
+SqlScriptReader::SqlScriptReader(QByteArrayView script)
+    : m_begin(script.data())
+    , m_end(script.data() + script.size())
+    , m_pos(script.data())
+{
+}
+
+bool SqlScriptReader::next(SqlStatement& statement)
+{
+    for (;;) {
+        const char* p = skipBlanks(m_pos);
+        if (p >= m_end) {
+            m_pos = m_end;
+            return false;
+        }
+
+        const char* start = p;
+        const char* stop = m_end;
+        bool autoIncrement = false;
+
+        // CREATE [TEMP|TEMPORARY] TRIGGER: semicolons inside BEGIN ... END
+        // (and CASE ... END within it) belong to the statement
+        int words = 0;
+        bool create = false;
+        bool temporary = false;
+        bool trigger = false;
+        int depth = 0;
+
+        while (p < m_end) {
+            const char c = *p;
+            if (c == ';') {
+                if (depth == 0) {
+                    stop = p;
+                    break;
+                }
+                ++p;
+            } else if (c == '\'' || c == '"' || c == '`') {
+                p = skipQuoted(p + 1, c);
+            } else if (c == '[') {
+                const char* close = findByte(p + 1, m_end, ']');
+                m_truncated |= close == nullptr;
+                p = close ? close + 1 : m_end;
+            } else if (c == '-' && p + 1 < m_end && p[1] == '-') {
+                const char* newline = findByte(p + 2, m_end, '\n');
+                p = newline ? newline + 1 : m_end;
+            } else if (c == '/' && p + 1 < m_end && p[1] == '*') {
+                p = skipBlockComment(p + 2);
+            } else if (isWordChar(c)) {
+                const char* word = p;
+                while (p < m_end && isWordChar(*p)) {
+                    ++p;
+                }
+                const qsizetype length = p - word;
+
+                if (words < 3) {
+                    if (words == 0) {
+                        create = isKeyword(word, length, "CREATE");
+                    } else if (words == 1 && create) {
+                        trigger = isKeyword(word, length, "TRIGGER");
+                        temporary = isKeyword(word, length, "TEMP") || isKeyword(word, length, "TEMPORARY");
+                    } else if (words == 2 && temporary) {
+                        trigger = isKeyword(word, length, "TRIGGER");
+                    }
+                    ++words;
+                }
+
+                if (trigger) {
+                    if (isKeyword(word, length, "BEGIN") || isKeyword(word, length, "CASE")) {
+                        ++depth;
+                    } else if (depth > 0 && isKeyword(word, length, "END")) {
+                        --depth;
+                    }
+                }
+                if (length == 14 && isKeyword(word, length, "AUTO_INCREMENT")) {
+                    autoIncrement = true;
+                }
+            } else {
+                ++p;
+            }
+        }
+
+        m_pos = stop < m_end ? stop + 1 : m_end;
+        while (stop > start && isBlank(stop[-1])) {
+            --stop;
+        }
+        if (stop == start) {
+            continue;           // Empty statement: ";;"
+        }
+
+        statement.text = QByteArrayView(start, stop - start);
+        statement.offset = start - m_begin;
+        statement.autoIncrement = autoIncrement;
+        return true;
+    }
+}
+
+int SqlScriptReader::lineAt(QByteArrayView script, qsizetype offset)
+{
+    const char* p = script.data();
+    const char* end = script.data() + qBound<qsizetype>(0, offset, script.size());
+    int line = 1;
+    while ((p = findByte(p, end, '\n')) != nullptr) {
+        ++line;
+        ++p;
+    }
+    return line;
+}
+
+bool SqlScriptReader::parseInsert(QByteArrayView statement, SqlInsert& insert)
+{
+    const char* p = statement.data();
+    const char* end = p + statement.size();
+    insert.table = QByteArrayView();
+    insert.columns = 0;
+    insert.values.clear();
+
+    // Head: INSERT [OR ...] INTO [schema.]table [(columns)], up to VALUES.
+    // A comment in it would swallow the VALUES appended when preparing
+    p = skipSpace(p, end);
+    const char* start = p;
+    const char* headEnd = nullptr;
+    bool first = true;
+    bool tableNext = false;
+    while (p < end && !headEnd) {
+        const char c = *p;
+        if (c == '"' || c == '`' || c == '[') {
+            const char* close = skipQuotedIn(p, end);
+            if (!close) {
+                return false;
+            }
+            if (tableNext) {
+                insert.table = QByteArrayView(p + 1, close - 1 - (p + 1));
+            }
+            p = close;
+            tableNext = tableNext && p < end && *p == '.';
+        } else if (isWordChar(c)) {
+            const char* word = p;
+            while (p < end && isWordChar(*p)) {
+                ++p;
+            }
+            const qsizetype length = p - word;
+            if (first) {
+                if (!isKeyword(word, length, "INSERT")) {
+                    return false;
+                }
+                first = false;
+            } else if (tableNext) {
+                insert.table = QByteArrayView(word, length);
+                tableNext = p < end && *p == '.';
+            } else if (isKeyword(word, length, "INTO")) {
+                tableNext = true;
+            } else if (isKeyword(word, length, "VALUES")) {
+                headEnd = word;
+            } else if (isKeyword(word, length, "SELECT") || isKeyword(word, length, "DEFAULT")) {
+                return false;
+            }
+        } else if (c == '\'' || (c == '-' && p + 1 < end && p[1] == '-') || (c == '/' && p + 1 < end && p[1] == '*')) {
+            return false;
+        } else {
+            ++p;
+        }
+    }
+    if (!headEnd || insert.table.isEmpty()) {
+        return false;
+    }
+    while (headEnd > start && isBlank(headEnd[-1])) {
+        --headEnd;
+    }
+    insert.head = QByteArrayView(start, headEnd - start);
+
+    // Rows: (literal, ...), (literal, ...)
+    QVariant value;
+    for (;;) {
+        p = skipSpace(p, end);
+        if (p >= end || *p != '(') {
+            return false;
+        }
+        int width = 0;
+        for (++p;;) {
+            p = skipSpace(p, end);
+            if (p >= end || !(p = parseLiteral(p, end, value))) {
+                return false;
+            }
+            insert.values.append(value);
+            ++width;
+            p = skipSpace(p, end);
+            if (p < end && *p == ',') {
+                ++p;
+            } else if (p < end && *p == ')') {
+                ++p;
+                break;
+            } else {
+                return false;
+            }
+        }
+        if (insert.columns == 0) {
+            insert.columns = width;
+        } else if (width != insert.columns) {
+            return false;
+        }
+
+        // Anything but another row (ON CONFLICT, RETURNING) needs the full statement
+        p = skipSpace(p, end);
+        if (p >= end) {
+            return true;
+        }
+        if (*p != ',') {
+            return false;
+        }
+        ++p;
+    }
+}
+
+const char* SqlScriptReader::skipBlanks(const char* p)
+{
+    while (p < m_end) {
+        if (isBlank(*p)) {
+            ++p;
+        } else if (*p == '-' && p + 1 < m_end && p[1] == '-') {
+            const char* newline = findByte(p + 2, m_end, '\n');
+            p = newline ? newline + 1 : m_end;
+        } else if (*p == '/' && p + 1 < m_end && p[1] == '*') {
+            p = skipBlockComment(p + 2);
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+const char* SqlScriptReader::skipQuoted(const char* p, char quote)
+{
+    for (;;) {
+        const char* close = findByte(p, m_end, quote);
+        if (!close) {
+            m_truncated = true;
+            return m_end;
+        }
+        // A doubled quote is an escaped quote, not the end
+        if (close + 1 < m_end && close[1] == quote) {
+            p = close + 2;
+            continue;
+        }
+        return close + 1;
+    }
+}
+
+const char* SqlScriptReader::skipBlockComment(const char* p)
+{
+    for (;;) {
+        const char* star = findByte(p, m_end, '*');
+        if (!star || star + 1 >= m_end) {
+            m_truncated = true;
+            return m_end;
+        }
+        if (star[1] == '/') {
+            return star + 2;
+        }
+        p = star + 1;
+    }
+}
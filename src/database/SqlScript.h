@@ -0,0 +1,68 @@
+#ifndef SQLSCRIPT_H
+#define SQLSCRIPT_H
+
+#include <QByteArrayView>
+#include <QVariantList>
+
+/**
+ * @brief SqlStatement - One statement of an SQL script, viewed in place
+ */
+struct SqlStatement {
+    QByteArrayView text;            // Without the terminating ';' and surrounding blanks
+    qsizetype offset = 0;           // Byte offset of text in the script
+    bool autoIncrement = false;     // Uses MySQL's AUTO_INCREMENT, which SQLite spells AUTOINCREMENT
+};
+
+/**
+ * @brief SqlInsert - INSERT ... VALUES statement whose values are all literals
+ */
+struct SqlInsert {
+    QByteArrayView head;            // Everything before VALUES: "INSERT INTO notes (id, content)"
+    QByteArrayView table;           // Without identifier quotes
+    int columns = 0;                // Values per row
+    QVariantList values;            // Row after row; NULL is a null QVariant
+};
+
+/**
+ * @brief SqlScriptReader - Streaming statement splitter for UTF-8 SQL scripts
+ *
+ * Walks the script once and yields each statement as a view into it; nothing
+ * is copied or decoded. Understands '' and "" escapes inside quotes,
+ * backtick and [bracket] identifiers, -- and block comments, and the
+ * BEGIN ... END body of CREATE TRIGGER, whose inner semicolons do not end the
+ * statement. Quoted text and comments are skipped with memchr.
+ */
+class SqlScriptReader {
+public:
+    explicit SqlScriptReader(QByteArrayView script);
+
+    // Next statement; false at the end of the script
+    bool next(SqlStatement& statement);
+
+    // The script ended inside a quote or a block comment
+    bool isTruncated() const { return m_truncated; }
+
+    // 1-based line of a byte offset, for error messages
+    static int lineAt(QByteArrayView script, qsizetype offset);
+
+    /**
+     * @brief Split an INSERT of literal rows into its head and values
+     *
+     * Numbers, 'strings' and NULL are understood; any other expression, a
+     * SELECT source or rows of different widths make it return false, and the
+     * statement has to be executed as text.
+     */
+    static bool parseInsert(QByteArrayView statement, SqlInsert& insert);
+
+private:
+    const char* skipBlanks(const char* p);
+    const char* skipQuoted(const char* p, char quote);
+    const char* skipBlockComment(const char* p);
+
+    const char* m_begin;
+    const char* m_end;
+    const char* m_pos;
+    bool m_truncated = false;
+};
+
+#endif // SQLSCRIPT_H
@@ -1,6 +1,5 @@
 #include "QApplication"
 #include "ui/MainWindow.h"
-#include "utils/RandomGenerator.h"
 #include "utils/TypeWriter.h"
 #include "utils/TextGenerator.h"
 #include "ui/RiddleDialog.h"
@@ -16,7 +15,6 @@ int main(int argc, char *argv[]) {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     QTextCodec::setCodecForLocale(QTextCodec::codecForName("UTF-8"));
 #endif
-    RandomGenerator::initializeSeed();
 
     // Load pixel font
     int fontId = QFontDatabase::addApplicationFont(":/assets/fonts/PressStart2P-Regular.ttf");
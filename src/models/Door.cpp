@@ -1,2 +0,0 @@
-#include "Door.h"
-// Empty - all implementation is in header
@@ -1,2 +0,0 @@
-#include "Item.h"
-// Empty - all implementation is in header
@@ -1,2 +0,0 @@
-#include "Location.h"
-// Empty - all implementation is in header (template-like class)
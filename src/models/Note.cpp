@@ -1,2 +0,0 @@
-#include "Note.h"
-// Empty - all implementation is in header
@@ -1,2 +0,0 @@
-#include "Riddle.h"
-// Empty - all implementation is in header
@@ -0,0 +1,61 @@
+#include "ToolContent.h"
+#include "../../core/ContentPack.h"
+#include "../../database/DatabaseManager.h"
+#include <QDebug>
+#include <QFileInfo>
+
+bool ToolContent::load(ContentCatalogPtr& content, QString* error)
+{
+    const QString packPath = ContentPack::defaultPath();
+    if (QFileInfo::exists(packPath)) {
+        QString packError;
+        if (ContentPackPtr pack = ContentPack::openCurrent(packPath, DatabaseManager::defaultSqlPath(), &packError)) {
+            content = ContentPack::catalog(pack);
+            return true;
+        }
+        qWarning() << "Ignoring content pack" << packPath << ":" << packError;
+    }
+    return loadFromDatabase(content, error);
+}
+
+bool ToolContent::loadFromDatabase(ContentCatalogPtr& content, QString* error)
+{
+    DatabaseManager database;
+    if (!database.connect()) {
+        if (error) {
+            *error = database.getLastError();
+        }
+        return false;
+    }
+
+    QVector<LocationData> locations = database.loadLocations();
+    if (locations.isEmpty()) {
+        if (error) {
+            *error = "No locations in database";
+        }
+        return false;
+    }
+
+    content = ContentCatalog::create(std::move(locations), database.loadRiddles(), database.loadNotes());
+    return true;
+}
+
+ContentCatalogPtr ToolContent::synthetic(int locations, int riddles, int notes)
+{
+    QVector<LocationData> locationList;
+    QVector<RiddleData> riddleList;
+    QVector<NoteData> noteList;
+
+    for (int i = 1; i <= locations; ++i) {
+        locationList.append({i, QString("Локация %1").arg(i), QString("theme_%1").arg(i),
+                             QString("Описание локации %1").arg(i)});
+    }
+    for (int i = 1; i <= riddles; ++i) {
+        riddleList.append({i, QString("Загадка %1").arg(i), QString("ответ %1").arg(i), 1 + i % 3});
+    }
+    for (int i = 1; i <= notes; ++i) {
+        noteList.append({i, QString("Записка номер %1, оставленная прежним искателем").arg(i),
+                         1 + i % qMax(1, locations)});
+    }
+    return ContentCatalog::create(std::move(locationList), std::move(riddleList), std::move(noteList));
+}
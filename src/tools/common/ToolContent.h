@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QString>
+#include "../../core/ContentCatalog.h"
+
+/**
+ * @brief ToolContent - Content loading shared by the command-line tools
+ */
+class ToolContent {
+public:
+    ToolContent() = delete;
+
+    // Content pack next to the executable if there is one, otherwise the database (same as the game)
+    static bool load(ContentCatalogPtr& content, QString* error = nullptr);
+
+    // Load content through DatabaseManager
+    static bool loadFromDatabase(ContentCatalogPtr& content, QString* error = nullptr);
+
+    // Deterministic placeholder content for runs without a database
+    static ContentCatalogPtr synthetic(int locations = 5, int riddles = 50, int notes = 100);
+};
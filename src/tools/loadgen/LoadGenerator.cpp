@@ -0,0 +1,199 @@
+#include "LoadGenerator.h"
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <QTimer>
+#include <algorithm>
+
+LoadGenerator::LoadGenerator(const LoadConfig& config, QTextStream& out, QObject* parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_out(out)
+    , m_rng(config.seed)
+{
+    m_clock.start();
+}
+
+void LoadGenerator::start()
+{
+    m_out << "sessions     moves/s    p50 us    p99 us    max us" << Qt::endl;
+    m_level = 0;
+    startLevel();
+}
+
+void LoadGenerator::startLevel()
+{
+    if (m_level >= m_config.levels.size()) {
+        emit finished(0);
+        return;
+    }
+
+    m_phase = Phase::Creating;
+    m_sessions.clear();
+    m_created = 0;
+    m_inFlight = 0;
+    m_latencies.clear();
+
+    const int sessions = m_config.levels[m_level];
+    m_sessions.reserve(sessions);
+    m_connections.resize(qMax(1, m_config.connections));
+
+    for (int i = 0; i < m_connections.size(); ++i) {
+        QIODevice* socket = nullptr;
+        if (m_config.localName.isEmpty()) {
+            auto* tcp = new QTcpSocket(this);
+            tcp->connectToHost(m_config.host, m_config.port);
+            if (!tcp->waitForConnected(5000)) {
+                m_out << "Cannot connect: " << tcp->errorString() << Qt::endl;
+                emit finished(1);
+                return;
+            }
+            tcp->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+            socket = tcp;
+        } else {
+            auto* local = new QLocalSocket(this);
+            local->connectToServer(m_config.localName);
+            if (!local->waitForConnected(5000)) {
+                m_out << "Cannot connect: " << local->errorString() << Qt::endl;
+                emit finished(1);
+                return;
+            }
+            socket = local;
+        }
+
+        m_connections[i] = Connection{socket, QByteArray()};
+        connect(socket, &QIODevice::readyRead, this, [this, i]() { onReadyRead(i); });
+    }
+
+    for (int i = 0; i < sessions; ++i) {
+        send(i % m_connections.size(), "NEW\n");
+    }
+}
+
+void LoadGenerator::send(int connection, const QByteArray& line)
+{
+    m_connections[connection].socket->write(line);
+    m_inFlight++;
+}
+
+void LoadGenerator::onReadyRead(int connection)
+{
+    Connection& conn = m_connections[connection];
+    conn.input += conn.socket->readAll();
+
+    int start = 0;
+    int end = 0;
+    while ((end = conn.input.indexOf('\n', start)) >= 0) {
+        handleReply(connection, conn.input.mid(start, end - start));
+        start = end + 1;
+        if (m_connections.isEmpty()) {
+            return;     // Level finished while handling the batch
+        }
+    }
+    m_connections[connection].input.remove(0, start);
+}
+
+void LoadGenerator::handleReply(int connection, const QByteArray& line)
+{
+    m_inFlight--;
+    const qint64 now = m_clock.nsecsElapsed();
+    const QList<QByteArray> parts = line.split(' ');
+
+    if (parts.value(0) != "OK") {
+        m_out << "Server error: " << line << Qt::endl;
+        // Keep the session going: the reply to STATE sends its next move
+        auto it = m_sessions.find(parts.value(1).toULongLong());
+        if (it != m_sessions.end() && m_phase != Phase::Draining) {
+            it->measured = false;
+            send(it->connection, "STATE " + parts[1] + '\n');
+        }
+    } else if (parts.size() >= 10) {
+        const quint64 id = parts[1].toULongLong();
+        auto it = m_sessions.find(id);
+        if (it == m_sessions.end()) {
+            // Reply to NEW
+            it = m_sessions.insert(id, Session{connection, 0, false});
+            if (++m_created == m_config.levels[m_level] && m_phase == Phase::Creating) {
+                m_phase = Phase::Running;
+                m_runStarted = now;
+                QTimer::singleShot(m_config.seconds * 1000, this, [this]() {
+                    m_phase = Phase::Draining;
+                    m_runEnded = m_clock.nsecsElapsed();
+                });
+            }
+        } else if (it->measured && m_phase == Phase::Running) {
+            m_latencies.push_back(now - it->sentAt);
+        }
+
+        if (m_phase != Phase::Draining) {
+            sendNext(id, *it, parts);
+        }
+    }
+
+    if (m_phase == Phase::Draining && m_inFlight == 0) {
+        finishLevel();
+    }
+}
+
+void LoadGenerator::sendNext(quint64 id, Session& session, const QList<QByteArray>& state)
+{
+    // OK <id> <location> <room> <gold> <inventory> <doors> <riddle> <over> <won>
+    const QByteArray idText = QByteArray::number(id);
+    session.sentAt = m_clock.nsecsElapsed();
+
+    if (state[8] == "1") {
+        const int connection = session.connection;
+        m_sessions.remove(id);
+        send(connection, "QUIT " + idText + "\nNEW\n");
+        m_inFlight++;   // Two replies
+        return;
+    }
+
+    session.measured = true;
+    if (state[7] == "1") {
+        send(session.connection, "ANSWER " + idText + " ?\n");
+    } else {
+        const int doors = qMax(1, state[6].size());
+        send(session.connection, "DOOR " + idText + ' ' + QByteArray::number(m_rng.bounded(doors)) + '\n');
+    }
+}
+
+void LoadGenerator::finishLevel()
+{
+    report();
+    for (Connection& connection : m_connections) {
+        connection.socket->disconnect(this);
+        connection.socket->close();
+        connection.socket->deleteLater();
+    }
+    m_connections.clear();
+
+    m_level++;
+    // Let the server drop the old sessions before the next level
+    QTimer::singleShot(500, this, &LoadGenerator::startLevel);
+}
+
+void LoadGenerator::report()
+{
+    // Moves are only counted while running, so the drain is left out
+    const double seconds = (m_runEnded - m_runStarted) / 1e9;
+    auto percentile = [this](double p) -> double {
+        if (m_latencies.empty()) {
+            return 0.0;
+        }
+        const size_t index = qMin(m_latencies.size() - 1, static_cast<size_t>(p * m_latencies.size()));
+        std::nth_element(m_latencies.begin(), m_latencies.begin() + index, m_latencies.end());
+        return m_latencies[index] / 1000.0;
+    };
+
+    const double p50 = percentile(0.50);
+    const double p99 = percentile(0.99);
+    const double max = percentile(1.0);
+
+    m_out << QString("%1 %2 %3 %4 %5")
+                 .arg(m_config.levels[m_level], 8)
+                 .arg(qRound64(m_latencies.size() / qMax(seconds, 1e-9)), 11)
+                 .arg(p50, 9, 'f', 1)
+                 .arg(p99, 9, 'f', 1)
+                 .arg(max, 9, 'f', 1)
+          << Qt::endl;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QIODevice>
+#include <QObject>
+#include <QString>
+#include <QTextStream>
+#include <QVector>
+#include <vector>
+#include "../../utils/RandomGenerator.h"
+
+/**
+ * @brief LoadConfig - Parameters of a labyrinth_loadgen run
+ */
+struct LoadConfig {
+    QString host = "127.0.0.1";
+    quint16 port = 7777;
+    QString localName;              // Local socket instead of TCP if set
+    int connections = 8;
+    QVector<int> levels{10000, 50000, 100000};
+    int seconds = 10;               // Measured time per level
+    quint64 seed = 1;
+};
+
+/**
+ * @brief LoadGenerator - Closed-loop client for labyrinth_server
+ *
+ * For each level it opens the connections, creates that many sessions and
+ * keeps one request in flight per session: a door choice, or an answer when
+ * a riddle is active. Finished games are replaced by new ones. Reports the
+ * p50/p99 latency of DOOR/ANSWER requests once all sessions exist.
+ */
+class LoadGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    LoadGenerator(const LoadConfig& config, QTextStream& out, QObject* parent = nullptr);
+
+    void start();
+
+signals:
+    void finished(int exitCode);
+
+private:
+    enum class Phase {
+        Creating,
+        Running,
+        Draining
+    };
+
+    struct Connection {
+        QIODevice* socket = nullptr;
+        QByteArray input;
+    };
+
+    struct Session {
+        int connection = 0;
+        qint64 sentAt = 0;
+        bool measured = false;      // In-flight request is a move
+    };
+
+    void startLevel();
+    void finishLevel();
+    void onReadyRead(int connection);
+    void handleReply(int connection, const QByteArray& line);
+    void send(int connection, const QByteArray& line);
+    void sendNext(quint64 id, Session& session, const QList<QByteArray>& state);
+    void report();
+
+    LoadConfig m_config;
+    QTextStream& m_out;
+    RandomGenerator m_rng;
+    QElapsedTimer m_clock;
+
+    int m_level = -1;
+    Phase m_phase = Phase::Creating;
+    QVector<Connection> m_connections;
+    QHash<quint64, Session> m_sessions;
+    int m_created = 0;
+    int m_inFlight = 0;
+    qint64 m_runStarted = 0;
+    qint64 m_runEnded = 0;
+    std::vector<qint64> m_latencies;
+};
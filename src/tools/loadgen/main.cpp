@@ -0,0 +1,47 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "LoadGenerator.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("labyrinth_loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load generator for labyrinth_server");
+    parser.addHelpOption();
+
+    QCommandLineOption hostOption("host", "Server host.", "host", "127.0.0.1");
+    QCommandLineOption portOption("port", "Server TCP port.", "port", "7777");
+    QCommandLineOption localOption("local", "Connect to a local socket instead of TCP.", "name");
+    QCommandLineOption connectionsOption({"c", "connections"}, "Client connections.", "count", "8");
+    QCommandLineOption sessionsOption({"s", "sessions"}, "Comma-separated session counts.", "list", "10000,50000,100000");
+    QCommandLineOption secondsOption("seconds", "Measured seconds per level.", "seconds", "10");
+    QCommandLineOption seedOption("seed", "Seed of the simulated players.", "seed", "1");
+
+    parser.addOptions({hostOption, portOption, localOption, connectionsOption,
+                       sessionsOption, secondsOption, seedOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+
+    LoadConfig config;
+    config.host = parser.value(hostOption);
+    config.port = static_cast<quint16>(parser.value(portOption).toUInt());
+    config.localName = parser.value(localOption);
+    config.connections = parser.value(connectionsOption).toInt();
+    config.seconds = qMax(1, parser.value(secondsOption).toInt());
+    config.seed = parser.value(seedOption).toULongLong();
+
+    config.levels.clear();
+    for (const QString& level : parser.value(sessionsOption).split(',', Qt::SkipEmptyParts)) {
+        config.levels.append(qMax(1, level.trimmed().toInt()));
+    }
+
+    LoadGenerator generator(config, out);
+    QObject::connect(&generator, &LoadGenerator::finished, &app, &QCoreApplication::exit,
+                     Qt::QueuedConnection);
+    generator.start();
+
+    return app.exec();
+}
@@ -0,0 +1,142 @@
+#include "GameServer.h"
+#include "HostedSession.h"
+#include "ServerConnection.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+GameServer::GameServer(ContentCatalogPtr content, const GameRules& rules, int threads, QObject* parent)
+    : QObject(parent)
+    , m_content(std::move(content))
+    , m_rules(rules)
+    , m_pool(threads)
+{
+}
+
+GameServer::~GameServer() = default;
+
+bool GameServer::listenTcp(quint16 port, QString* error)
+{
+    m_tcpServer = new QTcpServer(this);
+    connect(m_tcpServer, &QTcpServer::newConnection, this, &GameServer::onTcpConnection);
+    if (!m_tcpServer->listen(QHostAddress::Any, port)) {
+        if (error) {
+            *error = m_tcpServer->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool GameServer::listenLocal(const QString& name, QString* error)
+{
+    QLocalServer::removeServer(name);
+    m_localServer = new QLocalServer(this);
+    connect(m_localServer, &QLocalServer::newConnection, this, &GameServer::onLocalConnection);
+    if (!m_localServer->listen(name)) {
+        if (error) {
+            *error = m_localServer->errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+void GameServer::onTcpConnection()
+{
+    while (QTcpSocket* socket = m_tcpServer->nextPendingConnection()) {
+        socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        new ServerConnection(socket, this);
+    }
+}
+
+void GameServer::onLocalConnection()
+{
+    while (QLocalSocket* socket = m_localServer->nextPendingConnection()) {
+        new ServerConnection(socket, this);
+    }
+}
+
+std::shared_ptr<HostedSession> GameServer::findSession(ServerConnection* connection, const QByteArray& id)
+{
+    // Only the connection that created a session may drive it
+    bool ok = false;
+    const quint64 sessionId = id.toULongLong(&ok);
+    auto it = ok && connection->sessions().contains(sessionId) ? m_sessions.find(sessionId) : m_sessions.end();
+    if (it == m_sessions.end()) {
+        connection->outbox()->push("ERR " + (id.isEmpty() ? QByteArray("-") : id) + " unknown session\n");
+        return nullptr;
+    }
+    return it->second;
+}
+
+void GameServer::handleLine(ServerConnection* connection, const QByteArray& line)
+{
+    const QList<QByteArray> parts = line.split(' ');
+    const QByteArray& verb = parts[0];
+
+    if (verb == "NEW") {
+        const quint64 id = m_nextId++;
+        const quint64 seed = m_seed ? RandomGenerator::deriveSeed(m_seed, id) : RandomGenerator::entropySeed();
+        auto session = std::make_shared<HostedSession>(id, m_content, m_rules, seed);
+        m_sessions.emplace(id, session);
+        connection->sessions().insert(id);
+
+        ServerCommand command;
+        command.type = ServerCommand::Start;
+        command.outbox = connection->outbox();
+        session->post(std::move(command), m_pool);
+        return;
+    }
+
+    if (verb == "QUIT") {
+        if (std::shared_ptr<HostedSession> session = findSession(connection, parts.value(1))) {
+            m_sessions.erase(session->id());
+            connection->sessions().remove(session->id());
+
+            // Through the mailbox, so the reply follows the session's earlier ones
+            ServerCommand command;
+            command.type = ServerCommand::Quit;
+            command.outbox = connection->outbox();
+            session->post(std::move(command), m_pool);
+        }
+        return;
+    }
+
+    ServerCommand command;
+    command.outbox = connection->outbox();
+
+    if (verb == "DOOR") {
+        bool ok = false;
+        command.type = ServerCommand::Door;
+        command.door = parts.value(2).toInt(&ok);
+        if (!ok) {
+            // Answered by the session, after its replies still queued
+            command.type = ServerCommand::Reject;
+            command.error = "bad door index";
+        }
+    } else if (verb == "ANSWER") {
+        command.type = ServerCommand::Answer;
+        const int offset = line.indexOf(' ', verb.size() + 1);
+        command.answer = offset < 0 ? QString() : QString::fromUtf8(line.mid(offset + 1));
+    } else if (verb == "STATE") {
+        command.type = ServerCommand::State;
+    } else {
+        connection->outbox()->push("ERR - unknown command\n");
+        return;
+    }
+
+    if (std::shared_ptr<HostedSession> session = findSession(connection, parts.value(1))) {
+        session->post(std::move(command), m_pool);
+    }
+}
+
+void GameServer::closeConnection(ServerConnection* connection)
+{
+    for (quint64 id : connection->sessions()) {
+        m_sessions.erase(id);
+    }
+    connection->sessions().clear();
+    connection->deleteLater();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <unordered_map>
+#include "../../core/GameRules.h"
+#include "../common/ToolContent.h"
+#include "../../utils/WorkStealingPool.h"
+
+class QLocalServer;
+class QTcpServer;
+class HostedSession;
+class ServerConnection;
+
+/**
+ * @brief GameServer - Hosts many GameSessions behind a line protocol
+ *
+ * Requests, one per line:
+ *   NEW                      -> OK <id> <state>
+ *   DOOR <id> <index>        -> OK <id> <state>
+ *   ANSWER <id> <text...>    -> OK <id> <state>
+ *   STATE <id>               -> OK <id> <state>
+ *   QUIT <id>                -> OK <id>
+ * Failures answer "ERR <id|-> <message>". <state> is
+ * "<location> <room> <gold> <inventory> <doors> <riddle> <over> <won>".
+ *
+ * Sockets are served on the thread that owns the server; the games run on a
+ * work-stealing pool. Replies of different sessions may come back in any
+ * order, replies of one session keep the request order.
+ */
+class GameServer : public QObject {
+    Q_OBJECT
+
+public:
+    GameServer(ContentCatalogPtr content, const GameRules& rules, int threads, QObject* parent = nullptr);
+    ~GameServer();
+
+    // Sessions are seeded from (seed, id); 0 = entropy seeds
+    void setSeed(quint64 seed) { m_seed = seed; }
+
+    bool listenTcp(quint16 port, QString* error = nullptr);
+    bool listenLocal(const QString& name, QString* error = nullptr);
+
+    int sessionCount() const { return static_cast<int>(m_sessions.size()); }
+    int threadCount() const { return m_pool.threadCount(); }
+
+    void handleLine(ServerConnection* connection, const QByteArray& line);
+    void closeConnection(ServerConnection* connection);
+
+private slots:
+    void onTcpConnection();
+    void onLocalConnection();
+
+private:
+    std::shared_ptr<HostedSession> findSession(ServerConnection* connection, const QByteArray& id);
+
+    ContentCatalogPtr m_content;
+    GameRules m_rules;
+    quint64 m_seed = 0;
+    quint64 m_nextId = 1;
+
+    // Only touched on the server thread; pool tasks hold their own references
+    std::unordered_map<quint64, std::shared_ptr<HostedSession>> m_sessions;
+
+    QTcpServer* m_tcpServer = nullptr;
+    QLocalServer* m_localServer = nullptr;
+    WorkStealingPool m_pool;
+};
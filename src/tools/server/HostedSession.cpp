@@ -0,0 +1,114 @@
+#include "HostedSession.h"
+#include "ServerConnection.h"
+#include "../../core/PackedGameState.h"
+
+HostedSession::HostedSession(quint64 id, ContentCatalogPtr content, const GameRules& rules, quint64 seed)
+    : m_id(id)
+    , m_content(std::move(content))
+{
+    m_session.setRules(rules);
+    m_session.setSeed(seed);
+}
+
+void HostedSession::post(ServerCommand command, WorkStealingPool& pool)
+{
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mailbox.push_back(std::move(command));
+        if (!m_scheduled) {
+            m_scheduled = true;
+            schedule = true;
+        }
+    }
+
+    if (schedule) {
+        std::shared_ptr<HostedSession> self = shared_from_this();
+        pool.submit([self]() { self->drain(); });
+    }
+}
+
+void HostedSession::drain()
+{
+    while (true) {
+        ServerCommand command;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_mailbox.empty()) {
+                m_scheduled = false;
+                return;
+            }
+            command = std::move(m_mailbox.front());
+            m_mailbox.pop_front();
+        }
+
+        QByteArray reply = execute(command);
+        if (command.outbox) {
+            command.outbox->push(reply);
+        }
+    }
+}
+
+QByteArray HostedSession::execute(const ServerCommand& command)
+{
+    const QByteArray id = QByteArray::number(m_id);
+
+    switch (command.type) {
+        case ServerCommand::Start:
+            if (!m_session.start(m_content)) {
+                return "ERR " + id + " no locations\n";
+            }
+            break;
+        case ServerCommand::Door:
+            m_session.chooseDoor(command.door);
+            break;
+        case ServerCommand::Answer:
+            if (!m_session.answerRiddle(command.answer)) {
+                return "ERR " + id + " no active riddle\n";
+            }
+            break;
+        case ServerCommand::State:
+            break;
+        case ServerCommand::Quit:
+            return "OK " + id + '\n';
+        case ServerCommand::Reject:
+            return "ERR " + id + ' ' + command.error + '\n';
+    }
+
+    return "OK " + id + ' ' + formatState(m_session.getCurrentState()) + '\n';
+}
+
+QByteArray HostedSession::formatState(const GameState& state)
+{
+    QByteArray inventory;
+    for (ItemType item : state.getInventory()) {
+        inventory += item == ItemType::GOLD_KEY ? 'g' : 's';
+    }
+    if (inventory.isEmpty()) {
+        inventory = "-";
+    }
+
+    // Door codes as in PackedGameState: 0 normal, 1 silver, 2 gold, 3 wooden
+    QByteArray doors;
+    PackedGameState packed;
+    if (PackedGameState::pack(state, packed)) {
+        for (int i = 0; i < packed.doorCount(); ++i) {
+            doors += static_cast<char>('0' + packed.door(i));
+        }
+    }
+    if (doors.isEmpty()) {
+        doors = "-";
+    }
+
+    QByteArray line;
+    line.reserve(32);
+    line += QByteArray::number(state.getCurrentLocationIndex()) + ' ';
+    line += QByteArray::number(state.getCurrentRoomIndex()) + ' ';
+    line += QByteArray::number(state.getGoldBars()) + ' ';
+    line += inventory + ' ';
+    line += doors + ' ';
+    line += state.hasActiveRiddle() ? "1 " : "0 ";
+    line += state.isGameOver() ? "1 " : "0 ";
+    line += state.isGameWon() ? '1' : '0';
+    return line;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "../../core/GameSession.h"
+#include "../common/ToolContent.h"
+#include "../../utils/WorkStealingPool.h"
+
+class ReplyOutbox;
+
+/**
+ * @brief ServerCommand - One parsed protocol request for a session
+ */
+struct ServerCommand {
+    enum Type {
+        Start,
+        Door,
+        Answer,
+        State,
+        Quit,
+        Reject          // Malformed request: reply "ERR <id> <error>"
+    };
+
+    Type type = State;
+    int door = 0;
+    QString answer;
+    QByteArray error;
+    std::shared_ptr<ReplyOutbox> outbox;
+};
+
+/**
+ * @brief HostedSession - GameSession served to a remote client
+ *
+ * Commands are queued in a mailbox and drained by one pool task at a time,
+ * so a session is never touched by two threads at once and needs no lock
+ * around the game itself. The content is shared by every session.
+ */
+class HostedSession : public std::enable_shared_from_this<HostedSession> {
+public:
+    HostedSession(quint64 id, ContentCatalogPtr content, const GameRules& rules, quint64 seed);
+
+    quint64 id() const { return m_id; }
+
+    // Queue a command and make sure a drain task is scheduled
+    void post(ServerCommand command, WorkStealingPool& pool);
+
+    // "<location> <room> <gold> <inventory> <doors> <riddle> <over> <won>"
+    static QByteArray formatState(const GameState& state);
+
+private:
+    void drain();
+    QByteArray execute(const ServerCommand& command);
+
+    const quint64 m_id;
+    ContentCatalogPtr m_content;
+    GameSession m_session;
+
+    std::mutex m_mutex;
+    std::deque<ServerCommand> m_mailbox;
+    bool m_scheduled = false;
+};
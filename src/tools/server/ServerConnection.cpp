@@ -0,0 +1,81 @@
+#include "ServerConnection.h"
+#include "GameServer.h"
+#include "../../core/Constants.h"
+#include <QDebug>
+#include <QMetaObject>
+
+void ReplyOutbox::push(const QByteArray& reply)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_connection) {
+        return;
+    }
+
+    const bool wasEmpty = m_buffer.isEmpty();
+    m_buffer += reply;
+    if (wasEmpty) {
+        // Under the lock, so the connection cannot be destroyed in between
+        QMetaObject::invokeMethod(m_connection, "flushReplies", Qt::QueuedConnection);
+    }
+}
+
+QByteArray ReplyOutbox::take()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QByteArray result;
+    result.swap(m_buffer);
+    return result;
+}
+
+void ReplyOutbox::detach()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_connection = nullptr;
+    m_buffer.clear();
+}
+
+ServerConnection::ServerConnection(QIODevice* socket, GameServer* server)
+    : QObject(server)
+    , m_socket(socket)
+    , m_server(server)
+    , m_outbox(std::make_shared<ReplyOutbox>(this))
+{
+    m_socket->setParent(this);
+    connect(m_socket, &QIODevice::readyRead, this, &ServerConnection::onReadyRead);
+    // QTcpSocket and QLocalSocket both have a disconnected() signal
+    connect(m_socket, SIGNAL(disconnected()), this, SLOT(onDisconnected()));
+}
+
+ServerConnection::~ServerConnection()
+{
+    m_outbox->detach();
+}
+
+void ServerConnection::flushReplies()
+{
+    const QByteArray replies = m_outbox->take();
+    if (!replies.isEmpty()) {
+        m_socket->write(replies);
+    }
+}
+
+void ServerConnection::onReadyRead()
+{
+    while (m_socket->canReadLine()) {
+        QByteArray line = m_socket->readLine().trimmed();
+        if (!line.isEmpty()) {
+            m_server->handleLine(this, line);
+        }
+    }
+
+    // What is left is an unfinished line; don't buffer it without bound
+    if (m_socket->bytesAvailable() > SERVER_MAX_LINE) {
+        qWarning() << "Dropping client: request line longer than" << SERVER_MAX_LINE << "bytes";
+        m_socket->close();
+    }
+}
+
+void ServerConnection::onDisconnected()
+{
+    m_server->closeConnection(this);
+}
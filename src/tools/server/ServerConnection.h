@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QObject>
+#include <QSet>
+#include <memory>
+#include <mutex>
+
+class GameServer;
+class ServerConnection;
+
+/**
+ * @brief ReplyOutbox - Thread-safe reply buffer of one connection
+ *
+ * Pool workers append replies; the first append after a flush schedules one
+ * queued flush on the connection's thread, so a burst of replies costs one
+ * cross-thread wakeup. Outlives the connection if replies are still in flight.
+ */
+class ReplyOutbox {
+public:
+    explicit ReplyOutbox(ServerConnection* connection) : m_connection(connection) {}
+
+    void push(const QByteArray& reply);
+    QByteArray take();
+
+    // Called by the connection before it goes away
+    void detach();
+
+private:
+    std::mutex m_mutex;
+    QByteArray m_buffer;
+    ServerConnection* m_connection;
+};
+
+/**
+ * @brief ServerConnection - One client socket (TCP or local) of the game server
+ *
+ * Splits the input into lines for GameServer and writes replies back. Owns
+ * the sessions it created; they are closed with the connection. A client
+ * sending more than SERVER_MAX_LINE bytes without a newline is dropped.
+ */
+class ServerConnection : public QObject {
+    Q_OBJECT
+
+public:
+    ServerConnection(QIODevice* socket, GameServer* server);
+    ~ServerConnection();
+
+    // Every reply goes through here, so replies keep the order they were made in
+    const std::shared_ptr<ReplyOutbox>& outbox() const { return m_outbox; }
+
+    QSet<quint64>& sessions() { return m_sessions; }
+
+public slots:
+    void flushReplies();
+
+private slots:
+    void onReadyRead();
+    void onDisconnected();
+
+private:
+    QIODevice* m_socket;
+    GameServer* m_server;
+    std::shared_ptr<ReplyOutbox> m_outbox;
+    QSet<quint64> m_sessions;
+};
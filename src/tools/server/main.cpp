@@ -0,0 +1,77 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "GameServer.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("labyrinth_server");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Hosts labyrinth sessions behind a line protocol");
+    parser.addHelpOption();
+
+    QCommandLineOption portOption("port", "TCP port to listen on (0 = no TCP).", "port", "7777");
+    QCommandLineOption localOption("local", "Also listen on this local socket name.", "name");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads (0 = all cores).", "count", "0");
+    QCommandLineOption seedOption("seed", "Seed sessions from (seed, id) instead of entropy.", "seed", "0");
+    QCommandLineOption ruleOption("set",
+        QString("Override a rule, e.g. --set noteChance=0.3. Rules: %1.").arg(GameRules::names().join(", ")),
+        "name=value");
+    QCommandLineOption syntheticOption("synthetic", "Use generated content instead of the database.");
+
+    parser.addOptions({portOption, localOption, threadsOption, seedOption, ruleOption, syntheticOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    GameRules rules;
+    for (const QString& assignment : parser.values(ruleOption)) {
+        QStringList parts = assignment.split('=');
+        bool ok = false;
+        double value = parts.size() == 2 ? parts[1].toDouble(&ok) : 0.0;
+        if (!ok || !rules.set(parts[0].trimmed(), value)) {
+            err << "Invalid rule override: " << assignment << Qt::endl;
+            return 1;
+        }
+    }
+
+    // Loaded once and shared by every session
+    ContentCatalogPtr content;
+    if (parser.isSet(syntheticOption)) {
+        content = ToolContent::synthetic();
+    } else {
+        QString error;
+        if (!ToolContent::load(content, &error)) {
+            err << "Failed to load content: " << error << Qt::endl;
+            err << "Run with --synthetic to serve generated content." << Qt::endl;
+            return 1;
+        }
+    }
+
+    GameServer server(content, rules, parser.value(threadsOption).toInt());
+    server.setSeed(parser.value(seedOption).toULongLong());
+
+    QString error;
+    const quint16 port = static_cast<quint16>(parser.value(portOption).toUInt());
+    if (port != 0 && !server.listenTcp(port, &error)) {
+        err << "Cannot listen on port " << port << ": " << error << Qt::endl;
+        return 1;
+    }
+    if (parser.isSet(localOption) && !server.listenLocal(parser.value(localOption), &error)) {
+        err << "Cannot listen on " << parser.value(localOption) << ": " << error << Qt::endl;
+        return 1;
+    }
+
+    out << "labyrinth_server: " << server.threadCount() << " workers";
+    if (port != 0) {
+        out << ", tcp " << port;
+    }
+    if (parser.isSet(localOption)) {
+        out << ", local " << parser.value(localOption);
+    }
+    out << Qt::endl;
+
+    return app.exec();
+}
@@ -0,0 +1,75 @@
+#include "DoorPolicy.h"
+#include "../../utils/RandomGenerator.h"
+
+namespace {
+
+int findDoor(const GameState& state, DoorType type)
+{
+    const QVector<DoorData>& doors = state.getCurrentDoors();
+    for (int i = 0; i < doors.size(); ++i) {
+        if (doors[i].type == type) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+}
+
+std::unique_ptr<DoorPolicy> DoorPolicy::create(const QString& name)
+{
+    if (name == "first") {
+        return std::make_unique<FirstDoorPolicy>();
+    }
+    if (name == "random") {
+        return std::make_unique<RandomDoorPolicy>();
+    }
+    if (name == "normal") {
+        return std::make_unique<NormalDoorPolicy>();
+    }
+    if (name == "greedy") {
+        return std::make_unique<GreedyDoorPolicy>();
+    }
+    return nullptr;
+}
+
+QStringList DoorPolicy::availablePolicies()
+{
+    return {"first", "random", "normal", "greedy"};
+}
+
+int FirstDoorPolicy::chooseDoor(const GameState& state, RandomGenerator& rng)
+{
+    Q_UNUSED(rng);
+    Q_UNUSED(state);
+    return 0;
+}
+
+int RandomDoorPolicy::chooseDoor(const GameState& state, RandomGenerator& rng)
+{
+    return rng.random(0, state.getCurrentDoors().size() - 1);
+}
+
+int NormalDoorPolicy::chooseDoor(const GameState& state, RandomGenerator& rng)
+{
+    Q_UNUSED(rng);
+    return qMax(0, findDoor(state, DoorType::NORMAL));
+}
+
+int GreedyDoorPolicy::chooseDoor(const GameState& state, RandomGenerator& rng)
+{
+    Q_UNUSED(rng);
+    if (state.hasItem(ItemType::GOLD_KEY)) {
+        int gold = findDoor(state, DoorType::GOLD);
+        if (gold >= 0) {
+            return gold;
+        }
+    }
+    if (state.hasItem(ItemType::SILVER_KEY)) {
+        int silver = findDoor(state, DoorType::SILVER);
+        if (silver >= 0) {
+            return silver;
+        }
+    }
+    return qMax(0, findDoor(state, DoorType::NORMAL));
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include "../../core/GameState.h"
+
+class RandomGenerator;
+
+/**
+ * @brief DoorPolicy - Strategy that picks a door for a simulated player
+ *
+ * One instance is created per worker thread, so policies may keep state.
+ * Any randomness must come from the supplied per-game stream.
+ */
+class DoorPolicy {
+public:
+    virtual ~DoorPolicy() = default;
+
+    virtual QString name() const = 0;
+    virtual int chooseDoor(const GameState& state, RandomGenerator& rng) = 0;
+
+    // Create a policy by name, nullptr if unknown
+    static std::unique_ptr<DoorPolicy> create(const QString& name);
+    static QStringList availablePolicies();
+};
+
+/**
+ * @brief FirstDoorPolicy - Always takes the leftmost door
+ */
+class FirstDoorPolicy : public DoorPolicy {
+public:
+    QString name() const override { return "first"; }
+    int chooseDoor(const GameState& state, RandomGenerator& rng) override;
+};
+
+/**
+ * @brief RandomDoorPolicy - Uniformly random door, locked or not
+ */
+class RandomDoorPolicy : public DoorPolicy {
+public:
+    QString name() const override { return "random"; }
+    int chooseDoor(const GameState& state, RandomGenerator& rng) override;
+};
+
+/**
+ * @brief NormalDoorPolicy - Never spends keys, always walks through a normal door
+ */
+class NormalDoorPolicy : public DoorPolicy {
+public:
+    QString name() const override { return "normal"; }
+    int chooseDoor(const GameState& state, RandomGenerator& rng) override;
+};
+
+/**
+ * @brief GreedyDoorPolicy - Opens a gold door when it has a gold key,
+ * otherwise spends a silver key to free the slot, otherwise goes normal
+ */
+class GreedyDoorPolicy : public DoorPolicy {
+public:
+    QString name() const override { return "greedy"; }
+    int chooseDoor(const GameState& state, RandomGenerator& rng) override;
+};
@@ -0,0 +1,121 @@
+#include "Replay.h"
+#include "../../core/GameJournal.h"
+#include "../../core/GameSession.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+
+quint64 stateHash(const GameState& state)
+{
+    quint64 hash = 1469598103934665603ull;
+    auto mix = [&hash](quint64 value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    mix(state.getCurrentLocationIndex());
+    mix(state.getCurrentRoomIndex());
+    mix(state.getGoldBars());
+    mix(state.getNoteIds().size());
+    mix(state.getLog().totalCount());
+    mix(state.isGameWon());
+    for (ItemType item : state.getInventory()) {
+        mix(static_cast<quint64>(item));
+    }
+    for (const DoorData& door : state.getCurrentDoors()) {
+        mix(static_cast<quint64>(door.type));
+    }
+    return hash;
+}
+
+}
+
+QStringList Replay::collectJournals(const QString& path)
+{
+    QFileInfo info(path);
+    if (!info.isDir()) {
+        return {path};
+    }
+
+    QStringList result;
+    QDir dir(path);
+    const QStringList names = dir.entryList({"*." + GameJournal::fileExtension()}, QDir::Files, QDir::Name);
+    for (const QString& name : names) {
+        result.append(dir.filePath(name));
+    }
+    return result;
+}
+
+ReplayReport Replay::run(const QStringList& journalPaths,
+                         const ContentCatalogPtr& content,
+                         const GameRules& rules,
+                         int repeat,
+                         QTextStream* details)
+{
+    ReplayReport report;
+
+    // Loading is not part of the measurement
+    QVector<GameJournal> journals;
+    QStringList loadedPaths;
+    journals.reserve(journalPaths.size());
+    for (const QString& path : journalPaths) {
+        GameJournal journal;
+        QString error;
+        if (!GameJournal::load(path, journal, &error)) {
+            if (details) {
+                *details << path << ": " << error << Qt::endl;
+            }
+            report.failures++;
+            continue;
+        }
+        journals.append(journal);
+        loadedPaths.append(path);
+    }
+
+    GameSession session;
+    session.setRules(rules);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int pass = 0; pass < qMax(1, repeat); ++pass) {
+        for (int i = 0; i < journals.size(); ++i) {
+            const GameJournal& journal = journals[i];
+            QString error;
+            if (!journal.replay(session, content, -1, &error)) {
+                if (pass == 0) {
+                    report.failures++;
+                    if (details) {
+                        *details << loadedPaths[i] << ": " << error << Qt::endl;
+                    }
+                }
+                continue;
+            }
+
+            const GameState& state = session.getCurrentState();
+            report.games++;
+            report.events += journal.eventCount();
+            report.bytes += journal.data().size();
+            if (pass == 0) {
+                report.checksum = report.checksum * 31 + stateHash(state);
+                if (details) {
+                    *details << QString("%1: seed %2, %3 events, location %4 room %5, gold %6, %7")
+                                    .arg(QFileInfo(loadedPaths[i]).fileName())
+                                    .arg(journal.seed())
+                                    .arg(journal.eventCount())
+                                    .arg(state.getCurrentLocationIndex() + 1)
+                                    .arg(state.getCurrentRoomIndex() + 1)
+                                    .arg(state.getGoldBars())
+                                    .arg(state.isGameWon() ? "won" : "in progress")
+                             << Qt::endl;
+                }
+            }
+        }
+    }
+
+    report.seconds = timer.nsecsElapsed() / 1e9;
+    return report;
+}
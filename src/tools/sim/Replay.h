@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include "../../core/GameRules.h"
+#include "../common/ToolContent.h"
+
+/**
+ * @brief ReplayReport - Outcome of replaying a set of recorded games
+ */
+struct ReplayReport {
+    qint64 games = 0;
+    qint64 events = 0;
+    qint64 bytes = 0;
+    qint64 failures = 0;        // Journals that do not match the content or rules
+    quint64 checksum = 0;       // Hash of every final state, changes if the rules drift
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Replay - Re-runs recorded GameJournal files headlessly
+ *
+ * Used to reproduce bug reports and as a performance regression corpus.
+ */
+class Replay {
+public:
+    Replay() = delete;
+
+    // A file, or a directory with *.lbj journals
+    static QStringList collectJournals(const QString& path);
+
+    static ReplayReport run(const QStringList& journalPaths,
+                            const ContentCatalogPtr& content,
+                            const GameRules& rules,
+                            int repeat,
+                            QTextStream* details = nullptr);
+};
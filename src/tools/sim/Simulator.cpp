@@ -0,0 +1,133 @@
+#include "Simulator.h"
+#include "DoorPolicy.h"
+#include "../../core/GameSession.h"
+#include "../../core/GameJournal.h"
+#include "../../utils/RandomGenerator.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <thread>
+#include <vector>
+
+void SimulationReport::merge(const SimulationReport& other)
+{
+    games += other.games;
+    wins += other.wins;
+    moves += other.moves;
+    lockedDoorAttempts += other.lockedDoorAttempts;
+    keysFound += other.keysFound;
+    keysWasted += other.keysWasted;
+    riddles += other.riddles;
+    riddlesSolved += other.riddlesSolved;
+    notes += other.notes;
+    for (auto it = other.goldHistogram.cbegin(); it != other.goldHistogram.cend(); ++it) {
+        goldHistogram[it.key()] += it.value();
+    }
+}
+
+Simulator::Simulator(ContentCatalogPtr content, const SimulationConfig& config)
+    : m_content(std::move(content))
+    , m_config(config)
+{
+    if (m_config.threads <= 0) {
+        m_config.threads = qMax(1u, std::thread::hardware_concurrency());
+    }
+}
+
+SimulationReport Simulator::run()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!m_config.recordDir.isEmpty()) {
+        QDir().mkpath(m_config.recordDir);
+    }
+
+    const int threadCount = static_cast<int>(qMin<qint64>(m_config.threads, qMax<qint64>(1, m_config.games)));
+    std::vector<SimulationReport> shardReports(threadCount);
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount);
+
+    qint64 firstGame = 0;
+    for (int t = 0; t < threadCount; ++t) {
+        qint64 games = m_config.games / threadCount + (t < m_config.games % threadCount ? 1 : 0);
+        workers.emplace_back([this, t, firstGame, games, &shardReports]() {
+            shardReports[t] = runShard(firstGame, games);
+        });
+        firstGame += games;
+    }
+
+    SimulationReport report;
+    for (int t = 0; t < threadCount; ++t) {
+        workers[t].join();
+        report.merge(shardReports[t]);
+    }
+
+    report.seconds = timer.nsecsElapsed() / 1e9;
+    return report;
+}
+
+SimulationReport Simulator::runShard(qint64 firstGame, qint64 games) const
+{
+    SimulationReport report;
+
+    std::unique_ptr<DoorPolicy> policy = DoorPolicy::create(m_config.policy);
+    if (!policy) {
+        return report;
+    }
+
+    GameSession session;
+    session.setRules(m_config.rules);
+
+    RandomGenerator playerRng;
+
+    GameJournal journal;
+    if (!m_config.recordDir.isEmpty()) {
+        session.setJournal(&journal);
+    }
+
+    for (qint64 game = firstGame; game < firstGame + games; ++game) {
+        // Seeds depend only on the game number, so results do not change
+        // with the thread count
+        session.setSeed(RandomGenerator::deriveSeed(m_config.seed, 2 * game));
+        playerRng.seed(RandomGenerator::deriveSeed(m_config.seed, 2 * game + 1));
+
+        if (!session.start(m_content)) {
+            break;
+        }
+
+        int guard = 0;
+        while (!session.getCurrentState().isGameOver() && guard++ < m_config.maxMovesPerGame) {
+            const GameState& state = session.getCurrentState();
+
+            if (session.hasActiveRiddle()) {
+                session.resolveRiddle(playerRng.randomDouble() < m_config.riddleSolveRate);
+                continue;
+            }
+
+            session.chooseDoor(policy->chooseDoor(state, playerRng));
+        }
+
+        if (!m_config.recordDir.isEmpty()) {
+            journal.save(QDir(m_config.recordDir).filePath(
+                QString("game_%1.%2").arg(game, 8, 10, QChar('0')).arg(GameJournal::fileExtension())));
+        }
+
+        const GameState& finalState = session.getCurrentState();
+        const SessionStats& stats = session.getStats();
+
+        report.games++;
+        if (finalState.isGameWon()) {
+            report.wins++;
+        }
+        report.moves += stats.moves;
+        report.lockedDoorAttempts += stats.lockedDoorAttempts;
+        report.keysFound += stats.keysFound;
+        report.keysWasted += stats.keysWasted;
+        report.riddles += stats.riddlesEncountered;
+        report.riddlesSolved += stats.riddlesSolved;
+        report.notes += stats.notesFound;
+        report.goldHistogram[finalState.getGoldBars()]++;
+    }
+
+    return report;
+}
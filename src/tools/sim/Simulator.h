@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include "../../core/GameRules.h"
+#include "../common/ToolContent.h"
+
+/**
+ * @brief SimulationConfig - Parameters of one Monte Carlo run
+ */
+struct SimulationConfig {
+    qint64 games = 100000;
+    int threads = 0;                // 0 = one per core
+    QString policy = "greedy";
+    quint64 seed = 1;
+    double riddleSolveRate = 0.5;   // Chance the simulated player answers correctly
+    int maxMovesPerGame = 10000;
+    GameRules rules;
+    QString recordDir;              // If set, every game is saved there as a journal
+};
+
+/**
+ * @brief SimulationReport - Aggregated outcome of simulated games
+ */
+struct SimulationReport {
+    qint64 games = 0;
+    qint64 wins = 0;
+    qint64 moves = 0;
+    qint64 lockedDoorAttempts = 0;
+    qint64 keysFound = 0;
+    qint64 keysWasted = 0;
+    qint64 riddles = 0;
+    qint64 riddlesSolved = 0;
+    qint64 notes = 0;
+    QMap<int, qint64> goldHistogram;    // gold bars -> games
+    double seconds = 0.0;
+
+    void merge(const SimulationReport& other);
+};
+
+/**
+ * @brief Simulator - Plays complete games headlessly, sharded across threads
+ *
+ * Every worker owns its GameSession, door policy and RNG streams, so workers
+ * never share mutable state and the per-thread reports are merged at the end.
+ * Game i is always seeded from (seed, i): the totals are bit-reproducible for
+ * any thread count.
+ */
+class Simulator {
+public:
+    Simulator(ContentCatalogPtr content, const SimulationConfig& config);
+
+    SimulationReport run();
+
+private:
+    SimulationReport runShard(qint64 firstGame, qint64 games) const;
+
+    ContentCatalogPtr m_content;
+    SimulationConfig m_config;
+};
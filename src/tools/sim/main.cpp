@@ -0,0 +1,124 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "Simulator.h"
+#include "DoorPolicy.h"
+#include "Replay.h"
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("labyrinth_sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Monte Carlo balance simulator for the labyrinth rules");
+    parser.addHelpOption();
+
+    QCommandLineOption gamesOption({"n", "games"}, "Number of games to play.", "count", "100000");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads (0 = all cores).", "count", "0");
+    QCommandLineOption policyOption({"p", "policy"},
+        QString("Door policy: %1, or 'all'.").arg(DoorPolicy::availablePolicies().join(", ")),
+        "name", "greedy");
+    QCommandLineOption seedOption("seed", "Base seed of the run.", "seed", "1");
+    QCommandLineOption solveOption("solve-rate", "Chance to answer a riddle correctly.", "p", "0.5");
+    QCommandLineOption ruleOption("set",
+        QString("Override a rule, e.g. --set noteChance=0.3. Rules: %1.").arg(GameRules::names().join(", ")),
+        "name=value");
+    QCommandLineOption syntheticOption("synthetic", "Use generated content instead of the database.");
+    QCommandLineOption recordOption("record", "Save every simulated game as a journal in this directory.", "dir");
+    QCommandLineOption replayOption("replay", "Replay a journal file, or every journal in a directory.", "path");
+    QCommandLineOption repeatOption("repeat", "Replay the journals this many times.", "count", "1");
+
+    parser.addOptions({gamesOption, threadsOption, policyOption, seedOption,
+                       solveOption, ruleOption, syntheticOption,
+                       recordOption, replayOption, repeatOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    SimulationConfig config;
+    config.games = parser.value(gamesOption).toLongLong();
+    config.threads = parser.value(threadsOption).toInt();
+    config.seed = parser.value(seedOption).toULongLong();
+    config.riddleSolveRate = parser.value(solveOption).toDouble();
+
+    for (const QString& assignment : parser.values(ruleOption)) {
+        QStringList parts = assignment.split('=');
+        bool ok = false;
+        double value = parts.size() == 2 ? parts[1].toDouble(&ok) : 0.0;
+        if (!ok || !config.rules.set(parts[0].trimmed(), value)) {
+            err << "Invalid rule override: " << assignment << Qt::endl;
+            return 1;
+        }
+    }
+
+    ContentCatalogPtr content;
+    if (parser.isSet(syntheticOption)) {
+        content = ToolContent::synthetic();
+    } else {
+        QString error;
+        if (!ToolContent::load(content, &error)) {
+            err << "Failed to load content: " << error << Qt::endl;
+            err << "Run with --synthetic to simulate without a database." << Qt::endl;
+            return 1;
+        }
+    }
+
+    if (parser.isSet(replayOption)) {
+        const QStringList journals = Replay::collectJournals(parser.value(replayOption));
+        const int repeat = parser.value(repeatOption).toInt();
+        // Per-game lines only for small sets, e.g. a single bug report
+        ReplayReport report = Replay::run(journals, content, config.rules, repeat,
+                                          journals.size() <= 20 ? &out : &err);
+
+        const double games = qMax<qint64>(1, report.games);
+        out << "=== replay: " << journals.size() << " journals ===" << Qt::endl;
+        out << "games:            " << report.games
+            << "  (" << qRound64(report.games / qMax(report.seconds, 1e-9)) << " games/s)" << Qt::endl;
+        out << "events per game:  " << QString::number(report.events / games, 'f', 1) << Qt::endl;
+        out << "bytes per game:   " << QString::number(report.bytes / games, 'f', 1) << Qt::endl;
+        out << "failures:         " << report.failures << Qt::endl;
+        out << "checksum:         " << QString::number(report.checksum, 16) << Qt::endl;
+        return report.failures > 0 ? 2 : 0;
+    }
+
+    config.recordDir = parser.value(recordOption);
+
+    QStringList policies = parser.value(policyOption) == "all"
+        ? DoorPolicy::availablePolicies()
+        : QStringList{parser.value(policyOption)};
+
+    for (const QString& policy : policies) {
+        if (!DoorPolicy::create(policy)) {
+            err << "Unknown policy: " << policy << Qt::endl;
+            return 1;
+        }
+
+        config.policy = policy;
+        Simulator simulator(content, config);
+        SimulationReport report = simulator.run();
+
+        const double games = qMax<qint64>(1, report.games);
+        out << "=== policy: " << policy << " ===" << Qt::endl;
+        out << "games:            " << report.games
+            << "  (" << qRound64(report.games / qMax(report.seconds, 1e-9)) << " games/s)" << Qt::endl;
+        out << "win rate:         " << QString::number(100.0 * report.wins / games, 'f', 3) << "%" << Qt::endl;
+        out << "moves per game:   " << QString::number(report.moves / games, 'f', 2) << Qt::endl;
+        out << "locked attempts:  " << QString::number(report.lockedDoorAttempts / games, 'f', 3) << " per game" << Qt::endl;
+        out << "keys found:       " << QString::number(report.keysFound / games, 'f', 3) << " per game" << Qt::endl;
+        out << "keys wasted:      " << QString::number(report.keysWasted / games, 'f', 3) << " per game" << Qt::endl;
+        out << "riddles:          " << QString::number(report.riddles / games, 'f', 3) << " per game, "
+            << report.riddlesSolved << " solved" << Qt::endl;
+        out << "notes:            " << QString::number(report.notes / games, 'f', 3) << " per game" << Qt::endl;
+        out << "gold bars:" << Qt::endl;
+        for (auto it = report.goldHistogram.cbegin(); it != report.goldHistogram.cend(); ++it) {
+            out << QString("  %1: %2 (%3%)")
+                       .arg(it.key(), 3)
+                       .arg(it.value(), 10)
+                       .arg(100.0 * it.value() / games, 0, 'f', 3)
+                << Qt::endl;
+        }
+    }
+
+    return 0;
+}
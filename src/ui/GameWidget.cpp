@@ -1,5 +1,5 @@
 #include "GameWidget.h"
-#include "../core/GameEngine.h"
+#include "../core/EngineWorker.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QScrollArea>
@@ -7,12 +7,20 @@
 #include "InventoryPanel.h"
 #include "NotesDialog.h"
 #include "RiddleDialog.h"
+#include "../utils/TypeWriter.h"
 #include <QMessageBox>
 #include <QApplication>
+#include <QTimer>
+#include <algorithm>
 
-GameWidget::GameWidget(GameEngine* engine, QWidget* parent)
-    : QWidget(parent), m_engine(engine) {
+GameWidget::GameWidget(EngineWorker* engine, QWidget* parent)
+    : QWidget(parent), m_engine(engine), m_inlineEngine(engine && engine->isInline()) {
     setupUI();
+
+    m_typeWriter = new TypeWriter(this);
+    connect(m_typeWriter, &TypeWriter::characterAdded, this, &GameWidget::onRoomDescriptionUpdated);
+    connect(m_typeWriter, &TypeWriter::typingFinished, this, &GameWidget::onTypeWriterFinished);
+
     setFocusPolicy(Qt::StrongFocus);
     setAutoFillBackground(true);
 }
@@ -54,7 +62,14 @@ void GameWidget::setupUI()
     m_notesButton = new QPushButton("Записки", this);
     m_notesButton->setStyleSheet("QPushButton { background-color: rgba(0,0,0,0.5); color: #fff; border: 2px solid #fff; padding: 10px; } QPushButton:hover { background-color: #fff; color: #000; }");
     m_inventoryPanel = new InventoryPanel(this);
+    m_hintButton = new QPushButton("Подсказка (H)", this);
+    m_hintButton->setStyleSheet("QPushButton { background-color: rgba(0,0,0,0.5); color: #fff; border: 2px solid #fff; padding: 10px; } QPushButton:hover { background-color: #fff; color: #000; }");
+    m_autoplayButton = new QPushButton("Автоигра", this);
+    m_autoplayButton->setCheckable(true);
+    m_autoplayButton->setStyleSheet("QPushButton { background-color: rgba(0,0,0,0.5); color: #fff; border: 2px solid #fff; padding: 10px; } QPushButton:hover, QPushButton:checked { background-color: #fff; color: #000; }");
     sidebarLayout->addWidget(m_notesButton);
+    sidebarLayout->addWidget(m_hintButton);
+    sidebarLayout->addWidget(m_autoplayButton);
     sidebarLayout->addStretch();
     sidebarLayout->addWidget(m_inventoryPanel);
     mainLayout->addLayout(sidebarLayout);
@@ -80,6 +95,8 @@ void GameWidget::setupUI()
     m_exitButton->setStyleSheet("QPushButton { background-color: rgba(0,0,0,0.5); color: #ff0000; border: 2px solid #ff0000; padding: 10px; } QPushButton:hover { background-color: #ff0000; color: #fff; }");
     connect(m_exitButton, &QPushButton::clicked, this, &GameWidget::onExitButtonClicked);
     connect(m_notesButton, &QPushButton::clicked, this, &GameWidget::onNotesButtonClicked);
+    connect(m_hintButton, &QPushButton::clicked, this, &GameWidget::requestHint);
+    connect(m_autoplayButton, &QPushButton::toggled, this, &GameWidget::onAutoplayToggled);
     exitLayout->addStretch();
     exitLayout->addWidget(m_exitButton);
     exitLayout->addStretch();
@@ -88,16 +105,106 @@ void GameWidget::setupUI()
     setLayout(mainLayout);
 }
 
+GameWidget::~GameWidget()
+{
+    if (m_inputToPaint.empty()) {
+        return;
+    }
+
+    auto percentile = [this](double p) -> double {
+        const size_t index = qMin(m_inputToPaint.size() - 1, static_cast<size_t>(p * m_inputToPaint.size()));
+        std::nth_element(m_inputToPaint.begin(), m_inputToPaint.begin() + index, m_inputToPaint.end());
+        return m_inputToPaint[index] / 1e6;
+    };
+
+    qDebug() << "Задержка ввод -> отрисовка" << (m_inlineEngine ? "(в потоке UI):" : "(поток движка):")
+             << "n =" << m_inputToPaint.size()
+             << "p50 =" << percentile(0.50) << "мс"
+             << "p99 =" << percentile(0.99) << "мс"
+             << "max =" << percentile(1.0) << "мс";
+}
+
+void GameWidget::onEngineEventDelivered(qint64 issuedAt)
+{
+    // Only the first state after an input counts; the next paint closes the sample
+    if (issuedAt != 0 && m_pendingInputAt == 0) {
+        m_pendingInputAt = issuedAt;
+        update();
+    }
+}
+
+void GameWidget::paintEvent(QPaintEvent* event)
+{
+    QWidget::paintEvent(event);
+
+    if (m_pendingInputAt != 0) {
+        m_inputToPaint.push_back(EngineWorker::now() - m_pendingInputAt);
+        m_pendingInputAt = 0;
+    }
+}
+
 void GameWidget::onGameInitialized(const GameState& state)
 {
     updateDisplay(state);
+    scheduleAutoplayMove();
 }
 
 void GameWidget::onGameStateChanged(const GameState& state)
 {
     qDebug() << "=== onGameStateChanged called ===";
-    qDebug() << "Logs count: " << state.getLogs().size();
+    qDebug() << "Logs count: " << state.getLog().size();
     updateDisplay(state);
+    scheduleAutoplayMove();
+}
+
+void GameWidget::requestHint()
+{
+    if (m_currentState.isGameOver() || m_currentState.hasActiveRiddle()) {
+        return;
+    }
+    m_hintVersion = m_stateVersion;
+    m_statusLabel->setText("Бот думает...");
+    emit hintRequested();
+}
+
+void GameWidget::onHintReady(int doorIndex, double expectedGold)
+{
+    // A move was made since the request; the door index may point elsewhere now
+    if (m_hintVersion != m_stateVersion || doorIndex < 0 || doorIndex >= m_doorButtons.size()) {
+        return;
+    }
+    m_hintVersion = -1;
+
+    if (m_autoplay) {
+        onDoorClicked(doorIndex);
+        return;
+    }
+
+    QPushButton* button = m_doorButtons[doorIndex];
+    button->setText("★ " + button->text());
+    m_statusLabel->setText(QString("Подсказка: дверь %1, ожидаемое золото до конца игры: %2")
+        .arg(doorIndex + 1)
+        .arg(expectedGold, 0, 'f', 1));
+}
+
+void GameWidget::onAutoplayToggled(bool enabled)
+{
+    m_autoplay = enabled;
+    scheduleAutoplayMove();
+}
+
+void GameWidget::scheduleAutoplayMove()
+{
+    // Riddles stay with the player; autoplay resumes after the answer
+    if (!m_autoplay || m_currentState.isGameOver() || m_currentState.hasActiveRiddle()) {
+        return;
+    }
+    const int version = m_stateVersion;
+    QTimer::singleShot(AUTOPLAY_DELAY_MS, this, [this, version]() {
+        if (m_autoplay && version == m_stateVersion) {
+            requestHint();
+        }
+    });
 }
 
 void GameWidget::onErrorOccurred(const QString& error)
@@ -108,6 +215,7 @@ void GameWidget::onErrorOccurred(const QString& error)
 void GameWidget::updateDisplay(const GameState& state)
 {
     m_currentState = state;
+    m_stateVersion++;
     if (!state.isTypeWriterActive()) {
         m_descriptionLabel->setText(state.getRoomDescription());
     }
@@ -133,10 +241,11 @@ void GameWidget::updateDisplay(const GameState& state)
 
     if (state.isGameWon()) {
         m_statusLabel->setText(" ПОБЕДА! Вы прошли все локации!");
+        m_autoplayButton->setChecked(false);
     }
 
     m_logView->clear();
-    for (const QString& log : state.getLogs()) {
+    for (const QString& log : state.getLog().lines()) {
         m_logView->append(log);
     }
 }
@@ -194,7 +303,7 @@ void GameWidget::onDoorClicked(int doorIndex)
 
 void GameWidget::onNoteFound(const NoteData& note)
 {
-    m_foundNotes.append(note);
+    Q_UNUSED(note);
     m_currentNotesFound++;
     m_notesButton->setText(QString("Записки (%1)").arg(m_currentNotesFound));
 }
@@ -227,7 +336,7 @@ void GameWidget::onRiddleDialogFinished(int result)
 
 void GameWidget::onNotesButtonClicked()
 {
-    NotesDialog dialog(m_foundNotes, this);
+    NotesDialog dialog(ContentCatalog::shared(), m_currentState.getNoteIds(), this);
     dialog.exec();
 }
 
@@ -242,6 +351,12 @@ void GameWidget::onExitButtonClicked()
     }
 }
 
+void GameWidget::onRoomDescriptionGenerated(const QString& text)
+{
+    m_typeWriter->startTyping(text, 50);
+    onTypeWriterStarted(text);
+}
+
 void GameWidget::onTypeWriterStarted(const QString& text)
 {
     m_typeWriterLabel->setText("");
@@ -291,7 +406,11 @@ void GameWidget::onGameWon(int notesFound, int goldBars)
 void GameWidget::keyPressEvent(QKeyEvent* event)
 {
     if (event->key() == Qt::Key_Space) {
-        m_engine->skipCurrentTypeWriter();
+        if (m_typeWriter->isTyping()) {
+            m_typeWriter->skipToEnd();
+        }
+    } else if (event->key() == Qt::Key_H) {
+        requestHint();
     }
     QWidget::keyPressEvent(event);
 }
\ No newline at end of file
@@ -6,16 +6,19 @@
 #include <QVBoxLayout>
 #include <QKeyEvent>
 #include <QTextEdit>
+#include <vector>
 #include "../core/GameState.h"
 
-class GameEngine;
+class EngineWorker;
 class InventoryPanel;
+class TypeWriter;
 
 class GameWidget : public QWidget {
     Q_OBJECT
 
 public:
-    explicit GameWidget(GameEngine* engine, QWidget* parent = nullptr);
+    explicit GameWidget(EngineWorker* engine, QWidget* parent = nullptr);
+    ~GameWidget() override;
 
 public slots:
     void onGameInitialized(const GameState& state);
@@ -23,13 +26,17 @@ public slots:
     void onErrorOccurred(const QString& error);
     void onNoteFound(const NoteData& note);
     void onRiddleEncountered(const RiddleData& riddle);
+    void onRoomDescriptionGenerated(const QString& text);
     void onTypeWriterStarted(const QString& text);
     void onTypeWriterFinished();
     void onRoomDescriptionUpdated(const QString& text);
     void onGameWon(int notesFound, int goldBars);
+    void onEngineEventDelivered(qint64 issuedAt);
+    void onHintReady(int doorIndex, double expectedGold);
 signals:
     void doorSelected(int doorIndex);
     void riddleAnswered(const QString& answer);
+    void hintRequested();
 private slots:
     void onRiddleDialogFinished(int result);
 private:
@@ -41,12 +48,16 @@ private:
 
     void onNotesButtonClicked();
     void onExitButtonClicked();
+    void onAutoplayToggled(bool enabled);
+    void requestHint();
+    void scheduleAutoplayMove();
 
 protected:
     void resizeEvent(QResizeEvent* event) override;
     void keyPressEvent(QKeyEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
 
-    GameEngine* m_engine = nullptr;
+    EngineWorker* m_engine = nullptr;
     QLabel* m_descriptionLabel = nullptr;
     QLabel* m_statusLabel = nullptr;
     InventoryPanel* m_inventoryPanel = nullptr;
@@ -54,12 +65,23 @@ protected:
     QVector<QPushButton*> m_doorButtons;
 
     QLabel* m_typeWriterLabel = nullptr;
+    TypeWriter* m_typeWriter = nullptr;
     QPushButton* m_notesButton = nullptr;
     QPushButton* m_exitButton = nullptr;
+    QPushButton* m_hintButton = nullptr;
+    QPushButton* m_autoplayButton = nullptr;
     QLabel* m_notesCounterLabel = nullptr;
 
     int m_currentNotesFound = 0;
-    QVector<NoteData> m_foundNotes;
     QTextEdit* m_logView = nullptr;
 
+    // Bot: hints are only shown for the state they were asked for
+    bool m_autoplay = false;
+    int m_stateVersion = 0;
+    int m_hintVersion = -1;
+
+    // Input-to-paint latency: input time of the state waiting to be painted, in ns
+    bool m_inlineEngine = false;
+    qint64 m_pendingInputAt = 0;
+    std::vector<qint64> m_inputToPaint;
 };
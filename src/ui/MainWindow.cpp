@@ -1,6 +1,6 @@
 #include "MainWindow.h"
 #include "GameWidget.h"
-#include "../core/GameEngine.h"
+#include "../core/EngineWorker.h"
 #include <QVBoxLayout>
 #include <QWidget>
 #include <QTimer>
@@ -9,7 +9,7 @@
 
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent),
-      m_engine(std::make_unique<GameEngine>()),
+      m_engine(std::make_unique<EngineWorker>()),
       m_gameWidget(new GameWidget(m_engine.get(), this))
 {
     setupUI();
@@ -19,13 +19,17 @@ MainWindow::MainWindow(QWidget* parent)
     resize(1200, 800);
     
     // Initialize game
-    QTimer::singleShot(0, m_engine.get(), &GameEngine::initializeGame);
+    QTimer::singleShot(0, m_engine.get(), &EngineWorker::initializeGame);
 
     // Set focus to the game widget
     m_gameWidget->setFocus();
 }
 
-MainWindow::~MainWindow() = default;
+MainWindow::~MainWindow()
+{
+    // Stop the engine thread before the widget it reports to goes away
+    m_engine.reset();
+}
 
 void MainWindow::setupUI()
 {
@@ -40,17 +44,18 @@ void MainWindow::setupUI()
 
 void MainWindow::connectSignals()
 {
-    // Connect engine signals to game widget
-    connect(m_engine.get(), &GameEngine::gameInitialized, m_gameWidget, &GameWidget::onGameInitialized);
-    connect(m_engine.get(), &GameEngine::gameStateChanged, m_gameWidget, &GameWidget::onGameStateChanged);
-    connect(m_engine.get(), &GameEngine::errorOccurred, m_gameWidget, &GameWidget::onErrorOccurred);
-    connect(m_gameWidget, &GameWidget::doorSelected, m_engine.get(), &GameEngine::onDoorSelected);
-    connect(m_engine.get(), &GameEngine::noteFound, m_gameWidget, &GameWidget::onNoteFound);
-    connect(m_engine.get(), &GameEngine::riddleEncountered, m_gameWidget, &GameWidget::onRiddleEncountered);
-    connect(m_gameWidget, &GameWidget::riddleAnswered, m_engine.get(), &GameEngine::handleRiddleAnswer);
-    connect(m_engine.get(), &GameEngine::gameWon, m_gameWidget, &GameWidget::onGameWon);
-    connect(m_engine.get(), &GameEngine::typeWriterStarted, m_gameWidget, &GameWidget::onTypeWriterStarted);
-    connect(m_engine.get(), &GameEngine::roomDescriptionUpdated, m_gameWidget, &GameWidget::onRoomDescriptionUpdated);
-    connect(m_engine.get(), &GameEngine::typeWriterFinished, m_gameWidget, &GameWidget::onTypeWriterFinished);
+    // Engine signals arrive on the UI thread, drained from the worker's event queue
+    connect(m_engine.get(), &EngineWorker::gameInitialized, m_gameWidget, &GameWidget::onGameInitialized);
+    connect(m_engine.get(), &EngineWorker::gameStateChanged, m_gameWidget, &GameWidget::onGameStateChanged);
+    connect(m_engine.get(), &EngineWorker::errorOccurred, m_gameWidget, &GameWidget::onErrorOccurred);
+    connect(m_gameWidget, &GameWidget::doorSelected, m_engine.get(), &EngineWorker::chooseDoor);
+    connect(m_engine.get(), &EngineWorker::noteFound, m_gameWidget, &GameWidget::onNoteFound);
+    connect(m_engine.get(), &EngineWorker::riddleEncountered, m_gameWidget, &GameWidget::onRiddleEncountered);
+    connect(m_gameWidget, &GameWidget::riddleAnswered, m_engine.get(), &EngineWorker::answerRiddle);
+    connect(m_engine.get(), &EngineWorker::gameWon, m_gameWidget, &GameWidget::onGameWon);
+    connect(m_engine.get(), &EngineWorker::roomDescriptionGenerated, m_gameWidget, &GameWidget::onRoomDescriptionGenerated);
+    connect(m_engine.get(), &EngineWorker::eventDelivered, m_gameWidget, &GameWidget::onEngineEventDelivered);
+    connect(m_gameWidget, &GameWidget::hintRequested, m_engine.get(), &EngineWorker::requestHint);
+    connect(m_engine.get(), &EngineWorker::hintReady, m_gameWidget, &GameWidget::onHintReady);
 }
 
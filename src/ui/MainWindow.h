@@ -4,7 +4,7 @@
 #include <memory>
 #include <QPushButton>
 
-class GameEngine;
+class EngineWorker;
 class GameWidget;
 
 class MainWindow : public QMainWindow {
@@ -18,6 +18,6 @@ private:
     void setupUI();
     void connectSignals();
 
-    std::unique_ptr<GameEngine> m_engine;
+    std::unique_ptr<EngineWorker> m_engine;
     GameWidget* m_gameWidget = nullptr;
 };
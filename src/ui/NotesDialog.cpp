@@ -5,8 +5,8 @@
 #include <QString>
 #include <QPushButton>
 
-NotesDialog::NotesDialog(const QVector<NoteData>& notes, QWidget* parent)
-    : QDialog(parent), m_notes(notes)
+NotesDialog::NotesDialog(ContentCatalogPtr content, const PersistentVector<ContentId>& noteIds, QWidget* parent)
+    : QDialog(parent), m_content(std::move(content)), m_noteIds(noteIds)
 {
     setWindowTitle("[Записки] Найденные послания");
     setModal(true);
@@ -71,18 +71,18 @@ void NotesDialog::updateNotesDisplay()
 {
     m_notesList->clear();
 
-    for (int i = 0; i < m_notes.size(); ++i) {
+    for (int i = 0; i < m_noteIds.size(); ++i) {
         QString itemText = QString("Записка #%1").arg(i + 1);
         QListWidgetItem* item = new QListWidgetItem(itemText);
         m_notesList->addItem(item);
     }
 
     m_counterLabel->setText(
-        QString("Записок найдено: %1").arg(m_notes.size())
+        QString("Записок найдено: %1").arg(m_noteIds.size())
     );
 
     // Выбрать первую записку по умолчанию
-    if (!m_notes.isEmpty()) {
+    if (!m_noteIds.isEmpty()) {
         m_notesList->setCurrentRow(0);
         onNoteSelected(0);
     }
@@ -90,7 +90,10 @@ void NotesDialog::updateNotesDisplay()
 
 void NotesDialog::onNoteSelected(int index)
 {
-    if (index >= 0 && index < m_notes.size()) {
-        m_noteContent->setText(m_notes[index].content);
+    if (!m_content || index < 0 || index >= m_noteIds.size()) {
+        return;
+    }
+    if (const NoteData* note = m_content->note(m_noteIds[index])) {
+        m_noteContent->setText(note->content);
     }
 }
\ No newline at end of file
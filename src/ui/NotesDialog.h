@@ -4,23 +4,27 @@
 #include <QListWidget>
 #include <QLabel>
 #include <QTextEdit>
-#include "../core/Types.h"
+#include "../core/ContentCatalog.h"
+#include "../utils/PersistentVector.h"
 
 /**
  * @brief NotesDialog - Окно просмотра найденных записок
+ *
+ * Получает id записок из состояния игры, тексты берёт из каталога контента.
  */
 class NotesDialog : public QDialog {
     Q_OBJECT
 
 public:
-    explicit NotesDialog(const QVector<NoteData>& notes, QWidget* parent = nullptr);
+    NotesDialog(ContentCatalogPtr content, const PersistentVector<ContentId>& noteIds, QWidget* parent = nullptr);
 
 private:
     void setupUI();
     void updateNotesDisplay();
 
 private:
-    QVector<NoteData> m_notes;
+    ContentCatalogPtr m_content;
+    PersistentVector<ContentId> m_noteIds;
     QListWidget* m_notesList = nullptr;
     QTextEdit* m_noteContent = nullptr;
     QLabel* m_counterLabel = nullptr;
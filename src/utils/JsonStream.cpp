@@ -0,0 +1,480 @@
+#include "JsonStream.h"
+#include <QLocale>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+// Four hex digits of a \u escape; -1 if malformed
+int hex4(const char* digits)
+{
+    int code = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int digit = hexDigit(digits[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        code = code * 16 + digit;
+    }
+    return code;
+}
+
+}
+
+void JsonWriter::key(QStringView name)
+{
+    separate();
+    appendString(m_out, name);
+    m_out.append(':');
+    m_afterKey = true;
+}
+
+void JsonWriter::value(qint64 number)
+{
+    separate();
+    char digits[24];
+    const std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), number);
+    m_out.append(digits, result.ptr - digits);
+}
+
+void JsonWriter::value(double number)
+{
+    separate();
+    // JSON has no NaN or infinity; QJsonDocument writes null for them too
+    if (!std::isfinite(number)) {
+        m_out.append("null");
+        return;
+    }
+    m_out.append(QByteArray::number(number, 'g', QLocale::FloatingPointShortest));
+}
+
+void JsonWriter::value(bool flag)
+{
+    separate();
+    m_out.append(flag ? "true" : "false");
+}
+
+void JsonWriter::value(QStringView text)
+{
+    separate();
+    appendString(m_out, text);
+}
+
+void JsonWriter::null()
+{
+    separate();
+    m_out.append("null");
+}
+
+void JsonWriter::appendString(QByteArray& out, QStringView text)
+{
+    static const char Hex[] = "0123456789abcdef";
+    const char16_t* p = text.utf16();
+    const char16_t* const end = p + text.size();
+
+    out.append('"');
+    while (p < end) {
+        // Printable ASCII is copied as is, a run at a time
+        const char16_t* run = p;
+        while (p < end && *p >= 0x20 && *p < 0x80 && *p != u'"' && *p != u'\\') {
+            ++p;
+        }
+        if (p > run) {
+            const qsizetype at = out.size();
+            out.resize(at + (p - run));
+            char* dst = out.data() + at;
+            while (run < p) {
+                *dst++ = static_cast<char>(*run++);
+            }
+        }
+        if (p == end) {
+            break;
+        }
+
+        const char16_t c = *p++;
+        if (c < 0x80) {
+            switch (c) {
+                case u'"': out.append("\\\"", 2); break;
+                case u'\\': out.append("\\\\", 2); break;
+                case u'\n': out.append("\\n", 2); break;
+                case u'\r': out.append("\\r", 2); break;
+                case u'\t': out.append("\\t", 2); break;
+                case u'\b': out.append("\\b", 2); break;
+                case u'\f': out.append("\\f", 2); break;
+                default: {
+                    const char escape[6] = {'\\', 'u', '0', '0', Hex[c >> 4], Hex[c & 0xF]};
+                    out.append(escape, 6);
+                }
+            }
+            continue;
+        }
+
+        char utf8[4];
+        int length = 0;
+        if (c < 0x800) {
+            utf8[0] = static_cast<char>(0xC0 | (c >> 6));
+            utf8[1] = static_cast<char>(0x80 | (c & 0x3F));
+            length = 2;
+        } else if (QChar::isHighSurrogate(c) && p < end && QChar::isLowSurrogate(*p)) {
+            const char32_t code = QChar::surrogateToUcs4(c, *p++);
+            utf8[0] = static_cast<char>(0xF0 | (code >> 18));
+            utf8[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            utf8[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            utf8[3] = static_cast<char>(0x80 | (code & 0x3F));
+            length = 4;
+        } else if (QChar::isSurrogate(c)) {
+            // Unpaired surrogate: U+FFFD, as QString::toUtf8() does
+            utf8[0] = '\xEF';
+            utf8[1] = '\xBF';
+            utf8[2] = '\xBD';
+            length = 3;
+        } else {
+            utf8[0] = static_cast<char>(0xE0 | (c >> 12));
+            utf8[1] = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            utf8[2] = static_cast<char>(0x80 | (c & 0x3F));
+            length = 3;
+        }
+        out.append(utf8, length);
+    }
+    out.append('"');
+}
+
+void JsonWriter::separate()
+{
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (!m_first.isEmpty()) {
+        if (!m_first.last()) {
+            m_out.append(',');
+        }
+        m_first.last() = false;
+    }
+}
+
+void JsonWriter::open(char bracket)
+{
+    separate();
+    m_out.append(bracket);
+    m_first.append(true);
+}
+
+void JsonWriter::close(char bracket)
+{
+    m_out.append(bracket);
+    if (!m_first.isEmpty()) {
+        m_first.removeLast();
+    }
+}
+
+JsonReader::Token JsonReader::next()
+{
+    const char* const data = m_data.data();
+    const qsizetype size = m_data.size();
+    for (;;) {
+        while (m_pos < size && isSpace(data[m_pos])) {
+            ++m_pos;
+        }
+        if (m_pos == size) {
+            return m_stack.isEmpty() && m_expect == Separator ? End : fail();
+        }
+
+        const char c = data[m_pos];
+        switch (m_expect) {
+            case Colon:
+                if (c != ':') {
+                    return fail();
+                }
+                ++m_pos;
+                m_expect = Value;
+                continue;
+
+            case Separator:
+                if (m_stack.isEmpty()) {
+                    return fail();          // Trailing data after the document
+                }
+                if (c == ',') {
+                    ++m_pos;
+                    m_expect = m_stack.last() == '{' ? Key : Value;
+                    continue;
+                }
+                return close(c);
+
+            case Key: {
+                if (c == '}' && m_justOpened) {
+                    return close(c);
+                }
+                m_justOpened = false;
+                if (c != '"') {
+                    return fail();
+                }
+                const Token token = scanString();
+                if (token == String) {
+                    m_expect = Colon;
+                }
+                return token;
+            }
+
+            case Value:
+                if (c == ']' && m_justOpened) {
+                    return close(c);
+                }
+                m_justOpened = false;
+                switch (c) {
+                    case '[':
+                    case '{':
+                        ++m_pos;
+                        m_stack.append(c);
+                        m_expect = c == '[' ? Value : Key;
+                        m_justOpened = true;
+                        return c == '[' ? ArrayBegin : ObjectBegin;
+                    case '"': {
+                        const Token token = scanString();
+                        if (token == String) {
+                            m_expect = Separator;
+                        }
+                        return token;
+                    }
+                    case 't':
+                        return scanLiteral("true", True);
+                    case 'f':
+                        return scanLiteral("false", False);
+                    case 'n':
+                        return scanLiteral("null", Null);
+                    default:
+                        return scanNumber();
+                }
+        }
+    }
+}
+
+bool JsonReader::skipValue(Token first)
+{
+    if (first == Error || first == End) {
+        return false;
+    }
+    if (first != ArrayBegin && first != ObjectBegin) {
+        return true;
+    }
+    for (int depth = 1; depth > 0;) {
+        switch (next()) {
+            case ArrayBegin:
+            case ObjectBegin:
+                ++depth;
+                break;
+            case ArrayEnd:
+            case ObjectEnd:
+                --depth;
+                break;
+            case Error:
+            case End:
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+QString JsonReader::string() const
+{
+    if (!m_escaped) {
+        return QString::fromUtf8(m_token);
+    }
+
+    // Escapes were validated by scanString()
+    QString text;
+    text.reserve(m_token.size());
+    const char* const data = m_token.data();
+    qsizetype run = 0;
+    qsizetype i = 0;
+    while (i < m_token.size()) {
+        if (data[i] != '\\') {
+            ++i;
+            continue;
+        }
+        text += QString::fromUtf8(data + run, i - run);
+        const char escape = data[i + 1];
+        i += 2;
+        switch (escape) {
+            case 'n': text += QChar(u'\n'); break;
+            case 'r': text += QChar(u'\r'); break;
+            case 't': text += QChar(u'\t'); break;
+            case 'b': text += QChar(u'\b'); break;
+            case 'f': text += QChar(u'\f'); break;
+            case 'u':
+                // Surrogate pairs arrive as two escapes and stay two QChars
+                text += QChar(static_cast<char16_t>(hex4(data + i)));
+                i += 4;
+                break;
+            default:
+                text += QChar(static_cast<char16_t>(escape));       // " \ /
+                break;
+        }
+        run = i;
+    }
+    text += QString::fromUtf8(data + run, m_token.size() - run);
+    return text;
+}
+
+double JsonReader::number() const
+{
+    return m_token.toDouble();
+}
+
+bool JsonReader::integer(qint64& value) const
+{
+    for (char c : m_token) {
+        if (c == '.' || c == 'e' || c == 'E') {
+            return false;
+        }
+    }
+    bool ok = false;
+    value = m_token.toLongLong(&ok);
+    return ok;
+}
+
+JsonReader::Token JsonReader::fail()
+{
+    // Sticky: every later next() reports the error again
+    m_pos = m_data.size();
+    m_stack.clear();
+    m_expect = Value;
+    return Error;
+}
+
+JsonReader::Token JsonReader::close(char bracket)
+{
+    const char open = bracket == ']' ? '[' : bracket == '}' ? '{' : 0;
+    if (open == 0 || m_stack.isEmpty() || m_stack.last() != open) {
+        return fail();
+    }
+    m_stack.removeLast();
+    ++m_pos;
+    m_expect = Separator;
+    m_justOpened = false;
+    return bracket == ']' ? ArrayEnd : ObjectEnd;
+}
+
+JsonReader::Token JsonReader::scanString()
+{
+    const char* const data = m_data.data();
+    const qsizetype size = m_data.size();
+    m_escaped = false;
+    for (qsizetype i = m_pos + 1; i < size;) {
+        const uchar c = static_cast<uchar>(data[i]);
+        if (c == '"') {
+            m_token = m_data.sliced(m_pos + 1, i - m_pos - 1);
+            m_pos = i + 1;
+            return String;
+        }
+        if (c < 0x20) {
+            return fail();
+        }
+        if (c != '\\') {
+            ++i;
+            continue;
+        }
+
+        m_escaped = true;
+        if (i + 1 >= size) {
+            return fail();
+        }
+        switch (data[i + 1]) {
+            case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                i += 2;
+                break;
+            case 'u':
+                if (i + 6 > size || hex4(data + i + 2) < 0) {
+                    return fail();
+                }
+                i += 6;
+                break;
+            default:
+                return fail();
+        }
+    }
+    return fail();
+}
+
+JsonReader::Token JsonReader::scanNumber()
+{
+    const char* const data = m_data.data();
+    const qsizetype size = m_data.size();
+    qsizetype i = m_pos;
+    if (i < size && data[i] == '-') {
+        ++i;
+    }
+    if (i >= size || !isDigit(data[i])) {
+        return fail();
+    }
+    if (data[i] == '0') {
+        ++i;
+    } else {
+        while (i < size && isDigit(data[i])) {
+            ++i;
+        }
+    }
+    if (i < size && data[i] == '.') {
+        ++i;
+        if (i >= size || !isDigit(data[i])) {
+            return fail();
+        }
+        while (i < size && isDigit(data[i])) {
+            ++i;
+        }
+    }
+    if (i < size && (data[i] == 'e' || data[i] == 'E')) {
+        ++i;
+        if (i < size && (data[i] == '+' || data[i] == '-')) {
+            ++i;
+        }
+        if (i >= size || !isDigit(data[i])) {
+            return fail();
+        }
+        while (i < size && isDigit(data[i])) {
+            ++i;
+        }
+    }
+    m_token = m_data.sliced(m_pos, i - m_pos);
+    m_pos = i;
+    m_expect = Separator;
+    return Number;
+}
+
+JsonReader::Token JsonReader::scanLiteral(const char* literal, Token token)
+{
+    const qsizetype length = static_cast<qsizetype>(std::strlen(literal));
+    if (m_data.size() - m_pos < length || std::memcmp(m_data.data() + m_pos, literal, length) != 0) {
+        return fail();
+    }
+    m_pos += length;
+    m_expect = Separator;
+    return token;
+}
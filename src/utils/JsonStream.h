@@ -0,0 +1,110 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QString>
+#include <QStringView>
+#include <QVarLengthArray>
+
+/**
+ * @brief JsonWriter - Appends compact JSON to a UTF-8 buffer as values arrive
+ *
+ * Strings go from UTF-16 to escaped UTF-8 in one pass; there is no document
+ * tree. The caller keeps the nesting balanced.
+ */
+class JsonWriter {
+public:
+    explicit JsonWriter(QByteArray& out) : m_out(out) {}
+
+    void beginArray() { open('['); }
+    void endArray() { close(']'); }
+    void beginObject() { open('{'); }
+    void endObject() { close('}'); }
+
+    // Member name inside an object; the value follows
+    void key(QStringView name);
+
+    void value(qint64 number);
+    void value(int number) { value(static_cast<qint64>(number)); }
+    void value(double number);
+    void value(bool flag);
+    void value(QStringView text);
+    void value(const QString& text) { value(QStringView(text)); }
+    void value(const char*) = delete;       // Would pick value(bool)
+    void null();
+
+    // text as a JSON string literal, quotes included
+    static void appendString(QByteArray& out, QStringView text);
+
+private:
+    void separate();
+    void open(char bracket);
+    void close(char bracket);
+
+    QByteArray& m_out;
+    QVarLengthArray<bool, 16> m_first;      // Per open container: nothing written yet
+    bool m_afterKey = false;
+};
+
+/**
+ * @brief JsonReader - Pull parser over a UTF-8 JSON buffer
+ *
+ * next() returns one token at a time and validates the structure as it goes;
+ * strings and numbers stay views of the buffer until string() or number()
+ * decodes them. Object member names come as String tokens before their
+ * values. The buffer must outlive the reader.
+ */
+class JsonReader {
+public:
+    enum Token {
+        ArrayBegin,
+        ArrayEnd,
+        ObjectBegin,
+        ObjectEnd,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        End,            // The document is complete
+        Error
+    };
+
+    explicit JsonReader(QByteArrayView json) : m_data(json) {}
+
+    Token next();
+
+    // Skip the value whose first token was just returned by next()
+    bool skipValue(Token first);
+
+    // Current String token, unescaped
+    QString string() const;
+    // Current Number token
+    double number() const;
+    // Current Number token if it is an integer that fits, else false
+    bool integer(qint64& value) const;
+
+    qsizetype position() const { return m_pos; }
+
+private:
+    enum Expect : quint8 {
+        Value,
+        Key,
+        Colon,
+        Separator
+    };
+
+    Token fail();
+    Token close(char bracket);
+    Token scanString();
+    Token scanNumber();
+    Token scanLiteral(const char* literal, Token token);
+
+    QByteArrayView m_data;
+    qsizetype m_pos = 0;
+    QVarLengthArray<char, 16> m_stack;
+    Expect m_expect = Value;
+    bool m_justOpened = false;
+    bool m_escaped = false;                 // Current string has escapes
+    QByteArrayView m_token;                 // String contents without quotes, or the number
+};
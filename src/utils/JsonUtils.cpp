@@ -1,43 +1,56 @@
 #include "JsonUtils.h"
-#include <QJsonDocument>
-#include <QJsonArray>
+#include "JsonStream.h"
 #include <QDebug>
+#include <climits>
+#include <cmath>
 
 QString JsonUtils::inventoryToJson(const QVector<int>& inventory)
 {
-    QJsonArray array;
+    return QString::fromUtf8(inventoryToJsonUtf8(inventory));
+}
+
+QString JsonUtils::logsToJson(const QVector<QString>& logs)
+{
+    return QString::fromUtf8(logsToJsonUtf8(logs));
+}
+
+QByteArray JsonUtils::inventoryToJsonUtf8(const QVector<int>& inventory)
+{
+    QByteArray json;
+    JsonWriter writer(json);
+    writer.beginArray();
     for (int item : inventory) {
-        array.append(item);
+        writer.value(item);
     }
-    QJsonDocument doc(array);
-    return QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+    writer.endArray();
+    return json;
 }
 
-QString JsonUtils::logsToJson(const QVector<QString>& logs)
+QByteArray JsonUtils::logsToJsonUtf8(const QVector<QString>& logs)
 {
-    QJsonArray array;
+    // Room for quotes, commas and Cyrillic text at two bytes a character
+    qsizetype estimate = 2;
+    for (const QString& log : logs) {
+        estimate += 2 * log.size() + 3;
+    }
+    QByteArray json;
+    json.reserve(estimate);
+
+    JsonWriter writer(json);
+    writer.beginArray();
     for (const QString& log : logs) {
-        array.append(log);
+        writer.value(log);
     }
-    QJsonDocument doc(array);
-    return QString::fromUtf8(doc.toJson(QJsonDocument::Compact));
+    writer.endArray();
+    return json;
 }
 
 QVector<int> JsonUtils::inventoryFromJson(const QString& json)
 {
     QVector<int> inventory;
-    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
-    
-    if (!doc.isArray()) {
+    if (!inventoryFromJsonUtf8(json.toUtf8(), inventory)) {
         qWarning() << "Invalid inventory JSON format";
-        return inventory;
-    }
-
-    QJsonArray array = doc.array();
-    for (const QJsonValue& value : array) {
-        if (value.isDouble()) {
-            inventory.append(static_cast<int>(value.toDouble()));
-        }
+        inventory.clear();
     }
     return inventory;
 }
@@ -45,18 +58,54 @@ QVector<int> JsonUtils::inventoryFromJson(const QString& json)
 QVector<QString> JsonUtils::logsFromJson(const QString& json)
 {
     QVector<QString> logs;
-    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
-    
-    if (!doc.isArray()) {
+    if (!logsFromJsonUtf8(json.toUtf8(), logs)) {
         qWarning() << "Invalid logs JSON format";
-        return logs;
+        logs.clear();
     }
+    return logs;
+}
 
-    QJsonArray array = doc.array();
-    for (const QJsonValue& value : array) {
-        if (value.isString()) {
-            logs.append(value.toString());
+bool JsonUtils::inventoryFromJsonUtf8(QByteArrayView json, QVector<int>& inventory)
+{
+    inventory.clear();
+    JsonReader reader(json);
+    if (reader.next() != JsonReader::ArrayBegin) {
+        return false;
+    }
+    for (JsonReader::Token token = reader.next(); token != JsonReader::ArrayEnd; token = reader.next()) {
+        if (token == JsonReader::Number) {
+            // Only whole numbers in int range are items; "2.0" counts as 2
+            qint64 value = 0;
+            if (!reader.integer(value)) {
+                const double number = reader.number();
+                if (number != std::floor(number) || std::fabs(number) > INT_MAX) {
+                    continue;
+                }
+                value = static_cast<qint64>(number);
+            }
+            if (value >= INT_MIN && value <= INT_MAX) {
+                inventory.append(static_cast<int>(value));
+            }
+        } else if (!reader.skipValue(token)) {
+            return false;
         }
     }
-    return logs;
+    return reader.next() == JsonReader::End;
+}
+
+bool JsonUtils::logsFromJsonUtf8(QByteArrayView json, QVector<QString>& logs)
+{
+    logs.clear();
+    JsonReader reader(json);
+    if (reader.next() != JsonReader::ArrayBegin) {
+        return false;
+    }
+    for (JsonReader::Token token = reader.next(); token != JsonReader::ArrayEnd; token = reader.next()) {
+        if (token == JsonReader::String) {
+            logs.append(reader.string());
+        } else if (!reader.skipValue(token)) {
+            return false;
+        }
+    }
+    return reader.next() == JsonReader::End;
 }
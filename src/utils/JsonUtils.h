@@ -1,10 +1,16 @@
 #pragma once
 
+#include <QByteArray>
+#include <QByteArrayView>
 #include <QString>
 #include <QVector>
 
 /**
  * @brief JsonUtils - Utility functions for JSON serialization
+ *
+ * Built on JsonWriter and JsonReader: arrays are written and parsed in one
+ * pass over UTF-8, without a QJsonDocument in between. The QString overloads
+ * only convert at the edges.
  */
 class JsonUtils {
 public:
@@ -13,8 +19,12 @@ public:
     // Serialize game data to JSON
     static QString inventoryToJson(const QVector<int>& inventory);
     static QString logsToJson(const QVector<QString>& logs);
+    static QByteArray inventoryToJsonUtf8(const QVector<int>& inventory);
+    static QByteArray logsToJsonUtf8(const QVector<QString>& logs);
 
-    // Deserialize game data from JSON
+    // Deserialize game data from JSON; elements of other types are skipped
     static QVector<int> inventoryFromJson(const QString& json);
     static QVector<QString> logsFromJson(const QString& json);
+    static bool inventoryFromJsonUtf8(QByteArrayView json, QVector<int>& inventory);
+    static bool logsFromJsonUtf8(QByteArrayView json, QVector<QString>& logs);
 };
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * @brief PersistentVector - Append-only vector with structural sharing
+ *
+ * Elements live in fixed-size chunks linked from the newest to the oldest.
+ * Copying the vector copies one pointer and a size, so snapshots of a growing
+ * history are O(1). Appending to a copy reuses the shared tail chunk when no
+ * other copy has appended past this size yet (claimed with a CAS), otherwise
+ * only the tail chunk is copied. Published elements are never modified, which
+ * makes copies safe to hand to other threads.
+ *
+ * Random access walks the chunk list and costs O(size / ChunkSize); iterate
+ * with begin()/end() or use last() when possible.
+ */
+template<typename T, int ChunkSize = 32>
+class PersistentVector {
+    static_assert(ChunkSize > 0, "ChunkSize must be positive");
+
+    struct Chunk {
+        std::shared_ptr<Chunk> previous;
+        std::atomic<int> claimed{0};
+        alignas(T) unsigned char storage[sizeof(T) * ChunkSize];
+
+        T* items() { return reinterpret_cast<T*>(storage); }
+        const T* items() const { return reinterpret_cast<const T*>(storage); }
+
+        ~Chunk()
+        {
+            const int count = claimed.load(std::memory_order_relaxed);
+            for (int i = 0; i < count; ++i) {
+                items()[i].~T();
+            }
+        }
+    };
+
+public:
+    class const_iterator {
+    public:
+        using value_type = T;
+        using reference = const T&;
+        using pointer = const T*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() = default;
+        const_iterator(std::shared_ptr<const std::vector<const Chunk*>> spine, int index)
+            : m_spine(std::move(spine)), m_index(index) {}
+
+        reference operator*() const { return (*m_spine)[m_index / ChunkSize]->items()[m_index % ChunkSize]; }
+        pointer operator->() const { return &**this; }
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++m_index; return copy; }
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+
+    private:
+        std::shared_ptr<const std::vector<const Chunk*>> m_spine;
+        int m_index = 0;
+    };
+
+    PersistentVector() = default;
+    PersistentVector(const PersistentVector&) = default;
+    PersistentVector(PersistentVector&&) noexcept = default;
+    PersistentVector& operator=(const PersistentVector&) = default;
+    PersistentVector& operator=(PersistentVector&&) noexcept = default;
+
+    ~PersistentVector()
+    {
+        // Release unshared chunks iteratively instead of recursing through the chain
+        std::shared_ptr<Chunk> chunk = std::move(m_tail);
+        while (chunk && chunk.use_count() == 1) {
+            chunk = std::move(chunk->previous);
+        }
+    }
+
+    PersistentVector(const QVector<T>& values)
+    {
+        for (const T& value : values) {
+            append(value);
+        }
+    }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    void clear()
+    {
+        m_tail.reset();
+        m_size = 0;
+    }
+
+    void append(const T& value)
+    {
+        const int used = m_size % ChunkSize;
+
+        if (used == 0) {
+            auto chunk = std::make_shared<Chunk>();
+            chunk->previous = m_tail;
+            new (chunk->items()) T(value);
+            chunk->claimed.store(1, std::memory_order_release);
+            m_tail = std::move(chunk);
+            ++m_size;
+            return;
+        }
+
+        int expected = used;
+        if (m_tail->claimed.compare_exchange_strong(expected, used + 1, std::memory_order_acq_rel)) {
+            // Nobody else extended the shared tail past our size: write in place
+            new (m_tail->items() + used) T(value);
+        } else {
+            // Another copy already owns the slot: fork only the tail chunk
+            auto chunk = std::make_shared<Chunk>();
+            chunk->previous = m_tail->previous;
+            for (int i = 0; i < used; ++i) {
+                new (chunk->items() + i) T(m_tail->items()[i]);
+            }
+            new (chunk->items() + used) T(value);
+            chunk->claimed.store(used + 1, std::memory_order_release);
+            m_tail = std::move(chunk);
+        }
+        ++m_size;
+    }
+
+    const T& last() const
+    {
+        return m_tail->items()[(m_size - 1) % ChunkSize];
+    }
+
+    const T& at(int index) const
+    {
+        const Chunk* chunk = m_tail.get();
+        for (int steps = (m_size - 1) / ChunkSize - index / ChunkSize; steps > 0; --steps) {
+            chunk = chunk->previous.get();
+        }
+        return chunk->items()[index % ChunkSize];
+    }
+
+    const T& operator[](int index) const { return at(index); }
+
+    const_iterator begin() const
+    {
+        auto spine = std::make_shared<std::vector<const Chunk*>>((m_size + ChunkSize - 1) / ChunkSize);
+        const Chunk* chunk = m_tail.get();
+        for (auto it = spine->rbegin(); it != spine->rend(); ++it) {
+            *it = chunk;
+            chunk = chunk->previous.get();
+        }
+        return const_iterator(std::move(spine), 0);
+    }
+
+    const_iterator end() const { return const_iterator(nullptr, m_size); }
+
+    QVector<T> toVector() const
+    {
+        QVector<T> result;
+        result.reserve(m_size);
+        for (const T& value : *this) {
+            result.append(value);
+        }
+        return result;
+    }
+
+private:
+    std::shared_ptr<Chunk> m_tail;
+    int m_size = 0;
+};
@@ -1,30 +1,62 @@
 #include "RandomGenerator.h"
-#include <cstdlib>
-#include <ctime>
 #include <random>
 
-static std::mt19937 g_generator;
+namespace {
 
-int RandomGenerator::random(int min, int max)
+quint64 splitMix64(quint64& x)
 {
-    if (min > max) {
-        std::swap(min, max);
+    quint64 z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+}
+
+void RandomGenerator::seed(quint64 value)
+{
+    for (quint64& word : m_state) {
+        word = splitMix64(value);
     }
-    if (min == max) {
-        return min;
+}
+
+void RandomGenerator::jump()
+{
+    static constexpr quint64 JUMP[] = {
+        0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+        0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+    };
+
+    State result{};
+    for (quint64 word : JUMP) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (word & (1ull << bit)) {
+                for (int i = 0; i < 4; ++i) {
+                    result[i] ^= m_state[i];
+                }
+            }
+            next();
+        }
     }
-    std::uniform_int_distribution<> distribution(min, max);
-    return distribution(g_generator);
+    m_state = result;
+}
+
+RandomGenerator RandomGenerator::split()
+{
+    RandomGenerator child = *this;
+    jump();
+    return child;
 }
 
-double RandomGenerator::randomDouble()
+quint64 RandomGenerator::deriveSeed(quint64 seed, quint64 stream)
 {
-    std::uniform_real_distribution<> distribution(0.0, 1.0);
-    return distribution(g_generator);
+    quint64 x = seed ^ (stream * 0xD1B54A32D192ED03ull);
+    splitMix64(x);
+    return splitMix64(x);
 }
 
-void RandomGenerator::initializeSeed()
+quint64 RandomGenerator::entropySeed()
 {
     std::random_device rd;
-    g_generator.seed(rd());
+    return (static_cast<quint64>(rd()) << 32) ^ rd();
 }
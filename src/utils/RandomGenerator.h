@@ -1,21 +1,92 @@
 #pragma once
 
-#include <QDebug>
+#include <QtGlobal>
+#include <array>
+#include <utility>
 
 /**
- * @brief RandomGenerator - Utility for random number generation
+ * @brief Probability - Chance stored as a 32-bit integer threshold
+ *
+ * A roll succeeds when a uniform 32-bit draw is below the threshold, which is
+ * exact, branch-cheap and identical on every platform.
+ */
+struct Probability {
+    quint32 threshold = 0;
+
+    static constexpr Probability fromDouble(double p)
+    {
+        return {p <= 0.0 ? 0u
+                : p >= 1.0 ? 0xFFFFFFFFu
+                : static_cast<quint32>(p * 4294967296.0)};
+    }
+};
+
+/**
+ * @brief RandomGenerator - Seedable xoshiro256** random stream
+ *
+ * 32 bytes of state, no global instance. Every session owns its streams and
+ * seeds them explicitly, so runs are reproducible and thread-safe as long as
+ * a stream is not shared between threads. jump()/split() give independent
+ * sub-streams 2^128 draws apart.
  */
 class RandomGenerator {
 public:
-    // Delete constructor - static utility class
-    RandomGenerator() = delete;
+    using State = std::array<quint64, 4>;
+
+    explicit RandomGenerator(quint64 seed = 0) { this->seed(seed); }
+
+    // Expand a 64-bit seed into the full state with SplitMix64
+    void seed(quint64 value);
+
+    quint64 next()
+    {
+        const quint64 result = rotl(m_state[1] * 5, 7) * 9;
+        const quint64 t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    quint32 next32() { return static_cast<quint32>(next() >> 32); }
+
+    // Uniform value in [0, n) by multiply-shift; bias is below n / 2^32
+    quint32 bounded(quint32 n) { return static_cast<quint32>((static_cast<quint64>(next32()) * n) >> 32); }
 
     // Generate random integer in range [min, max]
-    static int random(int min, int max);
+    int random(int min, int max)
+    {
+        if (min > max) {
+            std::swap(min, max);
+        }
+        return min + static_cast<int>(bounded(static_cast<quint32>(max - min) + 1));
+    }
+
+    // Generate random double in range [0.0, 1.0)
+    double randomDouble() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    bool roll(Probability p) { return next32() < p.threshold; }
+
+    // Advance the stream by 2^128 draws
+    void jump();
+
+    // Return the current stream and move this generator to the next sub-stream
+    RandomGenerator split();
+
+    const State& state() const { return m_state; }
+    void setState(const State& state) { m_state = state; }
+
+    // Independent seed for stream number `stream` of a run seeded with `seed`
+    static quint64 deriveSeed(quint64 seed, quint64 stream);
+
+    // Non-deterministic seed for interactive games
+    static quint64 entropySeed();
 
-    // Generate random double in range [0.0, 1.0]
-    static double randomDouble();
+private:
+    static quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
 
-    // Initialize random seed (call once at application start)
-    static void initializeSeed();
+    State m_state{};
 };
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QtGlobal>
+#include "RandomGenerator.h"
+
+/**
+ * @brief ShuffledDeck - Seeded permutation of [0, size) drawn by a cursor
+ *
+ * The permutation is never stored: at() runs the index through an 8-round
+ * Feistel network over the smallest even-bit power of two covering size and
+ * walks the cycle until the result falls inside the deck, which takes fewer
+ * than four passes on average. Creating a deck is O(1) whatever the content
+ * size, and the same seed always deals the same order.
+ */
+class ShuffledDeck {
+public:
+    ShuffledDeck() = default;
+
+    ShuffledDeck(int size, quint64 seed)
+        : m_size(qMax(0, size))
+    {
+        while ((1 << (2 * m_halfBits)) < m_size) {
+            ++m_halfBits;
+        }
+        m_mask = (1u << m_halfBits) - 1;
+        for (int round = 0; round < Rounds; ++round) {
+            m_keys[round] = RandomGenerator::deriveSeed(seed, static_cast<quint64>(round));
+        }
+    }
+
+    int size() const { return m_size; }
+    int position() const { return m_position; }
+    int remaining() const { return m_size - m_position; }
+    bool isEmpty() const { return m_position >= m_size; }
+
+    // Card at a deck position in [0, size)
+    int at(int position) const
+    {
+        quint32 index = static_cast<quint32>(position);
+        do {
+            index = permute(index);
+        } while (index >= static_cast<quint32>(m_size));
+        return static_cast<int>(index);
+    }
+
+    // Next card; the deck must not be empty
+    int draw() { return at(m_position++); }
+
+    void setPosition(int position) { m_position = qBound(0, position, m_size); }
+
+private:
+    static constexpr int Rounds = 8;
+
+    quint32 permute(quint32 index) const
+    {
+        quint32 left = index >> m_halfBits;
+        quint32 right = index & m_mask;
+        for (int round = 0; round < Rounds; ++round) {
+            const quint32 next = left ^ mix(right, m_keys[round]);
+            left = right;
+            right = next;
+        }
+        return (left << m_halfBits) | right;
+    }
+
+    quint32 mix(quint32 half, quint64 key) const
+    {
+        quint64 z = (half ^ key) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<quint32>(z >> 32) & m_mask;
+    }
+
+    int m_size = 0;
+    int m_position = 0;
+    int m_halfBits = 1;
+    quint32 m_mask = 1;
+    quint64 m_keys[Rounds] = {};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @brief SpscQueue - Bounded lock-free ring for one producer and one consumer thread
+ *
+ * Head and tail are written by one side each and live on separate cache
+ * lines. Each side caches the other's index and reloads it only when the ring
+ * looks full or empty. Capacity must be a power of two; one slot stays free.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side. False if the ring is full; the value is left untouched
+    bool tryPush(T&& value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        const std::size_t next = (tail + 1) & Mask;
+        if (next == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (next == m_cachedHead) {
+                return false;
+            }
+        }
+        m_slots[tail] = std::move(value);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPush(const T& value)
+    {
+        T copy = value;
+        return tryPush(std::move(copy));
+    }
+
+    // Consumer side. False if the ring is empty
+    bool tryPop(T& value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                return false;
+            }
+        }
+        value = std::move(m_slots[head]);
+        m_slots[head] = T();    // Release payload references now, not on wrap-around
+        m_head.store((head + 1) & Mask, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently
+    bool isEmpty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity - 1; }
+
+private:
+    static constexpr std::size_t Mask = Capacity - 1;
+    static constexpr std::size_t CacheLine = 64;
+
+    alignas(CacheLine) std::atomic<std::size_t> m_head{0};     // Written by the consumer
+    std::size_t m_cachedTail = 0;                              // Consumer's view of m_tail
+    alignas(CacheLine) std::atomic<std::size_t> m_tail{0};     // Written by the producer
+    std::size_t m_cachedHead = 0;                              // Producer's view of m_head
+    alignas(CacheLine) std::array<T, Capacity> m_slots{};
+};
@@ -1,150 +1,364 @@
 #include "TextGenerator.h"
 #include "RandomGenerator.h"
-#include <QRandomGenerator>
-
-const QVector<QString> TextGenerator::CastleStarts = {
-    "[Замок] Вы входите в величественный зал",
-    "[Замок] Сводчатый потолок возвышается надо мной",
-    "[Замок] На стенах видны отпечатки времени",
-    "[Замок] Каменные колонны поддерживают крышу",
-    "[Замок] Вы спускаетесь по узкому коридору замка",
-    "[Замок] Древние гобелены украшают стены",
-    "[Замок] Факелы освещают путь вперед"
-};
-
-const QVector<QString> TextGenerator::CastleMiddles = {
-    ". Холодная каменная кладка",
-    ". Эхо ваших шагов разносится по залам",
-    ". Запах сырости и плесени заполняет воздух",
-    ". Где-то вдалеке слышны странные звуки",
-    ". На полу видны следы былого величия",
-    ". Пыль веков оседает на ваших плечах",
-    ". Морозный воздух пробирает до костей"
-};
-
-const QVector<QString> TextGenerator::CastleEnds = {
-    ". Впереди видна деревянная дверь.",
-    ". Путь ведет в неизвестность.",
-    ". Вы готовы к новым испытаниям.",
-    ". Ощущение опасности растет с каждым шагом.",
-    ". Выбор предстоит перед вами.",
-    ". Атмосфера становится все более зловещей.",
-    ". Вы чувствуете, что вы не одни здесь."
+#include <QVector>
+
+namespace {
+
+// Банки текстов для Древнего Замка
+const char16_t* const CastleStarts[] = {
+    u"[Замок] Вы входите в величественный зал",
+    u"[Замок] Сводчатый потолок возвышается надо мной",
+    u"[Замок] На стенах видны отпечатки времени",
+    u"[Замок] Каменные колонны поддерживают крышу",
+    u"[Замок] Вы спускаетесь по узкому коридору замка",
+    u"[Замок] Древние гобелены украшают стены",
+    u"[Замок] Факелы освещают путь вперед"
+};
+
+const char16_t* const CastleMiddles[] = {
+    u". Холодная каменная кладка",
+    u". Эхо ваших шагов разносится по залам",
+    u". Запах сырости и плесени заполняет воздух",
+    u". Где-то вдалеке слышны странные звуки",
+    u". На полу видны следы былого величия",
+    u". Пыль веков оседает на ваших плечах",
+    u". Морозный воздух пробирает до костей"
+};
+
+const char16_t* const CastleEnds[] = {
+    u". Впереди видна деревянная дверь.",
+    u". Путь ведет в неизвестность.",
+    u". Вы готовы к новым испытаниям.",
+    u". Ощущение опасности растет с каждым шагом.",
+    u". Выбор предстоит перед вами.",
+    u". Атмосфера становится все более зловещей.",
+    u". Вы чувствуете, что вы не одни здесь."
 };
 
 // Банки текстов для Мистического Подземелья
-const QVector<QString> TextGenerator::DungeonStarts = {
-    "[Подземелье] Вы спускаетесь в темноту",
-    "[Подземелье] Влага от стен капает на пол",
-    "[Подземелье] Извилистые коридоры ведут вглубь",
-    "[Подземелье] Подземелье предает вам мурашки",
-    "[Подземелье] Вы слышите шорохи вокруг",
-    "[Подземелье] Каменные коридоры тянутся вниз"
+const char16_t* const DungeonStarts[] = {
+    u"[Подземелье] Вы спускаетесь в темноту",
+    u"[Подземелье] Влага от стен капает на пол",
+    u"[Подземелье] Извилистые коридоры ведут вглубь",
+    u"[Подземелье] Подземелье предает вам мурашки",
+    u"[Подземелье] Вы слышите шорохи вокруг",
+    u"[Подземелье] Каменные коридоры тянутся вниз"
 };
 
-const QVector<QString> TextGenerator::DungeonMiddles = {
-    ". Глухой звук эхо дважды отскочил от стен",
-    ". Воздух становится все более тяжелым",
-    ". На стенах видна непонятная разметка",
-    ". Ощущение давления нарастает",
-    ". Странные иероглифы украшают своды",
-    ". Воздух насыщен влагой и холодом"
+const char16_t* const DungeonMiddles[] = {
+    u". Глухой звук эхо дважды отскочил от стен",
+    u". Воздух становится все более тяжелым",
+    u". На стенах видна непонятная разметка",
+    u". Ощущение давления нарастает",
+    u". Странные иероглифы украшают своды",
+    u". Воздух насыщен влагой и холодом"
 };
 
-const QVector<QString> TextGenerator::DungeonEnds = {
-    ". Дверь маячит в конце коридора.",
-    ". Выход из подземелья не виден.",
-    ". Вы должны выбрать правильный путь.",
-    ". Интуиция подсказывает новое решение.",
-    ". Загадка подземелья ждет ответа.",
-    ". Тайна этого места еще не раскрыта."
+const char16_t* const DungeonEnds[] = {
+    u". Дверь маячит в конце коридора.",
+    u". Выход из подземелья не виден.",
+    u". Вы должны выбрать правильный путь.",
+    u". Интуиция подсказывает новое решение.",
+    u". Загадка подземелья ждет ответа.",
+    u". Тайна этого места еще не раскрыта."
 };
 
 // Банки текстов для Заброшенного Города
-const QVector<QString> TextGenerator::CityStarts = {
-    "[Город] Руины города встают перед вами",
-    "[Город] Развалины зданий тянутся в небо",
-    "[Город] Безмолвие города давит на психику",
-    "[Город] Вы идете по разрушенным улицам",
-    "[Город] Пустота города окружает вас",
-    "[Город] Рухнувшие здания образуют лабиринт"
+const char16_t* const CityStarts[] = {
+    u"[Город] Руины города встают перед вами",
+    u"[Город] Развалины зданий тянутся в небо",
+    u"[Город] Безмолвие города давит на психику",
+    u"[Город] Вы идете по разрушенным улицам",
+    u"[Город] Пустота города окружает вас",
+    u"[Город] Рухнувшие здания образуют лабиринт"
 };
 
-const QVector<QString> TextGenerator::CityMiddles = {
-    ". Кирпичная пыль поднимается с каждым шагом",
-    ". Окна пустых зданий смотрят пустыми глазами",
-    ". Завалы обломков преграждают путь",
-    ". Природа начинает отвоевывать город",
-    ". Вьющиеся растения оплетают развалины",
-    ". Скрип металла нарушает тишину"
+const char16_t* const CityMiddles[] = {
+    u". Кирпичная пыль поднимается с каждым шагом",
+    u". Окна пустых зданий смотрят пустыми глазами",
+    u". Завалы обломков преграждают путь",
+    u". Природа начинает отвоевывать город",
+    u". Вьющиеся растения оплетают развалины",
+    u". Скрип металла нарушает тишину"
 };
 
-const QVector<QString> TextGenerator::CityEnds = {
-    ". Впереди видна более сохранившаяся постройка.",
-    ". Путь ведет глубже в руины.",
-    ". Вы чувствуете напряжение предчувствия.",
-    ". Что-то манит вас дальше.",
-    ". Прошлое этого места требует ответов.",
-    ". Загадка города зовет вас вперед."
+const char16_t* const CityEnds[] = {
+    u". Впереди видна более сохранившаяся постройка.",
+    u". Путь ведет глубже в руины.",
+    u". Вы чувствуете напряжение предчувствия.",
+    u". Что-то манит вас дальше.",
+    u". Прошлое этого места требует ответов.",
+    u". Загадка города зовет вас вперед."
 };
 
 // Банки текстов для Теневого Леса
-const QVector<QString> TextGenerator::ForestStarts = {
-    "[Лес] Вы входите в густой лес",
-    "[Лес] Ветви деревьев переплетаются над головой",
-    "[Лес] Полумрак царит в чаще леса",
-    "[Лес] Вы пробираетесь сквозь чащу",
-    "[Лес] Лес кажется живым организмом",
-    "[Лес] Деревья образуют естественный лабиринт"
+const char16_t* const ForestStarts[] = {
+    u"[Лес] Вы входите в густой лес",
+    u"[Лес] Ветви деревьев переплетаются над головой",
+    u"[Лес] Полумрак царит в чаще леса",
+    u"[Лес] Вы пробираетесь сквозь чащу",
+    u"[Лес] Лес кажется живым организмом",
+    u"[Лес] Деревья образуют естественный лабиринт"
 };
 
-const QVector<QString> TextGenerator::ForestMiddles = {
-    ". Запах хвои и гнилого дерева наполняет ноздри",
-    ". Листья шелестят под ногами",
-    ". Где-то вдалеке слышны птичьи крики",
-    ". Ощущение наблюдения не покидает вас",
-    ". Лес дышит вместе с вами",
-    ". Природа здесь кажется дикой и необузданной"
+const char16_t* const ForestMiddles[] = {
+    u". Запах хвои и гнилого дерева наполняет ноздри",
+    u". Листья шелестят под ногами",
+    u". Где-то вдалеке слышны птичьи крики",
+    u". Ощущение наблюдения не покидает вас",
+    u". Лес дышит вместе с вами",
+    u". Природа здесь кажется дикой и необузданной"
 };
 
-const QVector<QString> TextGenerator::ForestEnds = {
-    ". Лесная тропа ведет вперед.",
-    ". Свет впереди указывает на выход.",
-    ". Вы готовы к встрече с неизвестным.",
-    ". Лес медленно раскрывает свои тайны.",
-    ". Погода в лесу может измениться в любой момент.",
-    ". Следуйте инстинкту в этом дремучем лесу."
+const char16_t* const ForestEnds[] = {
+    u". Лесная тропа ведет вперед.",
+    u". Свет впереди указывает на выход.",
+    u". Вы готовы к встрече с неизвестным.",
+    u". Лес медленно раскрывает свои тайны.",
+    u". Погода в лесу может измениться в любой момент.",
+    u". Следуйте инстинкту в этом дремучем лесу."
 };
 
 // Банки текстов для Кристального Дворца
-const QVector<QString> TextGenerator::PalaceStarts = {
-    "[Дворец] Вы входите в сияющий дворец",
-    "[Дворец] Кристаллы светят из каждого уголка",
-    "[Дворец] Свет преломляется через бриллианты",
-    "[Дворец] Дворец сверкает как звезда",
-    "[Дворец] Вы находитесь в хрустальном лабиринте",
-    "[Дворец] Сияние кристаллов режет глаза"
+const char16_t* const PalaceStarts[] = {
+    u"[Дворец] Вы входите в сияющий дворец",
+    u"[Дворец] Кристаллы светят из каждого уголка",
+    u"[Дворец] Свет преломляется через бриллианты",
+    u"[Дворец] Дворец сверкает как звезда",
+    u"[Дворец] Вы находитесь в хрустальном лабиринте",
+    u"[Дворец] Сияние кристаллов режет глаза"
+};
+
+const char16_t* const PalaceMiddles[] = {
+    u". Звон кристаллов наполняет воздух",
+    u". Отражения создают оптические иллюзии",
+    u". Каждая грань дворца светит изнутри",
+    u". Музыка кристаллов звучит на пороге слышимости",
+    u". Цвета радуги танцуют на стенах",
+    u". Дворец кажется живой сущностью"
+};
+
+const char16_t* const PalaceEnds[] = {
+    u". Еще одна дверь из кристалла появляется перед вами.",
+    u". Сверкание указывает на правильный путь.",
+    u". Вы чувствуете магию этого места.",
+    u". Дворец испытывает вашу достоинство.",
+    u". Каждый шаг приносит новые откровения.",
+    u". Секреты дворца ждут открытия."
+};
+
+const char16_t* const CastleMoods[] = {u"dark", u"gloomy", u"mysterious", u"gothic"};
+const char16_t* const DungeonMoods[] = {u"mystical", u"cold", u"oppressive", u"sacred"};
+const char16_t* const CityMoods[] = {u"desolate", u"abandoned", u"decaying", u"forgotten"};
+const char16_t* const ForestMoods[] = {u"wild", u"natural", u"ancient", u"dangerous"};
+const char16_t* const PalaceMoods[] = {u"magical", u"beautiful", u"dazzling", u"ethereal"};
+const char16_t* const UnknownMoods[] = {u"unknown", u"mysterious"};
+
+const char16_t* const Events[] = {
+    u"Слышен шорох позади вас.",
+    u"Ветер дует в спину.",
+    u"Температура резко упала.",
+    u"Вы заметили движение в тени.",
+    u"Запах изменился.",
+    u"Вы слышите отдаленный звук.",
+    u"Что-то упало на пол позади вас."
+};
+
+struct BankSource {
+    const char16_t* const* phrases;
+    int count;
+};
+
+template<int N>
+constexpr BankSource bank(const char16_t* const (&phrases)[N])
+{
+    return {phrases, N};
+}
+
+struct ThemeSource {
+    const char16_t* names[2];       // As the locations table has them: v0.1 seeds Russian names, later packs English
+    BankSource starts;
+    BankSource middles;
+    BankSource ends;
+    BankSource moods;
+};
+
+// In location id order, which is how themes were chosen before they were read
+// from the DB; the last entry has no name and serves unknown themes
+const ThemeSource Themes[] = {
+    {{u"Готика", u"Gothic"}, bank(CastleStarts), bank(CastleMiddles), bank(CastleEnds), bank(CastleMoods)},
+    {{u"Мистика", u"Mystic"}, bank(DungeonStarts), bank(DungeonMiddles), bank(DungeonEnds), bank(DungeonMoods)},
+    {{u"Упадок", u"Decay"}, bank(CityStarts), bank(CityMiddles), bank(CityEnds), bank(CityMoods)},
+    {{u"Природа", u"Nature"}, bank(ForestStarts), bank(ForestMiddles), bank(ForestEnds), bank(ForestMoods)},
+    {{u"Фантазия", u"Fantasy"}, bank(PalaceStarts), bank(PalaceMiddles), bank(PalaceEnds), bank(PalaceMoods)},
+    {{nullptr, nullptr}, bank(CastleStarts), bank(CastleMiddles), bank(CastleEnds), bank(UnknownMoods)}
 };
 
-const QVector<QString> TextGenerator::PalaceMiddles = {
-    ". Звон кристаллов наполняет воздух",
-    ". Отражения создают оптические иллюзии",
-    ". Каждая грань дворца светит изнутри",
-    ". Музыка кристаллов звучит на пороге слышимости",
-    ". Цвета радуги танцуют на стенах",
-    ". Дворец кажется живой сущностью"
+constexpr int ThemeCount = sizeof(Themes) / sizeof(Themes[0]);
+constexpr int UnknownTheme = ThemeCount - 1;
+
+/**
+ * @brief PhraseArena - Every phrase bank in one UTF-16 buffer
+ *
+ * Phrase i spans m_offsets[i] to m_offsets[i + 1] of m_text; a bank is a run
+ * of consecutive phrases. Built once, read-only afterwards.
+ */
+class PhraseArena {
+public:
+    struct Bank {
+        int first = 0;
+        int count = 0;
+    };
+
+    struct Theme {
+        Bank starts;
+        Bank middles;
+        Bank ends;
+        Bank moods;
+    };
+
+    static const PhraseArena& instance()
+    {
+        static const PhraseArena arena;
+        return arena;
+    }
+
+    QStringView pick(RandomGenerator& rng, Bank bank) const
+    {
+        const int index = bank.first + rng.random(0, bank.count - 1);
+        return QStringView(m_text).sliced(m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+    }
+
+    const Theme& theme(int index) const { return m_themes[index]; }
+    Bank events() const { return m_events; }
+    qsizetype longestDescription() const { return m_longestDescription; }
+
+private:
+    PhraseArena()
+    {
+        qsizetype length = 0;
+        for (const ThemeSource& source : Themes) {
+            for (const BankSource& part : {source.starts, source.middles, source.ends, source.moods}) {
+                for (int i = 0; i < part.count; ++i) {
+                    length += QStringView(part.phrases[i]).size();
+                }
+            }
+        }
+        m_text.reserve(length);
+
+        for (int i = 0; i < ThemeCount; ++i) {
+            Theme& theme = m_themes[i];
+            theme.starts = add(Themes[i].starts);
+            theme.middles = add(Themes[i].middles);
+            theme.ends = add(Themes[i].ends);
+            theme.moods = add(Themes[i].moods);
+            m_longestDescription = qMax(m_longestDescription,
+                                        longest(theme.starts) + longest(theme.middles) + longest(theme.ends));
+        }
+        m_events = add(bank(Events));
+    }
+
+    // Banks shared by several themes are stored once
+    Bank add(BankSource source)
+    {
+        for (const Added& added : m_added) {
+            if (added.source == source.phrases) {
+                return added.bank;
+            }
+        }
+        if (m_offsets.isEmpty()) {
+            m_offsets.append(0);
+        }
+        const Bank bank{static_cast<int>(m_offsets.size() - 1), source.count};
+        for (int i = 0; i < source.count; ++i) {
+            m_text.append(QStringView(source.phrases[i]));
+            m_offsets.append(m_text.size());
+        }
+        m_added.append({source.phrases, bank});
+        return bank;
+    }
+
+    qsizetype longest(Bank bank) const
+    {
+        qsizetype length = 0;
+        for (int i = bank.first; i < bank.first + bank.count; ++i) {
+            length = qMax(length, m_offsets[i + 1] - m_offsets[i]);
+        }
+        return length;
+    }
+
+    struct Added {
+        const char16_t* const* source;
+        Bank bank;
+    };
+
+    QString m_text;
+    QVector<qsizetype> m_offsets;
+    Theme m_themes[ThemeCount];
+    Bank m_events;
+    qsizetype m_longestDescription = 0;
+    QVector<Added> m_added;
 };
 
-const QVector<QString> TextGenerator::PalaceEnds = {
-    ". Еще одна дверь из кристалла появляется перед вами.",
-    ". Сверкание указывает на правильный путь.",
-    ". Вы чувствуете магию этого места.",
-    ". Дворец испытывает вашу достоинство.",
-    ". Каждый шаг приносит новые откровения.",
-    ". Секреты дворца ждут открытия."
+// Theme by name, any case; by location id 1-5 for themes the banks don't know
+int themeIndex(QStringView locationTheme, int locationId)
+{
+    const QStringView name = locationTheme.trimmed();
+    if (!name.isEmpty()) {
+        for (int i = 0; i < UnknownTheme; ++i) {
+            for (const char16_t* known : Themes[i].names) {
+                if (name.compare(QStringView(known), Qt::CaseInsensitive) == 0) {
+                    return i;
+                }
+            }
+        }
+    }
+    return locationId >= 1 && locationId <= UnknownTheme ? locationId - 1 : UnknownTheme;
+}
+
+struct Description {
+    QStringView start;
+    QStringView middle;
+    QStringView end;
+
+    qsizetype size() const { return start.size() + middle.size() + end.size(); }
 };
 
+Description pickDescription(RandomGenerator& rng, int locationId, QStringView locationTheme)
+{
+    const PhraseArena& arena = PhraseArena::instance();
+    const PhraseArena::Theme& theme = arena.theme(themeIndex(locationTheme, locationId));
+    // Sequenced: the draws go start, middle, end
+    const QStringView start = arena.pick(rng, theme.starts);
+    const QStringView middle = arena.pick(rng, theme.middles);
+    const QStringView end = arena.pick(rng, theme.ends);
+    return {start, middle, end};
+}
+
+}
+
+qsizetype TextGenerator::maxRoomDescriptionLength()
+{
+    return PhraseArena::instance().longestDescription();
+}
+
+void TextGenerator::generateRoomDescription(
+    RandomGenerator& rng,
+    int locationId,
+    QStringView locationTheme,
+    QString& out
+)
+{
+    const Description description = pickDescription(rng, locationId, locationTheme);
+    // resize() keeps the capacity of an unshared string, so the appends copy in place
+    out.resize(0);
+    out.append(description.start);
+    out.append(description.middle);
+    out.append(description.end);
+}
+
 QString TextGenerator::generateRoomDescription(
+    RandomGenerator& rng,
     int locationId,
     int roomNumber,
     const QString& locationName,
@@ -153,101 +367,26 @@ QString TextGenerator::generateRoomDescription(
 {
     Q_UNUSED(roomNumber);
     Q_UNUSED(locationName);
-    Q_UNUSED(locationTheme);
-
-    const QVector<QString>* starts = &CastleStarts;
-    const QVector<QString>* middles = &CastleMiddles;
-    const QVector<QString>* ends = &CastleEnds;
-
-    switch(locationId) {
-        case 1:
-            starts = &CastleStarts;
-            middles = &CastleMiddles;
-            ends = &CastleEnds;
-            break;
-        case 2:
-            starts = &DungeonStarts;
-            middles = &DungeonMiddles;
-            ends = &DungeonEnds;
-            break;
-        case 3:
-            starts = &CityStarts;
-            middles = &CityMiddles;
-            ends = &CityEnds;
-            break;
-        case 4:
-            starts = &ForestStarts;
-            middles = &ForestMiddles;
-            ends = &ForestEnds;
-            break;
-        case 5:
-            starts = &PalaceStarts;
-            middles = &PalaceMiddles;
-            ends = &PalaceEnds;
-            break;
-        default:
-            starts = &CastleStarts;
-            middles = &CastleMiddles;
-            ends = &CastleEnds;
-    }
-
-    QString description = selectFromVector(*starts);
-    description += selectFromVector(*middles);
-    description += selectFromVector(*ends);
 
+    const Description parts = pickDescription(rng, locationId, locationTheme);
+    QString description;
+    description.reserve(parts.size());
+    description.append(parts.start);
+    description.append(parts.middle);
+    description.append(parts.end);
     return description;
 }
 
-QString TextGenerator::generateMood(int locationId)
+QStringView TextGenerator::generateMood(RandomGenerator& rng, int locationId, QStringView locationTheme)
 {
-    QVector<QString> moods;
-
-    switch(locationId) {
-        case 1:
-            moods = {"dark", "gloomy", "mysterious", "gothic"};
-            break;
-        case 2:
-            moods = {"mystical", "cold", "oppressive", "sacred"};
-            break;
-        case 3:
-            moods = {"desolate", "abandoned", "decaying", "forgotten"};
-            break;
-        case 4:
-            moods = {"wild", "natural", "ancient", "dangerous"};
-            break;
-        case 5:
-            moods = {"magical", "beautiful", "dazzling", "ethereal"};
-            break;
-        default:
-            moods = {"unknown", "mysterious"};
-    }
-
-    return selectFromVector(moods);
+    const PhraseArena& arena = PhraseArena::instance();
+    return arena.pick(rng, arena.theme(themeIndex(locationTheme, locationId)).moods);
 }
 
-QString TextGenerator::generateRandomEvent(int locationId)
+QStringView TextGenerator::generateRandomEvent(RandomGenerator& rng, int locationId)
 {
     Q_UNUSED(locationId);
-    
-    QVector<QString> events = {
-        "Слышен шорох позади вас.",
-        "Ветер дует в спину.",
-        "Температура резко упала.",
-        "Вы заметили движение в тени.",
-        "Запах изменился.",
-        "Вы слышите отдаленный звук.",
-        "Что-то упало на пол позади вас."
-    };
 
-    return selectFromVector(events);
+    const PhraseArena& arena = PhraseArena::instance();
+    return arena.pick(rng, arena.events());
 }
-
-QString TextGenerator::selectFromVector(const QVector<QString>& vector)
-{
-    if (vector.isEmpty()) {
-        return "";
-    }
-
-    int randomIndex = RandomGenerator::random(0, vector.size() - 1);
-    return vector[randomIndex];
-}
\ No newline at end of file
@@ -1,44 +1,43 @@
 #pragma once
 
 #include <QString>
-#include <QVector>
+#include <QStringView>
 
+class RandomGenerator;
+
+/**
+ * @brief TextGenerator - Flavour text from the phrase banks of each location theme
+ *
+ * All banks share one UTF-16 arena built on first use. A location's theme
+ * from the DB picks its bank ("Готика" or "Gothic", any case); themes the
+ * banks don't know fall back to location ids 1-5, then to the castle texts.
+ */
 class TextGenerator {
 public:
     TextGenerator() = delete;
 
+    // Longest description any bank produces, to reserve in a reused buffer
+    static qsizetype maxRoomDescriptionLength();
+
+    // Replaces out with a room description; allocates nothing while out is
+    // unshared and has maxRoomDescriptionLength() capacity
+    static void generateRoomDescription(
+        RandomGenerator& rng,
+        int locationId,
+        QStringView locationTheme,
+        QString& out
+    );
+
     static QString generateRoomDescription(
+        RandomGenerator& rng,
         int locationId,
         int roomNumber,
         const QString& locationName,
         const QString& locationTheme
     );
 
-    static QString generateMood(int locationId);
-
-    static QString generateRandomEvent(int locationId);
+    // Views into the arena, valid for the life of the program
+    static QStringView generateMood(RandomGenerator& rng, int locationId, QStringView locationTheme = {});
 
-private:
-    static const QVector<QString> CastleStarts;
-    static const QVector<QString> CastleMiddles;
-    static const QVector<QString> CastleEnds;
-
-    static const QVector<QString> DungeonStarts;
-    static const QVector<QString> DungeonMiddles;
-    static const QVector<QString> DungeonEnds;
-
-    static const QVector<QString> CityStarts;
-    static const QVector<QString> CityMiddles;
-    static const QVector<QString> CityEnds;
-
-    static const QVector<QString> ForestStarts;
-    static const QVector<QString> ForestMiddles;
-    static const QVector<QString> ForestEnds;
-
-    static const QVector<QString> PalaceStarts;
-    static const QVector<QString> PalaceMiddles;
-    static const QVector<QString> PalaceEnds;
-
-    static QString selectFromVector(const QVector<QString>& vector);
+    static QStringView generateRandomEvent(RandomGenerator& rng, int locationId);
 };
-
@@ -0,0 +1,143 @@
+#include "WorkStealingPool.h"
+#include <QtGlobal>
+
+namespace {
+
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local int currentIndex = -1;
+
+}
+
+WorkStealingPool::WorkStealingPool(int threads)
+{
+    const int count = threads > 0 ? threads : static_cast<int>(qMax(1u, std::thread::hardware_concurrency()));
+
+    m_workers.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+
+    m_threads.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        m_threads.emplace_back([this, i]() { run(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop.store(true);
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+int WorkStealingPool::currentWorker() const
+{
+    return currentPool == this ? currentIndex : -1;
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    int index = currentWorker();
+    if (index < 0) {
+        index = static_cast<int>(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+
+    // Pairs with the sleeping/pending check in run(): either the sleeper sees
+    // the new task or we see the sleeper
+    m_pending.fetch_add(1);
+    if (m_sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_wake.notify_one();
+    }
+}
+
+bool WorkStealingPool::takeLocal(int index, Task& task)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Task& task)
+{
+    const int count = static_cast<int>(m_workers.size());
+    // The first sweep skips busy queues; if any was busy, the second waits for them
+    bool contended = false;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int offset = 1; offset < count; ++offset) {
+            Worker& victim = *m_workers[(thief + offset) % count];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::defer_lock);
+            if (pass == 0 && !lock.try_lock()) {
+                contended = true;
+                continue;
+            }
+            if (pass == 1) {
+                lock.lock();
+            }
+            if (victim.tasks.empty()) {
+                continue;
+            }
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            m_stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (!contended) {
+            break;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(int index)
+{
+    currentPool = this;
+    currentIndex = index;
+
+    Task task;
+    while (true) {
+        if (takeLocal(index, task) || steal(index, task)) {
+            m_pending.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        // Pending but nowhere to be found: another worker has just taken it
+        // and not yet counted it off. Yield rather than spin on the sweep
+        if (m_pending.load() > 0) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        m_sleeping.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wake.wait(lock, [this]() { return m_pending.load() > 0 || m_stop.load(); });
+        }
+        m_sleeping.fetch_sub(1);
+
+        if (m_stop.load() && m_pending.load() <= 0) {
+            break;
+        }
+    }
+
+    currentPool = nullptr;
+    currentIndex = -1;
+}
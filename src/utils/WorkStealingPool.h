@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief WorkStealingPool - Fixed set of worker threads with per-worker queues
+ *
+ * Tasks submitted from a worker go to the back of its own queue and are
+ * taken LIFO by that worker, which keeps a session's follow-up work on a warm
+ * core. Tasks from other threads are spread round-robin. An idle worker
+ * steals from the front of the other queues before going to sleep.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    // 0 = one worker per core
+    explicit WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task);
+
+    int threadCount() const { return static_cast<int>(m_threads.size()); }
+    quint64 stolenCount() const { return m_stolen.load(std::memory_order_relaxed); }
+
+    // Index of the calling worker of this pool, -1 on other threads
+    int currentWorker() const;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void run(int index);
+    bool takeLocal(int index, Task& task);
+    bool steal(int thief, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::atomic<unsigned> m_nextWorker{0};
+    std::atomic<int> m_pending{0};
+    std::atomic<int> m_sleeping{0};
+    std::atomic<quint64> m_stolen{0};
+    std::atomic<bool> m_stop{false};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+};